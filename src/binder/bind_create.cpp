@@ -32,6 +32,7 @@
 #include "binder/expressions/bound_constant.h"
 #include "binder/expressions/bound_star.h"
 #include "binder/expressions/bound_unary_op.h"
+#include "binder/statement/analyze_statement.h"
 #include "binder/statement/create_statement.h"
 #include "binder/statement/index_statement.h"
 #include "binder/statement/select_statement.h"
@@ -129,7 +130,29 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  // The parser fills in its own default access method when `USING` is omitted; treat that as a B+ tree.
+  auto index_type = StringUtil::Lower(stmt->accessMethod == nullptr ? "" : stmt->accessMethod);
+  if (index_type.empty() || index_type == DEFAULT_INDEX_TYPE) {
+    index_type = "btree";
+  }
+  if (index_type != "btree" && index_type != "hash") {
+    throw NotImplementedException(fmt::format("index type {} is not supported", index_type));
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), std::move(index_type));
+}
+
+auto Binder::BindAnalyze(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<AnalyzeStatement> {
+  if ((stmt->options & duckdb_libpgquery::PG_VACOPT_VACUUM) != 0) {
+    throw NotImplementedException("VACUUM is not supported");
+  }
+  if (stmt->va_cols != nullptr) {
+    throw NotImplementedException("ANALYZE of a column list is not supported");
+  }
+  if (stmt->relation == nullptr) {
+    return std::make_unique<AnalyzeStatement>(nullptr);
+  }
+  return std::make_unique<AnalyzeStatement>(BindBaseTableRef(stmt->relation->relname, std::nullopt));
 }
 
 }  // namespace bustub
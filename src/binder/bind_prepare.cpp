@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/binder.h"
+#include "binder/bound_expression.h"
+#include "binder/expressions/bound_constant.h"
+#include "binder/statement/prepare_statement.h"
+#include "common/exception.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+auto Binder::BindPrepare(duckdb_libpgquery::PGPrepareStmt *stmt) -> std::unique_ptr<PrepareStatement> {
+  std::vector<TypeId> parameter_types;
+  if (stmt->argtypes != nullptr) {
+    for (auto node = stmt->argtypes->head; node != nullptr; node = node->next) {
+      auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(node->data.ptr_value);
+      auto name = std::string(
+          reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str);
+      if (name == "int4") {
+        parameter_types.push_back(TypeId::INTEGER);
+      } else if (name == "varchar") {
+        parameter_types.push_back(TypeId::VARCHAR);
+      } else {
+        throw NotImplementedException(fmt::format("unsupported parameter type: {}", name));
+      }
+    }
+  }
+
+  parameter_count_ = 0;
+  auto statement = BindStatement(stmt->query);
+  switch (statement->type_) {
+    case StatementType::SELECT_STATEMENT:
+    case StatementType::INSERT_STATEMENT:
+    case StatementType::UPDATE_STATEMENT:
+    case StatementType::DELETE_STATEMENT:
+      break;
+    default:
+      throw NotImplementedException(fmt::format("cannot prepare a {} statement", statement->type_));
+  }
+  auto parameter_count = std::max(parameter_count_, parameter_types.size());
+  return std::make_unique<PrepareStatement>(stmt->name, std::move(statement), std::move(parameter_types),
+                                            parameter_count);
+}
+
+auto Binder::BindExecute(duckdb_libpgquery::PGExecuteStmt *stmt) -> std::unique_ptr<ExecuteStatement> {
+  std::vector<Value> parameters;
+  if (stmt->params != nullptr) {
+    for (const auto &expr : BindExpressionList(stmt->params)) {
+      if (expr->type_ != ExpressionType::CONSTANT) {
+        throw NotImplementedException("only constants can be passed to EXECUTE");
+      }
+      parameters.push_back(dynamic_cast<const BoundConstant &>(*expr).val_);
+    }
+  }
+  return std::make_unique<ExecuteStatement>(stmt->name, std::move(parameters));
+}
+
+auto Binder::BindDeallocate(duckdb_libpgquery::PGDeallocateStmt *stmt) -> std::unique_ptr<DeallocateStatement> {
+  if (stmt->name == nullptr) {
+    return std::make_unique<DeallocateStatement>(std::nullopt);
+  }
+  return std::make_unique<DeallocateStatement>(stmt->name);
+}
+
+}  // namespace bustub
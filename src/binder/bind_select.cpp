@@ -14,6 +14,7 @@
 #include "binder/expressions/bound_column_ref.h"
 #include "binder/expressions/bound_constant.h"
 #include "binder/expressions/bound_func_call.h"
+#include "binder/expressions/bound_parameter.h"
 #include "binder/expressions/bound_star.h"
 #include "binder/expressions/bound_unary_op.h"
 #include "binder/statement/explain_statement.h"
@@ -467,6 +468,15 @@ auto Binder::BindConstant(duckdb_libpgquery::PGAConst *node) -> std::unique_ptr<
   throw bustub::Exception(fmt::format("unsupported pg value: {}", Binder::NodeTagToString(val.type)));
 }
 
+auto Binder::BindParameter(duckdb_libpgquery::PGParamRef *node) -> std::unique_ptr<BoundExpression> {
+  BUSTUB_ASSERT(node, "nullptr");
+  if (node->number <= 0) {
+    throw bustub::Exception(fmt::format("invalid parameter ${}", node->number));
+  }
+  parameter_count_ = std::max(parameter_count_, static_cast<size_t>(node->number));
+  return std::make_unique<BoundParameter>(node->number - 1);
+}
+
 auto Binder::BindColumnRef(duckdb_libpgquery::PGColumnRef *node) -> std::unique_ptr<BoundExpression> {
   BUSTUB_ASSERT(node, "nullptr");
   auto fields = node->fields;
@@ -790,6 +800,8 @@ auto Binder::BindExpression(duckdb_libpgquery::PGNode *node) -> std::unique_ptr<
       return BindColumnRef(reinterpret_cast<duckdb_libpgquery::PGColumnRef *>(node));
     case duckdb_libpgquery::T_PGAConst:
       return BindConstant(reinterpret_cast<duckdb_libpgquery::PGAConst *>(node));
+    case duckdb_libpgquery::T_PGParamRef:
+      return BindParameter(reinterpret_cast<duckdb_libpgquery::PGParamRef *>(node));
     case duckdb_libpgquery::T_PGResTarget:
       return BindResTarget(reinterpret_cast<duckdb_libpgquery::PGResTarget *>(node));
     case duckdb_libpgquery::T_PGAStar:
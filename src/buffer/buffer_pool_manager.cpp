@@ -14,6 +14,7 @@
 #include "common/logger.h"
 #include "common/exception.h"
 #include "common/macros.h"
+#include "common/task_scheduler.h"
 #include "storage/page/page_guard.h"
 
 namespace bustub {
@@ -92,7 +93,10 @@ namespace bustub {
                 LOG_WARN("page %d create failed:", page_id);
                 return nullptr;
             }
-            disk_manager_->ReadPage(page_id, page->GetData());
+            {
+                TaskScheduler::BlockingRegion blocking;
+                disk_manager_->ReadPage(page_id, page->GetData());
+            }
             return page;
         } else {
             auto c = page_table_[page_id];
@@ -151,7 +155,10 @@ namespace bustub {
         std::scoped_lock<std::mutex> lock(latch_);
 
         if (!page_table_.count(page_id)) return false;
-        disk_manager_->WritePage(page_id, pages_[page_table_[page_id]].GetData());
+        {
+            TaskScheduler::BlockingRegion blocking;
+            disk_manager_->WritePage(page_id, pages_[page_table_[page_id]].GetData());
+        }
         pages_[page_table_[page_id]].is_dirty_ = false;
 
         return true;
@@ -205,7 +212,7 @@ namespace bustub {
         free_list_.push_back(id);
         DeallocatePage(page_id);
 
-        return false;
+        return true;
     }
 
     auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
@@ -260,6 +267,7 @@ namespace bustub {
             auto c = replacer_->Evict(&id);
             if (c) {
                 if (pages_[id].is_dirty_) {
+                    TaskScheduler::BlockingRegion blocking;
                     disk_manager_->WritePage(pages_[id].GetPageId(), pages_[id].GetData());
                     pages_[id].is_dirty_ = false;
                 }
@@ -0,0 +1,206 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_stats.cpp
+//
+// Identification: src/catalog/table_stats.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "catalog/table_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace bustub {
+
+namespace {
+
+/** @return a well-mixed hash of a non-NULL value; equal numbers hash alike whatever their width */
+auto DistinctHashOf(const Value &val) -> hash_t {
+  switch (val.GetTypeId()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return HashUtil::MixHash(static_cast<hash_t>(int64_t{val.GetAs<int8_t>()}));
+    case TypeId::SMALLINT:
+      return HashUtil::MixHash(static_cast<hash_t>(int64_t{val.GetAs<int16_t>()}));
+    case TypeId::INTEGER:
+      return HashUtil::MixHash(static_cast<hash_t>(int64_t{val.GetAs<int32_t>()}));
+    case TypeId::BIGINT:
+      return HashUtil::MixHash(static_cast<hash_t>(val.GetAs<int64_t>()));
+    case TypeId::DECIMAL: {
+      // 0.0 and -0.0 are the same value
+      double num = val.GetAs<double>() + 0.0;
+      hash_t bits;
+      memcpy(&bits, &num, sizeof(bits));
+      return HashUtil::MixHash(bits);
+    }
+    default:
+      return HashUtil::MixHash(HashUtil::HashValue(&val));
+  }
+}
+
+}  // namespace
+
+void HyperLogLog::Add(hash_t hash) {
+  auto &reg = registers_[hash >> (64 - PRECISION)];
+  auto rest = hash << PRECISION;
+  auto rank = static_cast<uint8_t>(rest == 0 ? 64 - PRECISION + 1 : __builtin_clzll(rest) + 1);
+  reg = std::max(reg, rank);
+}
+
+auto HyperLogLog::Estimate() const -> double {
+  const auto m = static_cast<double>(NUM_REGISTERS);
+  double sum = 0;
+  size_t zeros = 0;
+  for (auto reg : registers_) {
+    sum += std::ldexp(1.0, -reg);
+    zeros += reg == 0 ? 1 : 0;
+  }
+  auto estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+  // few distinct values leave registers empty, linear counting is more accurate then
+  if (estimate <= 2.5 * m && zeros != 0) {
+    estimate = m * std::log(m / static_cast<double>(zeros));
+  }
+  return estimate;
+}
+
+auto ColumnStats::NumericOf(const Value &val) -> std::optional<double> {
+  if (val.IsNull()) {
+    return std::nullopt;
+  }
+  switch (val.GetTypeId()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return val.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return val.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return val.GetAs<int32_t>();
+    case TypeId::BIGINT:
+      return static_cast<double>(val.GetAs<int64_t>());
+    case TypeId::DECIMAL:
+      return val.GetAs<double>();
+    default:
+      return std::nullopt;
+  }
+}
+
+auto ColumnStats::EqualSelectivity(const Value &val) const -> double {
+  if (val.IsNull() || ndv_ < 1) {
+    return 0;
+  }
+  auto num = NumericOf(val);
+  if (num.has_value() && !bounds_.empty()) {
+    if (*num < bounds_.front() || *num > bounds_.back()) {
+      return 0;
+    }
+    // a value frequent enough to span whole buckets is worth that many buckets
+    auto [first, last] = std::equal_range(bounds_.begin(), bounds_.end(), *num);
+    if (last - first >= 2) {
+      return (1 - null_fraction_) * static_cast<double>(last - first - 1) / NUM_BUCKETS;
+    }
+  }
+  return (1 - null_fraction_) / ndv_;
+}
+
+auto ColumnStats::LessSelectivity(const Value &val, bool or_equal) const -> double {
+  auto num = NumericOf(val);
+  if (!num.has_value() || bounds_.empty()) {
+    return val.IsNull() || ndv_ < 1 ? 0 : (1 - null_fraction_) / 3;
+  }
+  double below;
+  if (*num <= bounds_.front()) {
+    below = 0;
+  } else if (*num > bounds_.back()) {
+    below = 1;
+  } else {
+    // bounds_[bucket] < num <= bounds_[bucket + 1], interpolate inside the bucket
+    auto bucket = std::lower_bound(bounds_.begin(), bounds_.end(), *num) - bounds_.begin() - 1;
+    auto lo = bounds_[bucket];
+    auto hi = bounds_[bucket + 1];
+    below = (static_cast<double>(bucket) + (*num - lo) / (hi - lo)) / NUM_BUCKETS;
+  }
+  auto selectivity = (1 - null_fraction_) * below + (or_equal ? EqualSelectivity(val) : 0);
+  return std::clamp(selectivity, 0.0, 1 - null_fraction_);
+}
+
+auto ColumnStats::GreaterSelectivity(const Value &val, bool or_equal) const -> double {
+  if (val.IsNull() || ndv_ < 1) {
+    return 0;
+  }
+  return std::max(0.0, 1 - null_fraction_ - LessSelectivity(val, !or_equal));
+}
+
+auto TableStats::Collect(TableHeap *table, const Schema &schema) -> TableStats {
+  const auto num_columns = schema.GetColumnCount();
+  std::vector<HyperLogLog> sketches(num_columns);
+  std::vector<size_t> nulls(num_columns, 0);
+  std::vector<double> mins(num_columns, INFINITY);
+  std::vector<double> maxs(num_columns, -INFINITY);
+  // a reservoir sample of the rows, seeded so that ANALYZE gives the same histograms for the same table
+  std::vector<std::vector<std::optional<double>>> samples(num_columns);
+  std::mt19937_64 rng(SAMPLE_SIZE);
+
+  TableStats stats;
+  for (auto iter = table->MakeIterator(); !iter.IsEnd(); ++iter) {
+    auto [meta, tuple] = iter.GetTuple();
+    if (meta.is_deleted_) {
+      continue;
+    }
+    auto slot = stats.row_count_ < SAMPLE_SIZE ? stats.row_count_
+                                               : std::uniform_int_distribution<size_t>(0, stats.row_count_)(rng);
+    stats.row_count_++;
+    for (uint32_t col = 0; col < num_columns; col++) {
+      auto val = tuple.GetValue(&schema, col);
+      if (val.IsNull()) {
+        nulls[col]++;
+      } else {
+        sketches[col].Add(DistinctHashOf(val));
+      }
+      auto num = ColumnStats::NumericOf(val);
+      if (num.has_value()) {
+        mins[col] = std::min(mins[col], *num);
+        maxs[col] = std::max(maxs[col], *num);
+      }
+      if (slot == samples[col].size()) {
+        samples[col].push_back(num);
+      } else if (slot < samples[col].size()) {
+        samples[col][slot] = num;
+      }
+    }
+  }
+
+  stats.columns_.resize(num_columns);
+  for (uint32_t col = 0; col < num_columns; col++) {
+    auto &column = stats.columns_[col];
+    auto non_null = static_cast<double>(stats.row_count_ - nulls[col]);
+    column.null_fraction_ = stats.row_count_ == 0 ? 0 : static_cast<double>(nulls[col]) / stats.row_count_;
+    column.ndv_ = non_null == 0 ? 0 : std::clamp(std::round(sketches[col].Estimate()), 1.0, non_null);
+
+    std::vector<double> sorted;
+    for (const auto &num : samples[col]) {
+      if (num.has_value()) {
+        sorted.push_back(*num);
+      }
+    }
+    if (sorted.empty()) {
+      continue;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    column.bounds_.resize(ColumnStats::NUM_BUCKETS + 1);
+    column.bounds_.front() = mins[col];
+    column.bounds_.back() = maxs[col];
+    for (size_t bucket = 1; bucket < ColumnStats::NUM_BUCKETS; bucket++) {
+      column.bounds_[bucket] = sorted[bucket * sorted.size() / ColumnStats::NUM_BUCKETS];
+    }
+  }
+  return stats;
+}
+
+}  // namespace bustub
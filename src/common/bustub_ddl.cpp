@@ -1,5 +1,5 @@
-// DDL (Data Definition Language) statement handling in BusTub, including create table, create index, and set/show
-// variable.
+// DDL (Data Definition Language) statement handling in BusTub, including create table, create index, set/show
+// variable, analyze, and prepare/deallocate.
 
 #include <optional>
 #include <shared_mutex>
@@ -9,14 +9,17 @@
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
 #include "binder/bound_statement.h"
+#include "binder/statement/analyze_statement.h"
 #include "binder/statement/create_statement.h"
 #include "binder/statement/explain_statement.h"
 #include "binder/statement/index_statement.h"
+#include "binder/statement/prepare_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
+#include "catalog/table_stats.h"
 #include "common/bustub_instance.h"
 #include "common/enums/statement_type.h"
 #include "common/exception.h"
@@ -71,10 +74,12 @@ void BustubInstance::HandleIndexStatement(Transaction *txn, const IndexStatement
     throw NotImplementedException("only support creating index with exactly one or two columns");
   }
 
+  auto index_type = stmt.index_type_ == "hash" ? IndexType::HashTableIndex : IndexType::BPlusTreeIndex;
+
   std::unique_lock<std::shared_mutex> l(catalog_lock_);
   auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
       txn, stmt.index_name_, stmt.table_->table_, stmt.table_->schema_, key_schema, col_ids, TWO_INTEGER_SIZE,
-      IntegerHashFunctionType{});
+      IntegerHashFunctionType{}, index_type, GetExecutionThreads());
   l.unlock();
 
   if (info == nullptr) {
@@ -94,10 +99,19 @@ void BustubInstance::HandleExplainStatement(Transaction *txn, const ExplainState
     output += "\n";
   }
 
+  // EXECUTE shows the plan of the prepared statement for the values passed
+  const BoundStatement *query = stmt.statement_.get();
+  std::shared_ptr<const PrepareStatement> prepared;
+  std::vector<Value> parameters;
+  if (query->type_ == StatementType::EXECUTE_STATEMENT) {
+    std::tie(prepared, parameters) = ResolveExecuteStatement(dynamic_cast<const ExecuteStatement &>(*query));
+    query = prepared->statement_.get();
+  }
+
   std::shared_lock<std::shared_mutex> l(catalog_lock_);
 
-  bustub::Planner planner(*catalog_);
-  planner.PlanQuery(*stmt.statement_);
+  bustub::Planner planner(*catalog_, std::move(parameters));
+  planner.PlanQuery(*query);
 
   bool show_schema = (stmt.options_ & ExplainOptions::SCHEMA) != 0;
 
@@ -134,6 +148,78 @@ void BustubInstance::HandleVariableShowStatement(Transaction *txn, const Variabl
 void BustubInstance::HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt,
                                                 ResultWriter &writer) {
   session_variables_[stmt.variable_] = stmt.value_;
+  // the variables can change how statements are optimized
+  plan_cache_.Clear();
+}
+
+void BustubInstance::HandleAnalyzeStatement(Transaction *txn, const AnalyzeStatement &stmt, ResultWriter &writer) {
+  std::vector<TableInfo *> tables;
+  std::shared_lock<std::shared_mutex> l(catalog_lock_);
+  if (stmt.table_ != nullptr) {
+    tables.push_back(catalog_->GetTable(stmt.table_->oid_));
+  } else {
+    for (const auto &name : catalog_->GetTableNames()) {
+      tables.push_back(catalog_->GetTable(name));
+    }
+  }
+  l.unlock();
+
+  // Tables are never dropped, so they can be scanned without the catalog latch; only publishing the statistics takes
+  // it, so that no optimizer is reading them at the same time.
+  for (auto *info : tables) {
+    if (info->table_ == nullptr) {
+      continue;
+    }
+    auto stats = std::make_shared<const TableStats>(TableStats::Collect(info->table_.get(), info->schema_));
+    std::unique_lock<std::shared_mutex> lock(catalog_lock_);
+    catalog_->SetTableStats(info, std::move(stats));
+  }
+}
+
+void BustubInstance::HandlePrepareStatement(Transaction *txn, std::unique_ptr<PrepareStatement> stmt,
+                                            ResultWriter &writer) {
+  std::scoped_lock lock(prepared_statements_latch_);
+  if (prepared_statements_.count(stmt->name_) != 0) {
+    throw bustub::Exception(fmt::format("prepared statement {} already exists", stmt->name_));
+  }
+  auto name = stmt->name_;
+  prepared_statements_.emplace(std::move(name), std::move(stmt));
+}
+
+void BustubInstance::HandleDeallocateStatement(Transaction *txn, const DeallocateStatement &stmt,
+                                               ResultWriter &writer) {
+  std::scoped_lock lock(prepared_statements_latch_);
+  if (!stmt.name_.has_value()) {
+    prepared_statements_.clear();
+  } else if (prepared_statements_.erase(*stmt.name_) == 0) {
+    throw bustub::Exception(fmt::format("prepared statement {} does not exist", *stmt.name_));
+  }
+  // the plans cached for EXECUTE of a dropped statement must not run for a new one of the same name
+  plan_cache_.Clear();
+}
+
+auto BustubInstance::ResolveExecuteStatement(const ExecuteStatement &stmt)
+    -> std::pair<std::shared_ptr<const PrepareStatement>, std::vector<Value>> {
+  std::shared_ptr<const PrepareStatement> prepared;
+  {
+    std::scoped_lock lock(prepared_statements_latch_);
+    auto iter = prepared_statements_.find(stmt.name_);
+    if (iter == prepared_statements_.end()) {
+      throw bustub::Exception(fmt::format("prepared statement {} does not exist", stmt.name_));
+    }
+    prepared = iter->second;
+  }
+  if (stmt.parameters_.size() != prepared->parameter_count_) {
+    throw bustub::Exception(fmt::format("prepared statement {} takes {} parameters, {} given", stmt.name_,
+                                        prepared->parameter_count_, stmt.parameters_.size()));
+  }
+  auto parameters = stmt.parameters_;
+  for (size_t i = 0; i < prepared->parameter_types_.size(); i++) {
+    if (parameters[i].GetTypeId() != prepared->parameter_types_[i]) {
+      parameters[i] = parameters[i].CastAs(prepared->parameter_types_[i]);
+    }
+  }
+  return {std::move(prepared), std::move(parameters)};
 }
 
 }  // namespace bustub
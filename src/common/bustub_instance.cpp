@@ -6,9 +6,11 @@
 #include "binder/binder.h"
 #include "binder/bound_expression.h"
 #include "binder/bound_statement.h"
+#include "binder/statement/analyze_statement.h"
 #include "binder/statement/create_statement.h"
 #include "binder/statement/explain_statement.h"
 #include "binder/statement/index_statement.h"
+#include "binder/statement/prepare_statement.h"
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager.h"
@@ -39,7 +41,11 @@
 namespace bustub {
 
 auto BustubInstance::MakeExecutorContext(Transaction *txn, bool is_modify) -> std::unique_ptr<ExecutorContext> {
-  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_, is_modify);
+  auto exec_ctx =
+      std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_, is_modify);
+  exec_ctx->SetNumThreads(GetExecutionThreads());
+  exec_ctx->SetMemoryLimit(GetExecutionMemoryLimit());
+  return exec_ctx;
 }
 
 BustubInstance::BustubInstance(const std::string &db_file_name) {
@@ -225,15 +231,27 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
 
   bool is_successful = true;
 
+  // A statement run before, against the same catalog, skips the parser, binder, planner and optimizer.
+  auto cache_key = PlanCache::NormalizeSql(sql);
+  if (auto cached = plan_cache_.Get(cache_key, catalog_->GetVersion()); cached != nullptr) {
+    TaskScheduler::Scope scheduler_scope(GetTaskScheduler());
+    return ExecutePlan(txn, *cached, writer, std::move(check_options));
+  }
+
   std::shared_lock<std::shared_mutex> l(catalog_lock_);
   bustub::Binder binder(*catalog_);
   binder.ParseAndSave(sql);
   l.unlock();
 
   for (auto *stmt : binder.statement_nodes_) {
+    // parallel operators and index builds submit their tasks to the instance's scheduler
+    TaskScheduler::Scope scheduler_scope(GetTaskScheduler());
     auto statement = binder.BindStatement(stmt);
 
-    bool is_delete = false;
+    // The statement to plan: the prepared one for EXECUTE, with the values of its parameters.
+    const BoundStatement *query = statement.get();
+    std::shared_ptr<const PrepareStatement> prepared;
+    std::vector<Value> parameters;
 
     switch (statement->type_) {
       case StatementType::CREATE_STATEMENT: {
@@ -261,18 +279,40 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         HandleExplainStatement(txn, explain_stmt, writer);
         continue;
       }
-      case StatementType::DELETE_STATEMENT:
-      case StatementType::UPDATE_STATEMENT:
-        is_delete = true;
+      case StatementType::ANALYZE_STATEMENT: {
+        const auto &analyze_stmt = dynamic_cast<const AnalyzeStatement &>(*statement);
+        HandleAnalyzeStatement(txn, analyze_stmt, writer);
+        continue;
+      }
+      case StatementType::PREPARE_STATEMENT: {
+        auto prepare_stmt = std::unique_ptr<PrepareStatement>(dynamic_cast<PrepareStatement *>(statement.release()));
+        HandlePrepareStatement(txn, std::move(prepare_stmt), writer);
+        continue;
+      }
+      case StatementType::DEALLOCATE_STATEMENT: {
+        const auto &deallocate_stmt = dynamic_cast<const DeallocateStatement &>(*statement);
+        HandleDeallocateStatement(txn, deallocate_stmt, writer);
+        continue;
+      }
+      case StatementType::EXECUTE_STATEMENT: {
+        const auto &execute_stmt = dynamic_cast<const ExecuteStatement &>(*statement);
+        std::tie(prepared, parameters) = ResolveExecuteStatement(execute_stmt);
+        query = prepared->statement_.get();
+        break;
+      }
       default:
         break;
     }
 
+    const bool is_delete =
+        query->type_ == StatementType::DELETE_STATEMENT || query->type_ == StatementType::UPDATE_STATEMENT;
+
     std::shared_lock<std::shared_mutex> l(catalog_lock_);
+    const auto catalog_version = catalog_->GetVersion();
 
     // Plan the query.
-    bustub::Planner planner(*catalog_);
-    planner.PlanQuery(*statement);
+    bustub::Planner planner(*catalog_, std::move(parameters));
+    planner.PlanQuery(*query);
 
     // Optimize the query.
     bustub::Optimizer optimizer(*catalog_, IsForceStarterRule());
@@ -280,36 +320,56 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
 
     l.unlock();
 
-    // Execute the query.
-    auto exec_ctx = MakeExecutorContext(txn, is_delete);
-    if (check_options != nullptr) {
-      exec_ctx->InitCheckOptions(std::move(check_options));
+    auto plan = std::make_shared<const PlanCache::Entry>(
+        PlanCache::Entry{std::move(optimized_plan), planner.plan_->output_schema_, is_delete, catalog_version});
+    // only a statement that makes up the whole text can be found by it
+    if (binder.statement_nodes_.size() == 1) {
+      plan_cache_.Put(cache_key, plan);
     }
-    std::vector<Tuple> result_set{};
-    is_successful &= execution_engine_->Execute(optimized_plan, &result_set, txn, exec_ctx.get());
 
-    // Return the result set as a vector of string.
-    auto schema = planner.plan_->OutputSchema();
+    // Execute the query.
+    is_successful &= ExecutePlan(txn, *plan, writer, check_options);
+  }
 
-    // Generate header for the result set.
-    writer.BeginTable(false);
-    writer.BeginHeader();
-    for (const auto &column : schema.GetColumns()) {
-      writer.WriteHeaderCell(column.GetName());
-    }
-    writer.EndHeader();
+  return is_successful;
+}
 
-    // Transforming result set into strings.
-    for (const auto &tuple : result_set) {
-      writer.BeginRow();
-      for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
-        writer.WriteCell(tuple.GetValue(&schema, i).ToString());
-      }
-      writer.EndRow();
-    }
-    writer.EndTable();
+auto BustubInstance::ExecutePlan(Transaction *txn, const PlanCache::Entry &plan, ResultWriter &writer,
+                                 std::shared_ptr<CheckOptions> check_options) -> bool {
+  auto exec_ctx = MakeExecutorContext(txn, plan.is_modify_);
+  if (check_options != nullptr) {
+    exec_ctx->InitCheckOptions(std::move(check_options));
   }
+  const auto &schema = *plan.output_schema_;
 
+  // Generate header for the result set.
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  for (const auto &column : schema.GetColumns()) {
+    writer.WriteHeaderCell(column.GetName());
+  }
+  writer.EndHeader();
+
+  // Stream the result set into the writer a batch at a time, rows already written stay if execution fails.
+  bool is_successful = false;
+  try {
+    is_successful = execution_engine_->ExecuteStreaming(
+        plan.plan_,
+        [&](std::vector<Tuple> *tuples) {
+          for (const auto &tuple : *tuples) {
+            writer.BeginRow();
+            for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+              writer.WriteCell(tuple.GetValue(&schema, i).ToString());
+            }
+            writer.EndRow();
+          }
+        },
+        txn, exec_ctx.get());
+  } catch (...) {
+    writer.EndTable();
+    throw;
+  }
+  writer.EndTable();
   return is_successful;
 }
 
@@ -350,6 +410,16 @@ void BustubInstance::GenerateMockTable() {
   delete txn;
 }
 
+auto BustubInstance::GetTaskScheduler() -> TaskScheduler * {
+  std::scoped_lock lock(task_scheduler_latch_);
+  auto num_workers = GetSchedulerThreads();
+  if (task_scheduler_ == nullptr || task_scheduler_->NumWorkers() != num_workers) {
+    task_scheduler_.reset();
+    task_scheduler_ = std::make_unique<TaskScheduler>(num_workers);
+  }
+  return task_scheduler_.get();
+}
+
 BustubInstance::~BustubInstance() {
   if (enable_logging) {
     log_manager_->StopFlushThread();
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// plan_cache.cpp
+//
+// Identification: src/common/plan_cache.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/plan_cache.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace bustub {
+
+auto PlanCache::Get(const std::string &key, uint64_t catalog_version) -> std::shared_ptr<const Entry> {
+  std::scoped_lock lock(latch_);
+  auto iter = entries_.find(key);
+  if (iter == entries_.end()) {
+    return nullptr;
+  }
+  if (iter->second->second->catalog_version_ != catalog_version) {
+    // made before the catalog changed, it might miss a new index or statistics
+    lru_.erase(iter->second);
+    entries_.erase(iter);
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, iter->second);
+  return iter->second->second;
+}
+
+void PlanCache::Put(const std::string &key, std::shared_ptr<const Entry> entry) {
+  std::scoped_lock lock(latch_);
+  if (auto iter = entries_.find(key); iter != entries_.end()) {
+    lru_.erase(iter->second);
+    entries_.erase(iter);
+  }
+  if (capacity_ == 0) {
+    return;
+  }
+  if (lru_.size() >= capacity_) {
+    entries_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+  lru_.emplace_front(key, std::move(entry));
+  entries_.emplace(key, lru_.begin());
+}
+
+void PlanCache::Clear() {
+  std::scoped_lock lock(latch_);
+  lru_.clear();
+  entries_.clear();
+}
+
+auto PlanCache::Size() -> size_t {
+  std::scoped_lock lock(latch_);
+  return lru_.size();
+}
+
+auto PlanCache::NormalizeSql(const std::string &sql) -> std::string {
+  std::string normalized;
+  normalized.reserve(sql.size());
+  bool pending_space = false;
+  size_t i = 0;
+  while (i < sql.size()) {
+    const char c = sql[i];
+    // comments separate tokens like whitespace does
+    if (std::isspace(static_cast<unsigned char>(c)) != 0 || sql.compare(i, 2, "--") == 0) {
+      if (c == '-') {
+        i = std::min(sql.find('\n', i), sql.size());
+      } else {
+        i++;
+      }
+      pending_space = true;
+      continue;
+    }
+    if (sql.compare(i, 2, "/*") == 0) {
+      auto end = sql.find("*/", i + 2);
+      i = end == std::string::npos ? sql.size() : end + 2;
+      pending_space = true;
+      continue;
+    }
+    if (pending_space && !normalized.empty()) {
+      normalized.push_back(' ');
+    }
+    pending_space = false;
+
+    size_t end = i + 1;
+    if (c == '\'' || c == '"') {
+      // in an E'...' string a backslash escapes the next character, in any quoted text a doubled quote stands for one
+      const bool escapes = c == '\'' && i > 0 && (sql[i - 1] == 'e' || sql[i - 1] == 'E');
+      while (end < sql.size()) {
+        if (escapes && sql[end] == '\\') {
+          end += 2;
+        } else if (sql[end] == c && end + 1 < sql.size() && sql[end + 1] == c) {
+          end += 2;
+        } else if (sql[end] == c) {
+          end++;
+          break;
+        } else {
+          end++;
+        }
+      }
+    } else if (c == '$') {
+      // a dollar-quoted string, `$tag$...$tag$`, rather than a `$n` parameter
+      size_t tag_end = i + 1;
+      while (tag_end < sql.size() && (std::isalnum(static_cast<unsigned char>(sql[tag_end])) != 0 ||
+                                      sql[tag_end] == '_')) {
+        tag_end++;
+      }
+      const bool is_parameter = tag_end > i + 1 && std::isdigit(static_cast<unsigned char>(sql[i + 1])) != 0;
+      if (!is_parameter && tag_end < sql.size() && sql[tag_end] == '$') {
+        const auto delimiter = sql.substr(i, tag_end - i + 1);
+        const auto close = sql.find(delimiter, tag_end + 1);
+        end = close == std::string::npos ? sql.size() : close + delimiter.size();
+      }
+    } else {
+      normalized.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+      i++;
+      continue;
+    }
+    end = std::min(end, sql.size());
+    normalized.append(sql, i, end - i);
+    i = end;
+  }
+  while (!normalized.empty() && (normalized.back() == ';' || normalized.back() == ' ')) {
+    normalized.pop_back();
+  }
+  return normalized;
+}
+
+}  // namespace bustub
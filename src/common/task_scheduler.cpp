@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// task_scheduler.cpp
+//
+// Identification: src/common/task_scheduler.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/task_scheduler.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace bustub {
+
+namespace {
+
+constexpr size_t NO_QUEUE = std::numeric_limits<size_t>::max();
+
+/** The scheduler of this thread, and the deque it owns if it is one of the scheduler's threads */
+thread_local TaskScheduler *current_scheduler = nullptr;
+thread_local size_t current_queue = NO_QUEUE;
+
+}  // namespace
+
+TaskScheduler::TaskScheduler(size_t num_workers) : num_workers_(std::max<size_t>(1, num_workers)) {
+  // room for a spare thread per worker
+  for (size_t i = 0; i < 2 * num_workers_; i++) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  for (size_t i = 0; i < num_workers_; i++) {
+    threads_.emplace_back([this, i] { WorkerLoop(i); });
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    std::scoped_lock lock(latch_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  // no thread is started once stop_ is set
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+auto TaskScheduler::NumThreads() -> size_t {
+  std::scoped_lock lock(latch_);
+  return threads_.size();
+}
+
+auto TaskScheduler::Current() -> TaskScheduler * { return current_scheduler; }
+
+void TaskScheduler::Submit(Task task) {
+  size_t queue = current_scheduler == this && current_queue != NO_QUEUE ? current_queue : next_queue_++ % num_workers_;
+  {
+    std::scoped_lock lock(queues_[queue]->latch_);
+    queues_[queue]->tasks_.push_back(std::move(task));
+  }
+  num_queued_++;
+  {
+    // a worker checks num_queued_ under the latch, so it cannot miss the notification
+    std::scoped_lock lock(latch_);
+  }
+  cv_.notify_one();
+}
+
+auto TaskScheduler::TryPop(size_t queue, Task *task) -> bool {
+  if (num_queued_ == 0) {
+    return false;
+  }
+  if (queue < queues_.size()) {
+    auto &own = *queues_[queue];
+    std::scoped_lock lock(own.latch_);
+    if (!own.tasks_.empty()) {
+      *task = std::move(own.tasks_.back());
+      own.tasks_.pop_back();
+      num_queued_--;
+      return true;
+    }
+  }
+  const size_t start = queue < queues_.size() ? queue + 1 : 0;
+  for (size_t i = 0; i < queues_.size(); i++) {
+    auto &victim = *queues_[(start + i) % queues_.size()];
+    std::scoped_lock lock(victim.latch_);
+    if (!victim.tasks_.empty()) {
+      *task = std::move(victim.tasks_.front());
+      victim.tasks_.pop_front();
+      num_queued_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+auto TaskScheduler::RunOne() -> bool {
+  Task task;
+  if (!TryPop(current_scheduler == this ? current_queue : NO_QUEUE, &task)) {
+    return false;
+  }
+  task();
+  return true;
+}
+
+void TaskScheduler::WorkerLoop(size_t queue) {
+  current_scheduler = this;
+  current_queue = queue;
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    cv_.wait(lock, [&] { return stop_ || (num_queued_ > 0 && num_running_ < num_workers_ + num_blocked_); });
+    if (stop_ && num_queued_ == 0) {
+      return;
+    }
+    num_running_++;
+    lock.unlock();
+    Task task;
+    if (TryPop(queue, &task)) {
+      task();
+      task = nullptr;
+    }
+    lock.lock();
+    num_running_--;
+  }
+}
+
+void TaskScheduler::BeginBlocking() {
+  {
+    std::scoped_lock lock(latch_);
+    num_blocked_++;
+    if (!stop_ && threads_.size() < num_workers_ + num_blocked_ && threads_.size() < queues_.size()) {
+      size_t queue = threads_.size();
+      threads_.emplace_back([this, queue] { WorkerLoop(queue); });
+    }
+  }
+  cv_.notify_one();
+}
+
+void TaskScheduler::EndBlocking() {
+  std::scoped_lock lock(latch_);
+  num_blocked_--;
+}
+
+TaskScheduler::Scope::Scope(TaskScheduler *scheduler) : previous_(current_scheduler) {
+  current_scheduler = scheduler;
+}
+
+TaskScheduler::Scope::~Scope() { current_scheduler = previous_; }
+
+TaskScheduler::BlockingRegion::BlockingRegion()
+    : scheduler_(current_queue != NO_QUEUE ? current_scheduler : nullptr) {
+  if (scheduler_ != nullptr) {
+    scheduler_->BeginBlocking();
+  }
+}
+
+TaskScheduler::BlockingRegion::~BlockingRegion() {
+  if (scheduler_ != nullptr) {
+    scheduler_->EndBlocking();
+  }
+}
+
+}  // namespace bustub
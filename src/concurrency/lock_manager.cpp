@@ -108,7 +108,7 @@ namespace bustub {
 			}
 		}
 		InsertOrDeleteTableLock(txn, lock_mode, oid, false);
-		LOG_INFO("txn:%d,lock mode:%d,oid:%d lock succ", txn->GetTransactionId(), lock_mode, oid);
+		LOG_INFO("txn:%d,lock mode:%d,oid:%d lock succ", txn->GetTransactionId(), static_cast<int>(lock_mode), oid);
 		return true;
 	}
 
@@ -351,7 +351,7 @@ namespace bustub {
 			}
 		}
 		InsertOrDeleteRowLock(txn, lock_mode, oid, rid, false);
-		LOG_INFO("txn:%d,lock mode:%d,oid:%d rid:%s lock succ", txn->GetTransactionId(), lock_mode, oid,
+		LOG_INFO("txn:%d,lock mode:%d,oid:%d rid:%s lock succ", txn->GetTransactionId(), static_cast<int>(lock_mode), oid,
 				 rid.ToString().c_str());
 		return true;
 	}
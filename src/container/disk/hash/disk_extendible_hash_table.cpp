@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -24,9 +25,13 @@ namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                         uint32_t header_max_depth)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+  auto header_page =
+      reinterpret_cast<ExtendibleHTableHeaderPage *>(buffer_pool_manager_->NewPage(&header_page_id_)->GetData());
+  header_page->Init(header_max_depth);
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
 }
 
 /*****************************************************************************
@@ -46,22 +51,58 @@ auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+  return Hash(key) & dir_page->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
+auto HASH_TABLE_TYPE::KeyToDirectoryPageId(KeyType key) -> page_id_t {
+  ExtendibleHTableHeaderPage *header_page = FetchHeaderPage();
+  page_id_t directory_page_id = header_page->GetDirectoryPageId(header_page->HashToDirectoryIndex(Hash(key)));
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  return directory_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::CreateDirectory(KeyType key) {
+  table_latch_.WLock();
+  ExtendibleHTableHeaderPage *header_page = FetchHeaderPage();
+  uint32_t directory_idx = header_page->HashToDirectoryIndex(Hash(key));
+  if (header_page->GetDirectoryPageId(directory_idx) != INVALID_PAGE_ID) {
+    // created by another thread while we waited for the latch
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    table_latch_.WUnlock();
+    return;
+  }
+
+  page_id_t directory_page_id = INVALID_PAGE_ID;
+  auto dir_page =
+      reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->NewPage(&directory_page_id)->GetData());
+  dir_page->SetPageId(directory_page_id);
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  buffer_pool_manager_->NewPage(&bucket_page_id);
+  dir_page->SetBucketPageId(0, bucket_page_id);
+  dir_page->SetLocalDepth(0, 0);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id, true);
+
+  header_page->SetDirectoryPageId(directory_idx, directory_page_id);
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::FetchHeaderPage() -> ExtendibleHTableHeaderPage * {
+  return reinterpret_cast<ExtendibleHTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_)->GetData());
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+  return reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(buffer_pool_manager_->FetchPage(bucket_page_id)->GetData());
 }
 
 /*****************************************************************************
@@ -69,7 +110,26 @@ auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BU
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  page_id_t directory_page_id = KeyToDirectoryPageId(key);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    table_latch_.RUnlock();
+    return false;
+  }
+  Page *directory = buffer_pool_manager_->FetchPage(directory_page_id);
+  directory->RLatch();
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(directory->GetData());
+  page_id_t bucket_page_id = KeyToPageId(key, dir_page);
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  page->RLatch();
+  auto bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  bool found = bucket->GetValue(key, comparator_, result);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  directory->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  table_latch_.RUnlock();
+  return found;
 }
 
 /*****************************************************************************
@@ -77,12 +137,99 @@ auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.RLock();
+  page_id_t directory_page_id = KeyToDirectoryPageId(key);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    table_latch_.RUnlock();
+    CreateDirectory(key);
+    table_latch_.RLock();
+    directory_page_id = KeyToDirectoryPageId(key);
+  }
+
+  // Fast path: the directory is only read, so inserts into different buckets run in parallel.
+  Page *directory = buffer_pool_manager_->FetchPage(directory_page_id);
+  directory->RLatch();
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(directory->GetData());
+  page_id_t bucket_page_id = KeyToPageId(key, dir_page);
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  page->WLatch();
+  auto bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  bool full = bucket->IsFull();
+  bool inserted = !full && bucket->Insert(key, value, comparator_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+  directory->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  table_latch_.RUnlock();
+  if (full) {
+    return SplitInsert(transaction, key, value);
+  }
+  return inserted;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  // Slow path: holding the directory page latch exclusively keeps every other thread out of its buckets,
+  // so the bucket pages themselves do not need to be latched here. Other directories are unaffected.
+  table_latch_.RLock();
+  page_id_t directory_page_id = KeyToDirectoryPageId(key);
+  Page *directory = buffer_pool_manager_->FetchPage(directory_page_id);
+  directory->WLatch();
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(directory->GetData());
+  bool dir_dirty = false;
+  bool inserted = false;
+  while (true) {
+    uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    HASH_TABLE_BUCKET_TYPE *bucket = FetchBucketPage(bucket_page_id);
+    if (!bucket->IsFull()) {
+      // another thread may have split the bucket while we waited for the latch
+      inserted = bucket->Insert(key, value, comparator_);
+      buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+      break;
+    }
+    std::vector<ValueType> existing;
+    bucket->GetValue(key, comparator_, &existing);
+    if (std::find(existing.begin(), existing.end(), value) != existing.end()) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      break;
+    }
+
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (local_depth == dir_page->GetGlobalDepth()) {
+      if (dir_page->Size() * 2 > DIRECTORY_ARRAY_SIZE) {
+        buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+        break;
+      }
+      dir_page->IncrGlobalDepth();
+    }
+
+    page_id_t image_page_id = INVALID_PAGE_ID;
+    auto image = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(buffer_pool_manager_->NewPage(&image_page_id)->GetData());
+    uint32_t high_bit = 1U << local_depth;
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      if (dir_page->GetBucketPageId(idx) == bucket_page_id) {
+        dir_page->SetLocalDepth(idx, local_depth + 1);
+        if ((idx & high_bit) != 0) {
+          dir_page->SetBucketPageId(idx, image_page_id);
+        }
+      }
+    }
+    dir_dirty = true;
+
+    for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE; slot++) {
+      if (bucket->IsReadable(slot) && (Hash(bucket->KeyAt(slot)) & high_bit) != 0) {
+        image->Insert(bucket->KeyAt(slot), bucket->ValueAt(slot), comparator_);
+        bucket->RemoveAt(slot);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  }
+  directory->WUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, dir_dirty);
+  table_latch_.RUnlock();
+  return inserted;
 }
 
 /*****************************************************************************
@@ -90,37 +237,120 @@ auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  table_latch_.RLock();
+  page_id_t directory_page_id = KeyToDirectoryPageId(key);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    table_latch_.RUnlock();
+    return false;
+  }
+  Page *directory = buffer_pool_manager_->FetchPage(directory_page_id);
+  directory->RLatch();
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(directory->GetData());
+  page_id_t bucket_page_id = KeyToPageId(key, dir_page);
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  page->WLatch();
+  auto bucket = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  bool removed = bucket->Remove(key, value, comparator_);
+  bool empty = bucket->IsEmpty();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, removed);
+  directory->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  table_latch_.RUnlock();
+  if (removed && empty) {
+    Merge(transaction, key, value);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  page_id_t directory_page_id = KeyToDirectoryPageId(key);
+  Page *directory = buffer_pool_manager_->FetchPage(directory_page_id);
+  directory->WLatch();
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(directory->GetData());
+  uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+  page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+  uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+  uint32_t image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+
+  HASH_TABLE_BUCKET_TYPE *bucket = FetchBucketPage(bucket_page_id);
+  bool empty = bucket->IsEmpty();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+
+  if (!empty || local_depth == 0 || dir_page->GetLocalDepth(image_idx) != local_depth) {
+    directory->WUnlatch();
+    buffer_pool_manager_->UnpinPage(directory_page_id, false);
+    table_latch_.RUnlock();
+    return;
+  }
+
+  page_id_t image_page_id = dir_page->GetBucketPageId(image_idx);
+  for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+    page_id_t page_id = dir_page->GetBucketPageId(idx);
+    if (page_id == bucket_page_id || page_id == image_page_id) {
+      dir_page->SetBucketPageId(idx, image_page_id);
+      dir_page->SetLocalDepth(idx, local_depth - 1);
+    }
+  }
+  while (dir_page->CanShrink()) {
+    dir_page->DecrGlobalDepth();
+  }
+  buffer_pool_manager_->DeletePage(bucket_page_id);
+
+  directory->WUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, true);
+  table_latch_.RUnlock();
+}
 
 /*****************************************************************************
- * GETGLOBALDEPTH - DO NOT TOUCH
+ * GETGLOBALDEPTH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetGlobalDepth() -> uint32_t {
   table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  uint32_t global_depth = dir_page->GetGlobalDepth();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
+  ExtendibleHTableHeaderPage *header_page = FetchHeaderPage();
+  uint32_t global_depth = 0;
+  for (uint32_t idx = 0; idx < header_page->MaxSize(); idx++) {
+    page_id_t directory_page_id = header_page->GetDirectoryPageId(idx);
+    if (directory_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    Page *directory = buffer_pool_manager_->FetchPage(directory_page_id);
+    directory->RLatch();
+    global_depth =
+        std::max(global_depth, reinterpret_cast<HashTableDirectoryPage *>(directory->GetData())->GetGlobalDepth());
+    directory->RUnlatch();
+    buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
   table_latch_.RUnlock();
   return global_depth;
 }
 
 /*****************************************************************************
- * VERIFY INTEGRITY - DO NOT TOUCH
+ * VERIFY INTEGRITY
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::VerifyIntegrity() {
   table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  dir_page->VerifyIntegrity();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
+  ExtendibleHTableHeaderPage *header_page = FetchHeaderPage();
+  for (uint32_t idx = 0; idx < header_page->MaxSize(); idx++) {
+    page_id_t directory_page_id = header_page->GetDirectoryPageId(idx);
+    if (directory_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    Page *directory = buffer_pool_manager_->FetchPage(directory_page_id);
+    directory->RLatch();
+    reinterpret_cast<HashTableDirectoryPage *>(directory->GetData())->VerifyIntegrity();
+    directory->RUnlatch();
+    buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
   table_latch_.RUnlock();
 }
 
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -23,46 +24,319 @@
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+LINEAR_PROBE_HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  size_t num_blocks = std::clamp<size_t>((num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE, 1,
+                                         HashTableHeaderPage::MaxNumBlocks());
+  auto header_page =
+      reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->NewPage(&header_page_id_)->GetData());
+  header_page->Init(header_page_id_, num_blocks * BLOCK_ARRAY_SIZE);
+  CreateNewBlockPages(header_page, num_blocks);
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetHeaderPage() -> HashTableHeaderPage * {
+  return reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_)->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE * {
+  return reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(buffer_pool_manager_->FetchPage(block_page_id)->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks) {
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id = INVALID_PAGE_ID;
+    auto block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(buffer_pool_manager_->NewPage(&block_page_id)->GetData());
+    block->Init();
+    header_page->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::DeleteBlockPages(HashTableHeaderPage *old_header_page) {
+  for (size_t i = 0; i < old_header_page->NumBlocks(); i++) {
+    buffer_pool_manager_->DeletePage(old_header_page->GetBlockPageId(i));
+  }
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                            std::vector<ValueType> *result) -> bool {
+  table_latch_.RLock();
+  bool found = GetValueLatchFree(transaction, key, result);
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*
+ * Probes for key without touching the table latch; the caller must hold it.
+ * Each block of the cluster is scanned under its page read latch.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetValueLatchFree(Transaction *transaction, const KeyType &key,
+                                                     std::vector<ValueType> *result) -> bool {
+  HashTableHeaderPage *header_page = GetHeaderPage();
+  size_t size = header_page->GetSize();
+  size_t num_blocks = header_page->NumBlocks();
+  size_t slot = hash_fn_.GetHash(key) % size;
+  size_t block_idx = slot / BLOCK_ARRAY_SIZE;
+  slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+
+  bool found = false;
+  size_t remaining = size;
+  while (remaining > 0) {
+    page_id_t block_page_id = header_page->GetBlockPageId(block_idx);
+    Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+    page->RLatch();
+    auto block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    slot_offset_t limit = std::min<size_t>(BLOCK_ARRAY_SIZE, offset + remaining);
+    slot_offset_t end = std::min(block->FindUnoccupied(offset), limit);
+    for (slot_offset_t i = block->NextReadable(offset, end); i < end; i = block->NextReadable(i + 1, end)) {
+      if (comparator_(key, block->KeyAt(i)) == 0) {
+        result->push_back(block->ValueAt(i));
+        found = true;
+      }
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+    if (end < limit) {
+      // reached a never-occupied slot, the cluster ends here
+      break;
+    }
+    remaining -= limit - offset;
+    block_idx = (block_idx + 1) % num_blocks;
+    offset = 0;
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  return found;
 }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+auto LINEAR_PROBE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key,
+                                          const ValueType &value) -> bool {
+  table_latch_.RLock();
+  HashTableHeaderPage *header_page = GetHeaderPage();
+  size_t size = header_page->GetSize();
+  size_t num_blocks = header_page->NumBlocks();
+  size_t slot = hash_fn_.GetHash(key) % size;
+  size_t block_idx = slot / BLOCK_ARRAY_SIZE;
+  slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+
+  // A tombstone is only reused when it sits in the block where the cluster ends. That block is write latched
+  // while we insert, so a concurrent insert of the same pair always observes ours (or we observe theirs).
+  bool inserted = false;
+  bool duplicate = false;
+  size_t remaining = size;
+  while (remaining > 0 && !inserted && !duplicate) {
+    page_id_t block_page_id = header_page->GetBlockPageId(block_idx);
+    Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+    page->WLatch();
+    auto block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    slot_offset_t limit = std::min<size_t>(BLOCK_ARRAY_SIZE, offset + remaining);
+    slot_offset_t end = std::min(block->FindUnoccupied(offset), limit);
+    slot_offset_t tombstone = end;
+    for (slot_offset_t i = offset; i < end; i++) {
+      if (!block->IsReadable(i)) {
+        tombstone = std::min(tombstone, i);
+      } else if (comparator_(key, block->KeyAt(i)) == 0 && value == block->ValueAt(i)) {
+        duplicate = true;
+        break;
+      }
+    }
+    if (!duplicate && end < limit) {
+      inserted = block->Insert(tombstone, key, value);
+      if (inserted && tombstone == end) {
+        num_occupied_++;
+      }
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, inserted);
+    remaining -= limit - offset;
+    block_idx = (block_idx + 1) % num_blocks;
+    offset = 0;
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (inserted) {
+    num_live_++;
+  }
+  bool need_rebuild = !duplicate && (!inserted || static_cast<double>(num_occupied_) > MAX_LOAD_FACTOR * size);
+  table_latch_.RUnlock();
+
+  if (need_rebuild) {
+    table_latch_.WLock();
+    // skip if another thread already rebuilt the table while we waited for the latch
+    bool rebuilt = GetSizeLatchFree() != size;
+    if (!rebuilt && (!inserted || static_cast<double>(num_occupied_) > MAX_LOAD_FACTOR * size)) {
+      size_t max_size = HashTableHeaderPage::MaxNumBlocks() * BLOCK_ARRAY_SIZE;
+      size_t new_size = 2 * num_live_ > size ? std::min(2 * size, max_size) : size;
+      if (new_size > size || num_occupied_ > num_live_) {
+        Rebuild(new_size);
+        rebuilt = true;
+      }
+    }
+    table_latch_.WUnlock();
+    if (!inserted && rebuilt) {
+      return Insert(transaction, key, value);
+    }
+  }
+  return inserted;
+}
+
+/*
+ * Inserts into the table being built by Resize. The new table holds no tombstones and the table latch is held
+ * exclusively, so the pair simply goes into the first free slot of its cluster.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key,
+                                                const ValueType &value) {
+  size_t size = header_page->GetSize();
+  size_t num_blocks = header_page->NumBlocks();
+  size_t slot = hash_fn_.GetHash(key) % size;
+  size_t block_idx = slot / BLOCK_ARRAY_SIZE;
+  slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+  while (true) {
+    page_id_t block_page_id = header_page->GetBlockPageId(block_idx);
+    HASH_TABLE_BLOCK_TYPE *block = GetBlockPage(block_page_id);
+    slot_offset_t free_slot = block->FindUnoccupied(offset);
+    if (free_slot < BLOCK_ARRAY_SIZE) {
+      block->Insert(free_slot, key, value);
+      num_occupied_++;
+      buffer_pool_manager_->UnpinPage(block_page_id, true);
+      return;
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+    block_idx = (block_idx + 1) % num_blocks;
+    offset = 0;
+  }
 }
 
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+auto LINEAR_PROBE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key,
+                                          const ValueType &value) -> bool {
+  table_latch_.RLock();
+  HashTableHeaderPage *header_page = GetHeaderPage();
+  size_t size = header_page->GetSize();
+  size_t num_blocks = header_page->NumBlocks();
+  size_t slot = hash_fn_.GetHash(key) % size;
+  size_t block_idx = slot / BLOCK_ARRAY_SIZE;
+  slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+
+  bool removed = false;
+  size_t remaining = size;
+  while (remaining > 0 && !removed) {
+    page_id_t block_page_id = header_page->GetBlockPageId(block_idx);
+    Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+    page->WLatch();
+    auto block = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(page->GetData());
+    slot_offset_t limit = std::min<size_t>(BLOCK_ARRAY_SIZE, offset + remaining);
+    slot_offset_t end = std::min(block->FindUnoccupied(offset), limit);
+    for (slot_offset_t i = block->NextReadable(offset, end); i < end; i = block->NextReadable(i + 1, end)) {
+      if (comparator_(key, block->KeyAt(i)) == 0 && value == block->ValueAt(i)) {
+        block->Remove(i);
+        removed = true;
+        break;
+      }
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, removed);
+    if (end < limit) {
+      break;
+    }
+    remaining -= limit - offset;
+    block_idx = (block_idx + 1) % num_blocks;
+    offset = 0;
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (removed) {
+    num_live_--;
+  }
+  table_latch_.RUnlock();
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void LINEAR_PROBE_HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  // another thread may already have grown the table
+  if (GetSizeLatchFree() < 2 * initial_size) {
+    Rebuild(2 * initial_size);
+  }
+  table_latch_.WUnlock();
+}
+
+/*
+ * Moves the live entries into freshly allocated blocks holding at least new_size slots (capped by what the header
+ * page can address) and frees the old blocks. The caller must hold the table latch exclusively.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void LINEAR_PROBE_HASH_TABLE_TYPE::Rebuild(size_t new_size) {
+  HashTableHeaderPage *old_header_page = GetHeaderPage();
+  size_t num_blocks = std::clamp<size_t>((new_size + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE, 1,
+                                         HashTableHeaderPage::MaxNumBlocks());
+
+  page_id_t new_header_page_id = INVALID_PAGE_ID;
+  auto new_header_page =
+      reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->NewPage(&new_header_page_id)->GetData());
+  new_header_page->Init(new_header_page_id, num_blocks * BLOCK_ARRAY_SIZE);
+  CreateNewBlockPages(new_header_page, num_blocks);
+
+  // rehash live entries only, tombstones are left behind with the old blocks
+  num_occupied_ = 0;
+  for (size_t i = 0; i < old_header_page->NumBlocks(); i++) {
+    page_id_t block_page_id = old_header_page->GetBlockPageId(i);
+    HASH_TABLE_BLOCK_TYPE *block = GetBlockPage(block_page_id);
+    for (slot_offset_t slot = block->NextReadable(0, BLOCK_ARRAY_SIZE); slot < BLOCK_ARRAY_SIZE;
+         slot = block->NextReadable(slot + 1, BLOCK_ARRAY_SIZE)) {
+      ResizeInsert(new_header_page, block->KeyAt(slot), block->ValueAt(slot));
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, false);
+  }
+  num_live_ = num_occupied_.load();
+
+  DeleteBlockPages(old_header_page);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  buffer_pool_manager_->DeletePage(header_page_id_);
+  header_page_id_ = new_header_page_id;
+  buffer_pool_manager_->UnpinPage(new_header_page_id, true);
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::GetSize() -> size_t {
-  return 0;
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetSize() -> size_t {
+  table_latch_.RLock();
+  size_t size = GetSizeLatchFree();
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto LINEAR_PROBE_HASH_TABLE_TYPE::GetSizeLatchFree() -> size_t {
+  size_t size = GetHeaderPage()->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  return size;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
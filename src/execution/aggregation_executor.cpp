@@ -1,53 +1,74 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-    AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                             std::unique_ptr<AbstractExecutor> &&child_executor)
-        : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)),
-          aht_(plan->aggregates_, plan->GetAggregateTypes()),
-          aht_iterator_(aht_.Begin()) {
-    }
-
-    void AggregationExecutor::Init() {
-        child_executor_->Init();
-        Tuple t;
-        RID r;
-
-        while (child_executor_->Next(&t, &r)) {
-            aht_.InsertCombine(MakeAggregateKey(&t), MakeAggregateValue(&t));
-        }
-        if (aht_.Size() == 0 && GetOutputSchema().GetColumnCount() == 1) aht_.Initial();
-
-        aht_iterator_ = aht_.Begin();
-    }
-
-    auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-        if (aht_iterator_ == aht_.End()) {
-            return false;
-        }
-        std::vector<Value> values;
-        values.insert(values.end(), aht_iterator_.Key().group_bys_.begin(), aht_iterator_.Key().group_bys_.end());
-        values.insert(values.end(), aht_iterator_.Val().aggregates_.begin(), aht_iterator_.Val().aggregates_.end());
-        *tuple = Tuple{values, &GetOutputSchema()};
-        ++aht_iterator_;
-        return true;
-    }
-
-    auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_executor_.get(); }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+
+namespace bustub {
+
+    AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                             std::unique_ptr<AbstractExecutor> &&child_executor)
+        : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
+    }
+
+    void AggregationExecutor::Init() {
+        ResetBatch();
+        child_executor_->Init();
+        aht_ = std::make_unique<AggregationHashTable>(plan_, &child_executor_->GetOutputSchema(),
+                                                      exec_ctx_->GetNumThreads(), exec_ctx_->GetBufferPoolManager(),
+                                                      exec_ctx_->GetMemoryLimit());
+        std::vector<Tuple> chunk;
+        std::vector<Tuple> batch;
+        std::vector<RID> rids;
+        while (child_executor_->NextBatch(&batch, &rids, BUSTUB_BATCH_SIZE)) {
+            std::move(batch.begin(), batch.end(), std::back_inserter(chunk));
+            if (chunk.size() >= AGGREGATION_INPUT_CHUNK) {
+                aht_->Add(chunk);
+                chunk.clear();
+            }
+        }
+        aht_->Add(chunk);
+        aht_->Finish();
+        empty_row_pending_ = aht_->IsEmpty() && plan_->GetGroupBys().empty();
+    }
+
+    auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+        return NextFromBatch(tuple, rid);
+    }
+
+    auto AggregationExecutor::NextBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size)
+    -> bool {
+        tuples->clear();
+        rids->clear();
+        std::vector<Value> values;
+        if (empty_row_pending_) {
+            aht_->GetEmptyAggregates(&values);
+            tuples->emplace_back(values, &GetOutputSchema());
+            rids->emplace_back();
+            empty_row_pending_ = false;
+        }
+        while (tuples->size() < batch_size) {
+            values.clear();
+            if (!aht_->NextGroup(&values)) {
+                break;
+            }
+            tuples->emplace_back(values, &GetOutputSchema());
+            rids->emplace_back();
+        }
+        return !tuples->empty();
+    }
+
+    auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_executor_.get(); }
+
+}  // namespace bustub
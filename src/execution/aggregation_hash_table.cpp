@@ -0,0 +1,524 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table.cpp
+//
+// Identification: src/execution/aggregation_hash_table.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/aggregation_hash_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "common/util/parallel_util.h"
+#include "execution/sort_key.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** Groups a local table holds before it is flushed into the partitions, so that it stays cache sized */
+constexpr size_t LOCAL_GROUPS = 16384;
+constexpr size_t RADIX_BITS = 5;
+/** Fewest input rows worth a task of their own */
+constexpr size_t MIN_TASK_ROWS = 4096;
+/** A spilled partition is split at most this often, when the hash bits run out */
+constexpr size_t MAX_SPILL_LEVEL = 64 / RADIX_BITS - 1;
+
+auto IsIntegralType(TypeId type) -> bool {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+}
+
+auto IntegralValue(const Value &val) -> int64_t {
+  switch (val.GetTypeId()) {
+    case TypeId::TINYINT:
+      return val.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return val.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return val.GetAs<int32_t>();
+    case TypeId::BIGINT:
+      return val.GetAs<int64_t>();
+    default:
+      UNREACHABLE("not an integral value");
+  }
+}
+
+/** Combines a non-NULL input into an aggregate kept as a Value */
+void CombineValue(AggregationType type, const Value &input, Value *result) {
+  if (result->IsNull()) {
+    *result = input;
+    return;
+  }
+  switch (type) {
+    case AggregationType::SumAggregate:
+      *result = result->Add(input);
+      break;
+    case AggregationType::MinAggregate:
+      *result = result->Min(input);
+      break;
+    case AggregationType::MaxAggregate:
+      *result = result->Max(input);
+      break;
+    default:
+      UNREACHABLE("counts are always typed");
+  }
+}
+
+}  // namespace
+
+void AggregationHashTable::Groups::Clear() {
+  hashes_.clear();
+  keys_.clear();
+  key_ends_.clear();
+  states_.clear();
+  values_.clear();
+}
+
+AggregationHashTable::AggregationHashTable(const AggregationPlanNode *plan, const Schema *input_schema,
+                                           size_t num_threads, BufferPoolManager *bpm, size_t memory_limit)
+    : plan_(plan),
+      input_schema_(input_schema),
+      num_threads_(std::max<size_t>(1, num_threads)),
+      bpm_(bpm),
+      memory_limit_(memory_limit),
+      num_aggregates_(plan->GetAggregates().size()),
+      locals_(num_threads_),
+      partitions_(num_threads_, std::vector<Groups>(static_cast<size_t>(1) << RADIX_BITS)),
+      partition_bytes_(num_threads_, 0) {
+  for (size_t i = 0; i < num_aggregates_; i++) {
+    auto agg_type = plan_->GetAggregateTypes()[i];
+    auto input_type = plan_->GetAggregates()[i]->GetReturnType();
+    bool is_count = agg_type == AggregationType::CountStarAggregate || agg_type == AggregationType::CountAggregate;
+    typed_.push_back(is_count || IsIntegralType(input_type));
+    has_values_ = has_values_ || !typed_.back();
+    switch (is_count ? TypeId::BIGINT : input_type) {
+      case TypeId::TINYINT:
+        min_.push_back(BUSTUB_INT8_MIN);
+        max_.push_back(BUSTUB_INT8_MAX);
+        break;
+      case TypeId::SMALLINT:
+        min_.push_back(BUSTUB_INT16_MIN);
+        max_.push_back(BUSTUB_INT16_MAX);
+        break;
+      case TypeId::INTEGER:
+        min_.push_back(BUSTUB_INT32_MIN);
+        max_.push_back(BUSTUB_INT32_MAX);
+        break;
+      default:
+        min_.push_back(BUSTUB_INT64_MIN);
+        max_.push_back(BUSTUB_INT64_MAX);
+        break;
+    }
+  }
+}
+
+auto AggregationHashTable::PartitionOf(hash_t hash, size_t level) const -> size_t {
+  return (hash >> (64 - RADIX_BITS * (level + 1))) & ((static_cast<size_t>(1) << RADIX_BITS) - 1);
+}
+
+auto AggregationHashTable::BytesOf(const Groups &groups) const -> size_t {
+  size_t per_group = sizeof(hash_t) + sizeof(size_t) + num_aggregates_ * sizeof(State);
+  if (has_values_) {
+    per_group += num_aggregates_ * sizeof(Value);
+  }
+  return groups.keys_.size() + groups.Size() * per_group;
+}
+
+auto AggregationHashTable::FindOrInsert(Table *table, hash_t hash, std::string_view key) const -> size_t {
+  auto &groups = table->groups_;
+  auto &slots = table->slots_;
+  if (2 * (groups.Size() + 1) > slots.size()) {
+    slots.assign(std::max<size_t>(16, 2 * slots.size()), 0);
+    for (size_t group = 0; group < groups.Size(); group++) {
+      size_t slot = groups.hashes_[group] & (slots.size() - 1);
+      while (slots[slot] != 0) {
+        slot = (slot + 1) & (slots.size() - 1);
+      }
+      slots[slot] = static_cast<uint32_t>(group + 1);
+    }
+  }
+  const size_t mask = slots.size() - 1;
+  for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+    if (slots[slot] == 0) {
+      size_t group = groups.Size();
+      slots[slot] = static_cast<uint32_t>(group + 1);
+      groups.hashes_.push_back(hash);
+      groups.keys_.append(key);
+      groups.key_ends_.push_back(groups.keys_.size());
+      for (size_t i = 0; i < num_aggregates_; i++) {
+        auto agg_type = plan_->GetAggregateTypes()[i];
+        bool is_count = agg_type == AggregationType::CountStarAggregate || agg_type == AggregationType::CountAggregate;
+        // a group has at least one row, so its counts start at zero and are never NULL
+        groups.states_.push_back({0, !is_count});
+        if (has_values_) {
+          groups.values_.push_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+        }
+      }
+      return group;
+    }
+    size_t group = slots[slot] - 1;
+    if (groups.hashes_[group] == hash && groups.Key(group) == key) {
+      return group;
+    }
+  }
+}
+
+auto AggregationHashTable::CheckedAdd(size_t agg, int64_t a, int64_t b) const -> int64_t {
+  int64_t sum;
+  if (__builtin_add_overflow(a, b, &sum) || sum < min_[agg] || sum > max_[agg]) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "Numeric value out of range.");
+  }
+  return sum;
+}
+
+void AggregationHashTable::Update(Groups *groups, size_t group, const std::vector<Value> &inputs) const {
+  for (size_t i = 0; i < num_aggregates_; i++) {
+    auto &state = groups->states_[group * num_aggregates_ + i];
+    const auto &input = inputs[i];
+    auto agg_type = plan_->GetAggregateTypes()[i];
+    if (agg_type == AggregationType::CountStarAggregate) {
+      state.value_++;
+      continue;
+    }
+    if (input.IsNull()) {
+      continue;
+    }
+    if (agg_type == AggregationType::CountAggregate) {
+      state.value_++;
+      continue;
+    }
+    if (!typed_[i]) {
+      CombineValue(agg_type, input, &groups->values_[group * num_aggregates_ + i]);
+      continue;
+    }
+    int64_t val = IntegralValue(input);
+    if (state.null_) {
+      state = {val, false};
+    } else if (agg_type == AggregationType::SumAggregate) {
+      state.value_ = CheckedAdd(i, state.value_, val);
+    } else if (agg_type == AggregationType::MinAggregate) {
+      state.value_ = std::min(state.value_, val);
+    } else {
+      state.value_ = std::max(state.value_, val);
+    }
+  }
+}
+
+void AggregationHashTable::Merge(Groups *dst, size_t to, const Groups &src, size_t from) const {
+  for (size_t i = 0; i < num_aggregates_; i++) {
+    auto agg_type = plan_->GetAggregateTypes()[i];
+    if (!typed_[i]) {
+      const auto &input = src.values_[from * num_aggregates_ + i];
+      if (!input.IsNull()) {
+        CombineValue(agg_type, input, &dst->values_[to * num_aggregates_ + i]);
+      }
+      continue;
+    }
+    auto &state = dst->states_[to * num_aggregates_ + i];
+    const auto &input = src.states_[from * num_aggregates_ + i];
+    if (input.null_) {
+      continue;
+    }
+    if (state.null_) {
+      state = input;
+    } else if (agg_type == AggregationType::MinAggregate) {
+      state.value_ = std::min(state.value_, input.value_);
+    } else if (agg_type == AggregationType::MaxAggregate) {
+      state.value_ = std::max(state.value_, input.value_);
+    } else {
+      state.value_ = CheckedAdd(i, state.value_, input.value_);
+    }
+  }
+}
+
+void AggregationHashTable::Append(Groups *dst, const Groups &src, size_t group) const {
+  dst->hashes_.push_back(src.hashes_[group]);
+  dst->keys_.append(src.Key(group));
+  dst->key_ends_.push_back(dst->keys_.size());
+  auto first = group * num_aggregates_;
+  dst->states_.insert(dst->states_.end(), src.states_.begin() + first, src.states_.begin() + first + num_aggregates_);
+  if (has_values_) {
+    dst->values_.insert(dst->values_.end(), src.values_.begin() + first, src.values_.begin() + first + num_aggregates_);
+  }
+}
+
+void AggregationHashTable::Flush(size_t task) {
+  auto &local = locals_[task];
+  partition_bytes_[task] += BytesOf(local.groups_);
+  for (size_t group = 0; group < local.groups_.Size(); group++) {
+    Append(&partitions_[task][PartitionOf(local.groups_.hashes_[group])], local.groups_, group);
+  }
+  local.groups_.Clear();
+  std::fill(local.slots_.begin(), local.slots_.end(), 0);
+  flushed_ = true;
+}
+
+void AggregationHashTable::WriteGroup(const Groups &groups, size_t group, TmpTupleHeap *heap) const {
+  // [hash][key length][key][states][values as a type byte and a normalized key]
+  auto key = groups.Key(group);
+  auto key_size = static_cast<uint32_t>(key.size());
+  std::string record(sizeof(hash_t) + sizeof(uint32_t), '\0');
+  memcpy(record.data(), &groups.hashes_[group], sizeof(hash_t));
+  memcpy(record.data() + sizeof(hash_t), &key_size, sizeof(uint32_t));
+  record.append(key);
+  for (size_t i = 0; i < num_aggregates_; i++) {
+    const auto &state = groups.states_[group * num_aggregates_ + i];
+    record.append(reinterpret_cast<const char *>(&state.value_), sizeof(int64_t));
+    record.push_back(static_cast<char>(state.null_));
+  }
+  for (size_t i = 0; has_values_ && i < num_aggregates_; i++) {
+    if (!typed_[i]) {
+      const auto &val = groups.values_[group * num_aggregates_ + i];
+      record.push_back(static_cast<char>(val.GetTypeId()));
+      SortKeyEncoder::EncodeValue(val, false, &record);
+    }
+  }
+  heap->Append(Tuple(RID(), record.data(), static_cast<uint32_t>(record.size())));
+}
+
+void AggregationHashTable::ReadGroup(const Tuple &tuple, Groups *groups) const {
+  const char *pos = tuple.GetData();
+  hash_t hash;
+  uint32_t key_size;
+  memcpy(&hash, pos, sizeof(hash_t));
+  memcpy(&key_size, pos + sizeof(hash_t), sizeof(uint32_t));
+  pos += sizeof(hash_t) + sizeof(uint32_t);
+  groups->hashes_.push_back(hash);
+  groups->keys_.append(pos, key_size);
+  groups->key_ends_.push_back(groups->keys_.size());
+  pos += key_size;
+  for (size_t i = 0; i < num_aggregates_; i++) {
+    State state;
+    memcpy(&state.value_, pos, sizeof(int64_t));
+    state.null_ = pos[sizeof(int64_t)] != 0;
+    groups->states_.push_back(state);
+    pos += sizeof(int64_t) + 1;
+  }
+  for (size_t i = 0; has_values_ && i < num_aggregates_; i++) {
+    if (typed_[i]) {
+      groups->values_.push_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
+      continue;
+    }
+    auto type = static_cast<TypeId>(*pos++);
+    groups->values_.push_back(SortKeyEncoder::DecodeValue(type, &pos));
+  }
+}
+
+void AggregationHashTable::Spill() {
+  if (spilled_.empty()) {
+    for (size_t p = 0; p < partitions_[0].size(); p++) {
+      spilled_.push_back(std::make_unique<TmpTupleHeap>(bpm_));
+    }
+    num_spilled_ += spilled_.size();
+  }
+  ParallelUtil::ParallelFor(num_threads_, spilled_.size(), [&](size_t p) {
+    for (auto &task_partitions : partitions_) {
+      auto &part = task_partitions[p];
+      for (size_t group = 0; group < part.Size(); group++) {
+        WriteGroup(part, group, spilled_[p].get());
+      }
+      part = Groups{};
+    }
+  });
+  std::fill(partition_bytes_.begin(), partition_bytes_.end(), 0);
+}
+
+void AggregationHashTable::Add(const std::vector<Tuple> &rows) {
+  num_rows_ += rows.size();
+  const size_t num_tasks = std::min(num_threads_, std::max<size_t>(1, rows.size() / MIN_TASK_ROWS));
+  ParallelUtil::ParallelFor(num_threads_, num_tasks, [&](size_t task) {
+    auto &local = locals_[task];
+    const size_t end = rows.size() * (task + 1) / num_tasks;
+    std::string key;
+    std::vector<Value> inputs(num_aggregates_);
+    for (size_t row = rows.size() * task / num_tasks; row < end; row++) {
+      key.clear();
+      for (const auto &expr : plan_->GetGroupBys()) {
+        SortKeyEncoder::EncodeValue(expr->Evaluate(&rows[row], *input_schema_), false, &key);
+      }
+      hash_t hash = HashUtil::MixHash(HashUtil::HashBytes(key.data(), key.size()));
+      size_t group = FindOrInsert(&local, hash, key);
+      for (size_t i = 0; i < num_aggregates_; i++) {
+        inputs[i] = plan_->GetAggregates()[i]->Evaluate(&rows[row], *input_schema_);
+      }
+      Update(&local.groups_, group, inputs);
+      if (local.groups_.Size() >= LOCAL_GROUPS) {
+        Flush(task);
+      }
+    }
+  });
+  size_t bytes = 0;
+  for (auto task_bytes : partition_bytes_) {
+    bytes += task_bytes;
+  }
+  if (bpm_ != nullptr && bytes > memory_limit_) {
+    Spill();
+  }
+}
+
+void AggregationHashTable::Finish() {
+  finals_.clear();
+  pending_.clear();
+  table_cursor_ = 0;
+  group_cursor_ = 0;
+  current_valid_ = false;
+  auto num_locals =
+      std::count_if(locals_.begin(), locals_.end(), [](const Table &local) { return local.groups_.Size() > 0; });
+  if (!spilled_.empty()) {
+    // the groups flushed so far are on disk, so the rest goes there too and every partition is finished alone
+    for (size_t task = 0; task < locals_.size(); task++) {
+      Flush(task);
+    }
+    Spill();
+    for (auto &heap : spilled_) {
+      if (heap->Size() > 0) {
+        pending_.push_back({std::move(heap), 0});
+      }
+    }
+    spilled_.clear();
+  } else if (!flushed_ && num_locals <= 1) {
+    // a single task saw every group, its table already holds the final groups
+    for (auto &local : locals_) {
+      if (local.groups_.Size() > 0) {
+        finals_.push_back(std::move(local));
+      }
+    }
+  } else {
+    for (size_t task = 0; task < locals_.size(); task++) {
+      Flush(task);
+    }
+    finals_.resize(static_cast<size_t>(1) << RADIX_BITS);
+    ParallelUtil::ParallelFor(num_threads_, finals_.size(), [&](size_t p) {
+      auto &table = finals_[p];
+      for (auto &task_partitions : partitions_) {
+        auto &part = task_partitions[p];
+        for (size_t group = 0; group < part.Size(); group++) {
+          Merge(&table.groups_, FindOrInsert(&table, part.hashes_[group], part.Key(group)), part, group);
+        }
+        part = Groups{};
+      }
+    });
+  }
+  locals_.assign(num_threads_, Table{});
+  std::fill(partition_bytes_.begin(), partition_bytes_.end(), 0);
+  flushed_ = false;
+}
+
+auto AggregationHashTable::LoadPartition(SpilledPartition *partition) -> bool {
+  auto &heap = *partition->heap_;
+  const size_t num_pages = heap.NumPages();
+  current_ = Table{};
+  Groups batch;
+  std::vector<Tuple> records;
+  bool fits = true;
+  for (size_t page = 0; page < num_pages && fits; page++) {
+    records.clear();
+    heap.ReadPage(page, &records);
+    batch.Clear();
+    for (const auto &record : records) {
+      ReadGroup(record, &batch);
+    }
+    for (size_t group = 0; group < batch.Size(); group++) {
+      Merge(&current_.groups_, FindOrInsert(&current_, batch.hashes_[group], batch.Key(group)), batch, group);
+    }
+    fits = BytesOf(current_.groups_) <= memory_limit_ || partition->level_ >= MAX_SPILL_LEVEL;
+  }
+  if (fits) {
+    return true;
+  }
+
+  // too many groups, split the partition on the next bits of the hash
+  current_ = Table{};
+  const size_t level = partition->level_ + 1;
+  std::vector<std::unique_ptr<TmpTupleHeap>> parts;
+  for (size_t p = 0; p < partitions_[0].size(); p++) {
+    parts.push_back(std::make_unique<TmpTupleHeap>(bpm_));
+  }
+  for (size_t page = 0; page < num_pages; page++) {
+    records.clear();
+    heap.ReadPage(page, &records);
+    for (const auto &record : records) {
+      hash_t hash;
+      memcpy(&hash, record.GetData(), sizeof(hash_t));
+      parts[PartitionOf(hash, level)]->Append(record);
+    }
+  }
+  partition->heap_.reset();
+  for (auto &part : parts) {
+    if (part->Size() > 0) {
+      pending_.push_front({std::move(part), level});
+      num_spilled_++;
+    }
+  }
+  return false;
+}
+
+auto AggregationHashTable::StateToValue(size_t agg, const State &state) const -> Value {
+  auto type = plan_->OutputSchema().GetColumn(plan_->GetGroupBys().size() + agg).GetType();
+  if (state.null_) {
+    return ValueFactory::GetNullValueByType(type);
+  }
+  return ValueFactory::GetBigIntValue(state.value_).CastAs(type);
+}
+
+void AggregationHashTable::GetGroup(const Groups &groups, size_t group, std::vector<Value> *values) const {
+  auto key = groups.Key(group);
+  const char *pos = key.data();
+  for (const auto &expr : plan_->GetGroupBys()) {
+    values->push_back(SortKeyEncoder::DecodeValue(expr->GetReturnType(), &pos));
+  }
+  for (size_t i = 0; i < num_aggregates_; i++) {
+    if (typed_[i]) {
+      values->push_back(StateToValue(i, groups.states_[group * num_aggregates_ + i]));
+    } else {
+      values->push_back(groups.values_[group * num_aggregates_ + i]);
+    }
+  }
+}
+
+auto AggregationHashTable::NextGroup(std::vector<Value> *values) -> bool {
+  while (table_cursor_ < finals_.size()) {
+    const auto &groups = finals_[table_cursor_].groups_;
+    if (group_cursor_ < groups.Size()) {
+      GetGroup(groups, group_cursor_++, values);
+      return true;
+    }
+    finals_[table_cursor_++] = Table{};
+    group_cursor_ = 0;
+  }
+  while (!current_valid_ || group_cursor_ >= current_.groups_.Size()) {
+    current_valid_ = false;
+    current_ = Table{};
+    if (pending_.empty()) {
+      return false;
+    }
+    auto partition = std::move(pending_.front());
+    pending_.pop_front();
+    current_valid_ = LoadPartition(&partition);
+    group_cursor_ = 0;
+  }
+  GetGroup(current_.groups_, group_cursor_++, values);
+  return true;
+}
+
+void AggregationHashTable::GetEmptyAggregates(std::vector<Value> *values) const {
+  for (auto agg_type : plan_->GetAggregateTypes()) {
+    // COUNT(*) of nothing is zero, every other aggregate is NULL
+    values->push_back(agg_type == AggregationType::CountStarAggregate
+                          ? ValueFactory::GetIntegerValue(0)
+                          : ValueFactory::GetNullValueByType(TypeId::INTEGER));
+  }
+}
+
+}  // namespace bustub
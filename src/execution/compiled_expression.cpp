@@ -0,0 +1,357 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression.cpp
+//
+// Identification: src/execution/compiled_expression.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/expressions/compiled_expression.h"
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+namespace {
+
+using Function = CompiledPredicate::Function;
+
+struct CompileContext {
+  /** Schema of the left (or only) tuple and of the right tuple */
+  const Schema *schemas_[2];
+  bool is_join_;
+  size_t num_specialized_{0};
+};
+
+template <typename T>
+constexpr auto NullOf() -> T {
+  if constexpr (std::is_same_v<T, int8_t>) {
+    return BUSTUB_INT8_NULL;
+  } else if constexpr (std::is_same_v<T, int16_t>) {
+    return BUSTUB_INT16_NULL;
+  } else if constexpr (std::is_same_v<T, int32_t>) {
+    return BUSTUB_INT32_NULL;
+  } else if constexpr (std::is_same_v<T, int64_t>) {
+    return BUSTUB_INT64_NULL;
+  } else {
+    return BUSTUB_DECIMAL_NULL;
+  }
+}
+
+template <typename T>
+inline auto ReadColumn(const TupleView *tuple, uint32_t offset) -> T {
+  T val;
+  memcpy(&val, tuple->GetData() + offset, sizeof(T));
+  return val;
+}
+
+template <ComparisonType OP, typename T>
+inline auto CompareOp(T a, T b) -> CmpBool {
+  bool res;
+  if constexpr (OP == ComparisonType::Equal) {
+    res = a == b;
+  } else if constexpr (OP == ComparisonType::NotEqual) {
+    res = a != b;
+  } else if constexpr (OP == ComparisonType::LessThan) {
+    res = a < b;
+  } else if constexpr (OP == ComparisonType::LessThanOrEqual) {
+    res = a <= b;
+  } else if constexpr (OP == ComparisonType::GreaterThan) {
+    res = a > b;
+  } else {
+    res = a >= b;
+  }
+  return res ? CmpBool::CmpTrue : CmpBool::CmpFalse;
+}
+
+/** `a op b` is `b Flip(op) a` */
+auto Flip(ComparisonType op) -> ComparisonType {
+  switch (op) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return op;
+  }
+}
+
+/** Where a comparison operand comes from: a column of the left / right tuple, or a constant */
+struct Operand {
+  bool is_constant_{false};
+  uint32_t side_{0};
+  uint32_t offset_{0};
+  TypeId type_{TypeId::INVALID};
+  const Value *constant_{nullptr};
+};
+
+auto MakeOperand(const AbstractExpression &expr, const CompileContext &ctx, Operand *operand) -> bool {
+  if (const auto *constant = dynamic_cast<const ConstantValueExpression *>(&expr); constant != nullptr) {
+    operand->is_constant_ = true;
+    operand->type_ = constant->val_.GetTypeId();
+    operand->constant_ = &constant->val_;
+    return true;
+  }
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(&expr); column != nullptr) {
+    operand->side_ = ctx.is_join_ ? column->GetTupleIdx() : 0;
+    const auto &col = ctx.schemas_[operand->side_]->GetColumn(column->GetColIdx());
+    operand->offset_ = col.GetOffset();
+    operand->type_ = col.GetType();
+    return true;
+  }
+  return false;
+}
+
+template <typename T, ComparisonType OP>
+auto MakeColumnConstant(const Operand &column, T constant) -> Function {
+  return [side = column.side_, offset = column.offset_, constant](const TupleView *left, const TupleView *right) {
+    T val = ReadColumn<T>(side == 0 ? left : right, offset);
+    if (val == NullOf<T>()) {
+      return CmpBool::CmpNull;
+    }
+    return CompareOp<OP>(val, constant);
+  };
+}
+
+template <typename T, ComparisonType OP>
+auto MakeColumnColumn(const Operand &lhs, const Operand &rhs) -> Function {
+  return [lside = lhs.side_, loffset = lhs.offset_, rside = rhs.side_, roffset = rhs.offset_](
+             const TupleView *left, const TupleView *right) {
+    T a = ReadColumn<T>(lside == 0 ? left : right, loffset);
+    T b = ReadColumn<T>(rside == 0 ? left : right, roffset);
+    if (a == NullOf<T>() || b == NullOf<T>()) {
+      return CmpBool::CmpNull;
+    }
+    return CompareOp<OP>(a, b);
+  };
+}
+
+/** `lhs` is always a column; `rhs` a column or a constant of the same storage type T */
+template <typename T, ComparisonType OP>
+auto MakeComparison(const Operand &lhs, const Operand &rhs) -> Function {
+  if (rhs.is_constant_) {
+    return MakeColumnConstant<T, OP>(lhs, rhs.constant_->GetAs<T>());
+  }
+  return MakeColumnColumn<T, OP>(lhs, rhs);
+}
+
+template <typename T>
+auto MakeComparison(ComparisonType op, const Operand &lhs, const Operand &rhs) -> Function {
+  switch (op) {
+    case ComparisonType::Equal:
+      return MakeComparison<T, ComparisonType::Equal>(lhs, rhs);
+    case ComparisonType::NotEqual:
+      return MakeComparison<T, ComparisonType::NotEqual>(lhs, rhs);
+    case ComparisonType::LessThan:
+      return MakeComparison<T, ComparisonType::LessThan>(lhs, rhs);
+    case ComparisonType::LessThanOrEqual:
+      return MakeComparison<T, ComparisonType::LessThanOrEqual>(lhs, rhs);
+    case ComparisonType::GreaterThan:
+      return MakeComparison<T, ComparisonType::GreaterThan>(lhs, rhs);
+    case ComparisonType::GreaterThanOrEqual:
+      return MakeComparison<T, ComparisonType::GreaterThanOrEqual>(lhs, rhs);
+    default:
+      UNREACHABLE("Unsupported comparison type.");
+  }
+}
+
+/** @return a specialized closure for the comparison, or an empty function if there is none for its operands */
+auto CompileComparison(const ComparisonExpression &expr, CompileContext *ctx) -> Function {
+  Operand lhs;
+  Operand rhs;
+  if (!MakeOperand(*expr.GetChildAt(0), *ctx, &lhs) || !MakeOperand(*expr.GetChildAt(1), *ctx, &rhs)) {
+    return {};
+  }
+  if (lhs.type_ != rhs.type_ || (lhs.is_constant_ && rhs.is_constant_)) {
+    return {};
+  }
+  auto op = expr.comp_type_;
+  if (lhs.is_constant_) {
+    std::swap(lhs, rhs);
+    op = Flip(op);
+  }
+  if (rhs.is_constant_ && rhs.constant_->IsNull()) {
+    ctx->num_specialized_++;
+    return [](const TupleView *left, const TupleView *right) { return CmpBool::CmpNull; };
+  }
+  Function fn;
+  switch (lhs.type_) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      fn = MakeComparison<int8_t>(op, lhs, rhs);
+      break;
+    case TypeId::SMALLINT:
+      fn = MakeComparison<int16_t>(op, lhs, rhs);
+      break;
+    case TypeId::INTEGER:
+      fn = MakeComparison<int32_t>(op, lhs, rhs);
+      break;
+    case TypeId::BIGINT:
+      fn = MakeComparison<int64_t>(op, lhs, rhs);
+      break;
+    case TypeId::DECIMAL:
+      fn = MakeComparison<double>(op, lhs, rhs);
+      break;
+    default:
+      return {};
+  }
+  ctx->num_specialized_++;
+  return fn;
+}
+
+auto CompileFallback(const AbstractExpressionRef &expr, const CompileContext &ctx) -> Function {
+  return [expr, left_schema = ctx.schemas_[0], right_schema = ctx.schemas_[1], is_join = ctx.is_join_](
+             const TupleView *left, const TupleView *right) {
+    Tuple left_scratch;
+    Tuple right_scratch;
+    const Tuple *left_tuple = left->AsTuple(&left_scratch);
+    Value val = is_join ? expr->EvaluateJoin(left_tuple, *left_schema, right->AsTuple(&right_scratch), *right_schema)
+                        : expr->Evaluate(left_tuple, *left_schema);
+    if (val.IsNull()) {
+      return CmpBool::CmpNull;
+    }
+    return val.GetAs<bool>() ? CmpBool::CmpTrue : CmpBool::CmpFalse;
+  };
+}
+
+auto CompileNode(const AbstractExpressionRef &expr, CompileContext *ctx) -> Function {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get()); logic != nullptr) {
+    auto lhs = CompileNode(logic->GetChildAt(0), ctx);
+    auto rhs = CompileNode(logic->GetChildAt(1), ctx);
+    if (logic->logic_type_ == LogicType::And) {
+      return [lhs = std::move(lhs), rhs = std::move(rhs)](const TupleView *left, const TupleView *right) {
+        auto l = lhs(left, right);
+        if (l == CmpBool::CmpFalse) {
+          return CmpBool::CmpFalse;
+        }
+        auto r = rhs(left, right);
+        if (r == CmpBool::CmpFalse) {
+          return CmpBool::CmpFalse;
+        }
+        return l == CmpBool::CmpTrue && r == CmpBool::CmpTrue ? CmpBool::CmpTrue : CmpBool::CmpNull;
+      };
+    }
+    return [lhs = std::move(lhs), rhs = std::move(rhs)](const TupleView *left, const TupleView *right) {
+      auto l = lhs(left, right);
+      if (l == CmpBool::CmpTrue) {
+        return CmpBool::CmpTrue;
+      }
+      auto r = rhs(left, right);
+      if (r == CmpBool::CmpTrue) {
+        return CmpBool::CmpTrue;
+      }
+      return l == CmpBool::CmpFalse && r == CmpBool::CmpFalse ? CmpBool::CmpFalse : CmpBool::CmpNull;
+    };
+  }
+  if (const auto *cmp = dynamic_cast<const ComparisonExpression *>(expr.get()); cmp != nullptr) {
+    if (auto fn = CompileComparison(*cmp, ctx); fn) {
+      return fn;
+    }
+  }
+  return CompileFallback(expr, *ctx);
+}
+
+/** Compiles a zone map filter for `expr`, an empty function stands for "any page may match" */
+auto CompileZoneMapNode(const AbstractExpressionRef &expr, const Schema &schema, const ZoneMap::Layout &layout)
+    -> ZoneMapFilter {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(expr.get()); logic != nullptr) {
+    auto lhs = CompileZoneMapNode(logic->GetChildAt(0), schema, layout);
+    auto rhs = CompileZoneMapNode(logic->GetChildAt(1), schema, layout);
+    if (logic->logic_type_ == LogicType::And) {
+      if (!lhs || !rhs) {
+        return lhs ? lhs : rhs;
+      }
+      return [lhs = std::move(lhs), rhs = std::move(rhs)](const ZoneMap &zone_map) {
+        return lhs(zone_map) && rhs(zone_map);
+      };
+    }
+    if (!lhs || !rhs) {
+      return nullptr;
+    }
+    return [lhs = std::move(lhs), rhs = std::move(rhs)](const ZoneMap &zone_map) {
+      return lhs(zone_map) || rhs(zone_map);
+    };
+  }
+
+  const auto *cmp = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (cmp == nullptr) {
+    return nullptr;
+  }
+  CompileContext ctx{{&schema, &schema}, false};
+  Operand lhs;
+  Operand rhs;
+  if (!MakeOperand(*cmp->GetChildAt(0), ctx, &lhs) || !MakeOperand(*cmp->GetChildAt(1), ctx, &rhs)) {
+    return nullptr;
+  }
+  auto op = cmp->comp_type_;
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(cmp->GetChildAt(0).get());
+  if (lhs.is_constant_) {
+    std::swap(lhs, rhs);
+    op = Flip(op);
+    column = dynamic_cast<const ColumnValueExpression *>(cmp->GetChildAt(1).get());
+  }
+  if (lhs.is_constant_ || !rhs.is_constant_ || lhs.type_ != rhs.type_ || !layout.IsTracked(column->GetColIdx())) {
+    return nullptr;
+  }
+  if (rhs.constant_->IsNull()) {
+    // a comparison with NULL never holds
+    return [](const ZoneMap &) { return false; };
+  }
+  auto col_idx = column->GetColIdx();
+  auto constant = *rhs.constant_;
+  switch (op) {
+    case ComparisonType::Equal:
+      return [col_idx, constant](const ZoneMap &zone_map) { return zone_map.MayBeEqual(col_idx, constant); };
+    case ComparisonType::NotEqual:
+      return [col_idx, constant](const ZoneMap &zone_map) { return zone_map.MayDiffer(col_idx, constant); };
+    case ComparisonType::LessThan:
+      return [col_idx, constant](const ZoneMap &zone_map) { return zone_map.MayBeLess(col_idx, constant, false); };
+    case ComparisonType::LessThanOrEqual:
+      return [col_idx, constant](const ZoneMap &zone_map) { return zone_map.MayBeLess(col_idx, constant, true); };
+    case ComparisonType::GreaterThan:
+      return [col_idx, constant](const ZoneMap &zone_map) { return zone_map.MayBeGreater(col_idx, constant, false); };
+    case ComparisonType::GreaterThanOrEqual:
+      return [col_idx, constant](const ZoneMap &zone_map) { return zone_map.MayBeGreater(col_idx, constant, true); };
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace
+
+auto CompileZoneMapFilter(const AbstractExpressionRef &expr, const Schema &schema, const ZoneMap::Layout &layout)
+    -> ZoneMapFilter {
+  return CompileZoneMapNode(expr, schema, layout);
+}
+
+auto CompiledPredicate::Compile(const AbstractExpressionRef &expr, const Schema &schema) -> CompiledPredicate {
+  CompileContext ctx{{&schema, &schema}, false};
+  auto fn = CompileNode(expr, &ctx);
+  return {std::move(fn), ctx.num_specialized_};
+}
+
+auto CompiledPredicate::CompileJoin(const AbstractExpressionRef &expr, const Schema &left_schema,
+                                    const Schema &right_schema) -> CompiledPredicate {
+  CompileContext ctx{{&left_schema, &right_schema}, true};
+  auto fn = CompileNode(expr, &ctx);
+  return {std::move(fn), ctx.num_specialized_};
+}
+
+}  // namespace bustub
@@ -0,0 +1,223 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sorter.cpp
+//
+// Identification: src/execution/external_sorter.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/external_sorter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <utility>
+
+#include "common/util/parallel_sort.h"
+
+namespace bustub {
+
+namespace {
+
+/** Spilled entries are stored as one tuple: | key length (4) | key | RID (8) | tuple data | */
+auto Pack(const std::string &key, const Tuple &tuple) -> Tuple {
+  auto key_len = static_cast<uint32_t>(key.size());
+  int64_t rid = tuple.GetRid().Get();
+  std::vector<char> data(sizeof(uint32_t) + key_len + sizeof(int64_t) + tuple.GetLength());
+  char *out = data.data();
+  memcpy(out, &key_len, sizeof(uint32_t));
+  memcpy(out + sizeof(uint32_t), key.data(), key_len);
+  memcpy(out + sizeof(uint32_t) + key_len, &rid, sizeof(int64_t));
+  memcpy(out + sizeof(uint32_t) + key_len + sizeof(int64_t), tuple.GetData(), tuple.GetLength());
+  return {RID(), data.data(), static_cast<uint32_t>(data.size())};
+}
+
+void Unpack(const Tuple &packed, std::string *key, Tuple *tuple) {
+  const char *in = packed.GetData();
+  uint32_t key_len;
+  memcpy(&key_len, in, sizeof(uint32_t));
+  key->assign(in + sizeof(uint32_t), key_len);
+  int64_t rid;
+  memcpy(&rid, in + sizeof(uint32_t) + key_len, sizeof(int64_t));
+  size_t header = sizeof(uint32_t) + key_len + sizeof(int64_t);
+  *tuple = Tuple(RID(rid), in + header, packed.GetLength() - header);
+}
+
+}  // namespace
+
+/** Reads a spilled run back one page at a time */
+class ExternalSorter::RunReader {
+ public:
+  explicit RunReader(TmpTupleHeap *heap) : heap_(heap) { Load(); }
+
+  auto Valid() const -> bool { return pos_ < entries_.size(); }
+  auto Key() const -> const std::string & { return entries_[pos_].key_; }
+  auto Current() -> Entry & { return entries_[pos_]; }
+
+  void Advance() {
+    if (++pos_ == entries_.size()) {
+      Load();
+    }
+  }
+
+ private:
+  void Load() {
+    entries_.clear();
+    pos_ = 0;
+    if (page_ >= heap_->NumPages()) {
+      return;
+    }
+    std::vector<Tuple> packed;
+    heap_->ReadPage(page_++, &packed);
+    entries_.resize(packed.size());
+    for (size_t i = 0; i < packed.size(); i++) {
+      Unpack(packed[i], &entries_[i].key_, &entries_[i].tuple_);
+    }
+  }
+
+  TmpTupleHeap *heap_;
+  size_t page_{0};
+  std::vector<Entry> entries_;
+  size_t pos_{0};
+};
+
+/** k-way merge of spilled runs; on equal keys the earlier run goes first */
+class ExternalSorter::Merger {
+ public:
+  explicit Merger(const std::vector<TmpTupleHeap *> &runs) {
+    readers_.reserve(runs.size());
+    for (auto *run : runs) {
+      readers_.emplace_back(run);
+    }
+    for (size_t i = 0; i < readers_.size(); i++) {
+      if (readers_[i].Valid()) {
+        heap_.push(i);
+      }
+    }
+  }
+
+  auto Next(Entry *entry) -> bool {
+    if (heap_.empty()) {
+      return false;
+    }
+    size_t run = heap_.top();
+    heap_.pop();
+    *entry = std::move(readers_[run].Current());
+    readers_[run].Advance();
+    if (readers_[run].Valid()) {
+      heap_.push(run);
+    }
+    return true;
+  }
+
+ private:
+  struct Later {
+    const std::vector<RunReader> *readers_;
+    auto operator()(size_t a, size_t b) const -> bool {
+      int cmp = (*readers_)[a].Key().compare((*readers_)[b].Key());
+      return cmp > 0 || (cmp == 0 && a > b);
+    }
+  };
+
+  std::vector<RunReader> readers_;
+  std::priority_queue<size_t, std::vector<size_t>, Later> heap_{Later{&readers_}};
+};
+
+ExternalSorter::ExternalSorter(BufferPoolManager *bpm, size_t memory_limit, size_t num_threads)
+    : bpm_(bpm), memory_limit_(memory_limit), num_threads_(num_threads) {}
+
+ExternalSorter::~ExternalSorter() = default;
+
+void ExternalSorter::Add(std::string key, Tuple tuple) {
+  run_bytes_ += sizeof(Entry) + key.size() + tuple.GetLength();
+  run_.push_back({std::move(key), std::move(tuple)});
+  if (run_bytes_ > memory_limit_ && bpm_ != nullptr) {
+    SpillRun();
+  }
+}
+
+void ExternalSorter::SortRun() {
+  ParallelSort::Sort(
+      &run_, [](const Entry &a, const Entry &b) { return a.key_ < b.key_; }, num_threads_);
+}
+
+void ExternalSorter::SpillRun() {
+  SortRun();
+  auto heap = std::make_unique<TmpTupleHeap>(bpm_);
+  for (const auto &entry : run_) {
+    heap->Append(Pack(entry.key_, entry.tuple_));
+  }
+  spilled_runs_.push_back(std::move(heap));
+  num_spilled_runs_++;
+  run_.clear();
+  run_bytes_ = 0;
+}
+
+void ExternalSorter::Finish() {
+  cursor_ = 0;
+  if (spilled_runs_.empty()) {
+    SortRun();
+    return;
+  }
+  if (!run_.empty()) {
+    SpillRun();
+  }
+
+  // every run being merged holds one page in memory
+  const size_t fan_in = std::max<size_t>(2, memory_limit_ / BUSTUB_PAGE_SIZE);
+  while (spilled_runs_.size() > fan_in) {
+    // merge consecutive runs, so that equal keys still come out in the order they were added
+    std::vector<std::unique_ptr<TmpTupleHeap>> merged;
+    for (size_t begin = 0; begin < spilled_runs_.size(); begin += fan_in) {
+      size_t end = std::min(spilled_runs_.size(), begin + fan_in);
+      if (end - begin == 1) {
+        merged.push_back(std::move(spilled_runs_[begin]));
+        continue;
+      }
+      std::vector<TmpTupleHeap *> group;
+      for (size_t i = begin; i < end; i++) {
+        group.push_back(spilled_runs_[i].get());
+      }
+      auto heap = std::make_unique<TmpTupleHeap>(bpm_);
+      Merger merger(group);
+      Entry entry;
+      while (merger.Next(&entry)) {
+        heap->Append(Pack(entry.key_, entry.tuple_));
+      }
+      merged.push_back(std::move(heap));
+      // the merged runs are no longer needed, free their pages right away
+      for (size_t i = begin; i < end; i++) {
+        spilled_runs_[i].reset();
+      }
+    }
+    spilled_runs_ = std::move(merged);
+  }
+
+  std::vector<TmpTupleHeap *> runs;
+  for (const auto &run : spilled_runs_) {
+    runs.push_back(run.get());
+  }
+  merger_ = std::make_unique<Merger>(runs);
+}
+
+auto ExternalSorter::Next(Tuple *tuple) -> bool {
+  if (merger_ != nullptr) {
+    Entry entry;
+    if (!merger_->Next(&entry)) {
+      return false;
+    }
+    *tuple = std::move(entry.tuple_);
+    return true;
+  }
+  if (cursor_ >= run_.size()) {
+    return false;
+  }
+  *tuple = std::move(run_[cursor_++].tuple_);
+  return true;
+}
+
+}  // namespace bustub
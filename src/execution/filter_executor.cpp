@@ -9,26 +9,33 @@ FilterExecutor::FilterExecutor(ExecutorContext *exec_ctx, const FilterPlanNode *
     : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
 void FilterExecutor::Init() {
+  ResetBatch();
   // Initialize the child executor
   child_executor_->Init();
 }
 
-auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  auto filter_expr = plan_->GetPredicate();
+auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
 
-  while (true) {
-    // Get the next tuple
-    const auto status = child_executor_->Next(tuple, rid);
+auto FilterExecutor::NextBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size) -> bool {
+  tuples->clear();
+  rids->clear();
+  auto filter_expr = plan_->GetPredicate();
+  const auto &child_schema = child_executor_->GetOutputSchema();
 
-    if (!status) {
+  // Keep pulling child batches until at least one tuple survives the predicate
+  while (tuples->empty()) {
+    if (!child_executor_->NextBatch(&child_tuples_, &child_rids_, batch_size)) {
       return false;
     }
-
-    auto value = filter_expr->Evaluate(tuple, child_executor_->GetOutputSchema());
-    if (!value.IsNull() && value.GetAs<bool>()) {
-      return true;
+    // Evaluate the predicate over the whole batch, then keep the rows it selected
+    filter_expr->EvaluateBatch(child_tuples_, child_schema, &predicate_);
+    SelectTrue(predicate_, &selection_);
+    for (auto i : selection_) {
+      tuples->push_back(std::move(child_tuples_[i]));
+      rids->push_back(child_rids_[i]);
     }
   }
+  return true;
 }
 
 }  // namespace bustub
@@ -10,10 +10,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <iterator>
+
 #include "execution/executors/hash_join_executor.h"
+#include "common/util/hash_util.h"
+#include "common/util/parallel_util.h"
 #include "execution/expressions/column_value_expression.h"
 #include "type/value_factory.h"
-#include "execution/expressions/comparison_expression.h"
 
 namespace bustub {
 
@@ -29,91 +33,268 @@ namespace bustub {
     }
 
     void HashJoinExecutor::Init() {
+        ResetBatch();
         left_child->Init();
         right_child->Init();
-        Tuple t;
-        RID r;
-
-        while (right_child->Next(&t, &r)) {
-            size_t cur_hash = 0;
-//            LOG_INFO("right hash table:idx:%d%s", idx, t.GetData());
-            for (const auto &expr: plan_->RightJoinKeyExpressions()) {
-                auto k = expr->Evaluate(&t, right_child->GetOutputSchema());
-                if (!k.IsNull())
-                    cur_hash = HashUtil::CombineHashes(cur_hash, HashUtil::HashValue(&k));
+        output_.clear();
+        output_cursor_ = 0;
+        pending_.clear();
+        current_.reset();
+
+        // An inner join drops the left rows without a partner anyway, so the right keys are summarized while the
+        // right side is read and the left scan drops those rows before it copies or locks them.
+        auto filter_columns = plan_->GetJoinType() == JoinType::INNER ? RuntimeFilterColumns() : std::nullopt;
+        auto runtime_filter = filter_columns.has_value() ? std::make_shared<RuntimeFilter>() : nullptr;
+        Build([this, &runtime_filter](std::vector<Tuple> *batch) {
+            std::vector<RID> rids;
+            if (!right_child->NextBatch(batch, &rids, BUSTUB_BATCH_SIZE)) {
+                return false;
+            }
+            if (runtime_filter != nullptr) {
+                const auto &right_schema = right_child->GetOutputSchema();
+                std::vector<Value> key;
+                for (const auto &tuple: *batch) {
+                    key.clear();
+                    for (const auto &expr: plan_->RightJoinKeyExpressions()) {
+                        key.push_back(expr->Evaluate(&tuple, right_schema));
+                    }
+                    runtime_filter->Insert(key);
+                }
+                if (runtime_filter->NumKeys() > RuntimeFilter::MAX_KEYS) {
+                    runtime_filter.reset();
+                }
             }
-            ht_[cur_hash].push_back(t);
-//            LOG_INFO("right hash table tt%zu", cur_hash);
+            return true;
+        }, 0);
+        if (runtime_filter != nullptr) {
+            runtime_filter->Seal();
+            left_child->PushRuntimeFilter(RuntimeFilterProbe{std::move(runtime_filter), std::move(*filter_columns)});
         }
+        left_source_ = [this](std::vector<Tuple> *batch) {
+            std::vector<RID> rids;
+            return left_child->NextBatch(batch, &rids, BUSTUB_BATCH_SIZE);
+        };
     }
 
-    auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+    auto HashJoinExecutor::RuntimeFilterColumns() const -> std::optional<std::vector<uint32_t>> {
+        const auto &left_keys = plan_->LeftJoinKeyExpressions();
+        const auto &right_keys = plan_->RightJoinKeyExpressions();
+        std::vector<uint32_t> columns;
+        for (size_t i = 0; i < left_keys.size(); i++) {
+            const auto *column = dynamic_cast<const ColumnValueExpression *>(left_keys[i].get());
+            if (column == nullptr) {
+                return std::nullopt;
+            }
+            if (!RuntimeFilter::SupportsTypes(right_keys[i]->GetReturnType(), column->GetReturnType())) {
+                return std::nullopt;
+            }
+            columns.push_back(column->GetColIdx());
+        }
+        return columns;
+    }
 
-        RID r;
-        while (idx >= 0 || left_child->Next(&left_tuple, &r)) {
-            size_t cur_hash = 0;
-            for (const auto &expr: plan_->LeftJoinKeyExpressions()) {
-                auto k = expr->Evaluate(&left_tuple, left_child->GetOutputSchema());
-                if (!k.IsNull())
-                    cur_hash = HashUtil::CombineHashes(cur_hash, HashUtil::HashValue(&k));
+    auto HashJoinExecutor::PushRuntimeFilter(const RuntimeFilterProbe &probe) -> bool {
+        const auto num_left_columns = left_child->GetOutputSchema().GetColumnCount();
+        for (auto col: probe.columns_) {
+            if (col >= num_left_columns) {
+                return false;
             }
-            if (ht_.count(cur_hash)) {
-//                LOG_INFO("left hash table tt%zu", cur_hash);
-                for (size_t j = (idx >= 0 ? idx : 0); j < ht_[cur_hash].size(); j++) {
+        }
+        // left rows dropped here would only have produced output rows the join above drops
+        return left_child->PushRuntimeFilter(probe);
+    }
 
-                    bool founded = true;
-                    int ld = 0;
-                    for (const auto &expr: plan_->RightJoinKeyExpressions()) {
-                        auto k = expr->Evaluate(&ht_[cur_hash][j], right_child->GetOutputSchema());
-                        if (!k.IsNull()) {
-                            auto res = k.CompareEquals(
-                                plan_->LeftJoinKeyExpressions()[ld++]->Evaluate(&left_tuple,
-                                                                                left_child->GetOutputSchema()));
-                            if (res != CmpBool::CmpTrue) {
-                                founded = false;
-                                break;
-                            }
-                        }
-                    }
-                    if (founded) {
-                        std::vector<Value> values;
-                        values.reserve(
-                            left_child->GetOutputSchema().GetColumnCount() +
-                            right_child->GetOutputSchema().GetColumnCount());
-                        for (uint32_t i = 0; i < left_child->GetOutputSchema().GetColumnCount(); ++i) {
-                            values.push_back(left_tuple.GetValue(&left_child->GetOutputSchema(), i));
-                        }
-                        for (uint32_t i = 0; i < right_child->GetOutputSchema().GetColumnCount(); ++i) {
-                            values.push_back(ht_[cur_hash][j].GetValue(&right_child->GetOutputSchema(), i));
-                        }
-
-                        *tuple = Tuple{values, &GetOutputSchema()};
-                        idx = j + 1;
-                        return true;
-                    }
+    auto HashJoinExecutor::PartitionOf(const Tuple &tuple, const std::vector<AbstractExpressionRef> &exprs,
+                                       const Schema &schema) const -> size_t {
+        hash_t hash = 0;
+        for (const auto &expr: exprs) {
+            auto key = expr->Evaluate(&tuple, schema);
+            if (key.IsNull()) {
+                return GRACE_JOIN_FANOUT;
+            }
+            hash = HashUtil::CombineHashes(hash, HashUtil::HashValue(&key));
+        }
+        // every level partitions on the next few bits of the hash
+        return (HashUtil::MixHash(hash) >> (level_ * 8)) % GRACE_JOIN_FANOUT;
+    }
 
-                }
+    void HashJoinExecutor::Build(const TupleSource &right, size_t level) {
+        level_ = level;
+        spilled_.clear();
+        auto *bpm = exec_ctx_->GetBufferPoolManager();
+        const size_t limit = exec_ctx_->GetMemoryLimit();
+        const auto &right_schema = right_child->GetOutputSchema();
+        const bool can_spill = bpm != nullptr && level < static_cast<size_t>(GRACE_JOIN_MAX_LEVEL);
 
+        // Rows are gathered as is until they exceed the limit. From then on they are partitioned, and the largest
+        // resident partition is spilled whenever the resident ones exceed the limit again.
+        std::vector<Tuple> rows;
+        std::vector<std::vector<Tuple>> partitions;
+        std::vector<size_t> partition_bytes;
+        size_t bytes = 0;
+        auto add_partitioned = [&](Tuple &&tuple) {
+            auto p = PartitionOf(tuple, plan_->RightJoinKeyExpressions(), right_schema);
+            if (p == GRACE_JOIN_FANOUT) {
+                // a NULL key never matches
+                return;
             }
-            if (idx == -1 && JoinType::LEFT == plan_->GetJoinType()) {
-                std::vector<Value> values;
-                values.reserve(
-                    left_child->GetOutputSchema().GetColumnCount() + right_child->GetOutputSchema().GetColumnCount());
-                for (uint32_t i = 0; i < left_child->GetOutputSchema().GetColumnCount(); ++i) {
-                    values.push_back(left_tuple.GetValue(&left_child->GetOutputSchema(), i));
+            if (spilled_[p] != nullptr) {
+                spilled_[p]->right_.Append(tuple);
+                return;
+            }
+            size_t size = sizeof(Tuple) + tuple.GetLength();
+            partition_bytes[p] += size;
+            bytes += size;
+            partitions[p].push_back(std::move(tuple));
+            while (bytes > limit) {
+                auto victim = std::distance(partition_bytes.begin(),
+                                            std::max_element(partition_bytes.begin(), partition_bytes.end()));
+                if (partition_bytes[victim] == 0) {
+                    break;
                 }
-                for (uint32_t i = 0; i < right_child->GetOutputSchema().GetColumnCount(); ++i) {
-                    values.push_back(
-                        ValueFactory::GetNullValueByType(right_child->GetOutputSchema().GetColumn(i).GetType()));
+                spilled_[victim] = std::make_unique<SpilledPartition>(bpm, level);
+                for (const auto &t: partitions[victim]) {
+                    spilled_[victim]->right_.Append(t);
                 }
+                partitions[victim] = {};
+                bytes -= partition_bytes[victim];
+                partition_bytes[victim] = 0;
+            }
+        };
 
-                *tuple = Tuple{values, &GetOutputSchema()};
-                return true;
+        std::vector<Tuple> batch;
+        while (right(&batch)) {
+            for (auto &tuple: batch) {
+                if (!spilled_.empty()) {
+                    add_partitioned(std::move(tuple));
+                    continue;
+                }
+                bytes += sizeof(Tuple) + tuple.GetLength();
+                rows.push_back(std::move(tuple));
+                if (bytes > limit && can_spill) {
+                    spilled_.resize(GRACE_JOIN_FANOUT);
+                    partitions.resize(GRACE_JOIN_FANOUT);
+                    partition_bytes.assign(GRACE_JOIN_FANOUT, 0);
+                    bytes = 0;
+                    for (auto &row: rows) {
+                        add_partitioned(std::move(row));
+                    }
+                    rows = {};
+                }
+            }
+        }
+        for (auto &partition: partitions) {
+            std::move(partition.begin(), partition.end(), std::back_inserter(rows));
+        }
+        if (std::all_of(spilled_.begin(), spilled_.end(), [](const auto &p) { return p == nullptr; })) {
+            spilled_.clear();
+        }
+        ht_ = std::make_unique<RadixJoinHashTable>(plan_->RightJoinKeyExpressions(), &right_schema,
+                                                   plan_->LeftJoinKeyExpressions(), &left_child->GetOutputSchema(),
+                                                   exec_ctx_->GetNumThreads());
+        ht_->Build(std::move(rows));
+    }
+
+    auto HashJoinExecutor::JoinTuples(const Tuple &left, const Tuple *right) const -> Tuple {
+        const auto &left_schema = left_child->GetOutputSchema();
+        const auto &right_schema = right_child->GetOutputSchema();
+        std::vector<Value> values;
+        values.reserve(left_schema.GetColumnCount() + right_schema.GetColumnCount());
+        for (uint32_t i = 0; i < left_schema.GetColumnCount(); ++i) {
+            values.push_back(left.GetValue(&left_schema, i));
+        }
+        for (uint32_t i = 0; i < right_schema.GetColumnCount(); ++i) {
+            values.push_back(right != nullptr ? right->GetValue(&right_schema, i)
+                                              : ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+        }
+        return Tuple{values, &GetOutputSchema()};
+    }
+
+    auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+        return NextFromBatch(tuple, rid);
+    }
+
+    auto HashJoinExecutor::ProbeNextChunk() -> bool {
+        const auto &left_schema = left_child->GetOutputSchema();
+        std::vector<Tuple> left;
+        std::vector<Tuple> batch;
+        while (left.size() < static_cast<size_t>(HASH_JOIN_PROBE_CHUNK) && left_source_(&batch)) {
+            for (auto &tuple: batch) {
+                if (!spilled_.empty()) {
+                    // rows of a spilled partition are joined with it later, NULL keys stay to be reported unmatched
+                    auto p = PartitionOf(tuple, plan_->LeftJoinKeyExpressions(), left_schema);
+                    if (p != GRACE_JOIN_FANOUT && spilled_[p] != nullptr) {
+                        spilled_[p]->left_.Append(tuple);
+                        continue;
+                    }
+                }
+                left.push_back(std::move(tuple));
             }
-            idx = -1;
+        }
+        if (left.empty()) {
+            return false;
+        }
+        std::vector<std::pair<uint32_t, uint32_t>> matches;
+        ht_->Probe(left, plan_->GetJoinType() == JoinType::LEFT, &matches);
+
+        output_.resize(matches.size());
+        output_cursor_ = 0;
+        // build the joined tuples in parallel too, this is where most of the time goes for wide rows
+        constexpr size_t chunk_size = 4096;
+        auto join_chunk = [&](size_t chunk) {
+            size_t end = std::min(matches.size(), (chunk + 1) * chunk_size);
+            for (size_t i = chunk * chunk_size; i < end; i++) {
+                auto [l, r] = matches[i];
+                output_[i] = JoinTuples(left[l], r == RadixJoinHashTable::NO_MATCH ? nullptr : &ht_->GetBuildRow(r));
+            }
+        };
+        ParallelUtil::ParallelFor(exec_ctx_->GetNumThreads(), ParallelUtil::NumChunks(matches.size(), chunk_size),
+                                  join_chunk);
+        return true;
+    }
+
+    auto HashJoinExecutor::NextSpilledPartition() -> bool {
+        for (auto it = spilled_.rbegin(); it != spilled_.rend(); ++it) {
+            if (*it != nullptr) {
+                pending_.push_front(std::move(*it));
+            }
+        }
+        spilled_.clear();
+        if (pending_.empty()) {
+            return false;
+        }
+        current_ = std::move(pending_.front());
+        pending_.pop_front();
 
+        auto read_heap = [](TmpTupleHeap *heap) {
+            return [heap, page = size_t{0}](std::vector<Tuple> *batch) mutable {
+                batch->clear();
+                if (page >= heap->NumPages()) {
+                    return false;
+                }
+                heap->ReadPage(page++, batch);
+                return true;
+            };
+        };
+        Build(read_heap(&current_->right_), current_->level_ + 1);
+        left_source_ = read_heap(&current_->left_);
+        return true;
+    }
+
+    auto HashJoinExecutor::NextBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size) -> bool {
+        tuples->clear();
+        rids->clear();
+        while (output_cursor_ >= output_.size()) {
+            output_.clear();
+            if (!ProbeNextChunk() && !NextSpilledPartition()) {
+                return false;
+            }
         }
-        return false;
+        size_t end = std::min(output_.size(), output_cursor_ + batch_size);
+        std::move(output_.begin() + output_cursor_, output_.begin() + end, std::back_inserter(*tuples));
+        rids->resize(tuples->size());
+        output_cursor_ = end;
+        return true;
     }
 
 }  // namespace bustub
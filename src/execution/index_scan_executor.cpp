@@ -14,25 +14,71 @@
 namespace bustub {
 	IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
 		: AbstractExecutor(exec_ctx), plan_(plan),
-		  tree_{dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(exec_ctx_->GetCatalog()->GetIndex(
-			  plan_->GetIndexOid())->index_.get())}, iter_{tree_->GetBeginIterator()} {}
+		  index_info_{exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid())} {}
 
 	void IndexScanExecutor::Init() {
-		tableInfo = exec_ctx_->GetCatalog()->GetTable(exec_ctx_->GetCatalog()->GetIndex(
-			plan_->GetIndexOid())->table_name_);
+		tableInfo = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_);
+		iter_.reset();
+		rids_.clear();
+		rid_cursor_ = 0;
+		runtime_filters_.clear();
+		if (plan_->pred_key_ != nullptr) {
+			auto key = plan_->pred_key_->Evaluate(nullptr, GetOutputSchema());
+			Tuple key_tuple({key}, &index_info_->key_schema_);
+			index_info_->index_->ScanKey(key_tuple, &rids_, exec_ctx_->GetTransaction());
+			return;
+		}
+		auto tree = dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(index_info_->index_.get());
+		BUSTUB_ENSURE(tree != nullptr, "full index scan needs an ordered index");
+		// constructed in place: the iterator holds a page latch and must not be copied
+		iter_ = std::unique_ptr<BPlusTreeIndexIteratorForTwoIntegerColumn>(
+			new BPlusTreeIndexIteratorForTwoIntegerColumn(tree->GetBeginIterator()));
 	}
 
 	auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+		if (plan_->pred_key_ != nullptr) {
+			while (rid_cursor_ < rids_.size()) {
+				auto match = rids_[rid_cursor_++];
+				auto res = tableInfo->table_->GetTuple(match);
+				if (res.first.is_deleted_ || !PassesRuntimeFilters(res.second)) {
+					continue;
+				}
+				*rid = match;
+				*tuple = Produce(res.second);
+				return true;
+			}
+			return false;
+		}
 
-		if (!iter_.IsEnd()) {
-			const auto pair = *iter_;
+		while (!iter_->IsEnd()) {
+			const auto pair = **iter_;
+			++(*iter_);
 			auto res = tableInfo->table_->GetTuple(pair.second);
+			if (!PassesRuntimeFilters(res.second)) {
+				continue;
+			}
 			*rid = pair.second;
-			*tuple = res.second;
-			++iter_;
+			*tuple = Produce(res.second);
 			return true;
 		}
 		return false;
 	}
 
+	auto IndexScanExecutor::PushRuntimeFilter(const RuntimeFilterProbe &probe) -> bool {
+		runtime_filters_.push_back(probe.OnTableColumns(plan_->column_ids_));
+		return true;
+	}
+
+	auto IndexScanExecutor::PassesRuntimeFilters(const Tuple &row) const -> bool {
+		return runtime_filters_.empty() || RuntimeFilterProbe::AllMayMatch(runtime_filters_, TupleView(row),
+																			tableInfo->schema_);
+	}
+
+	auto IndexScanExecutor::Produce(const Tuple &row) const -> Tuple {
+		if (plan_->column_ids_.empty()) {
+			return row;
+		}
+		return TupleView(row).Project(tableInfo->schema_, GetOutputSchema(), plan_->column_ids_);
+	}
+
 }  // namespace bustub
@@ -26,7 +26,7 @@ namespace bustub {
             GetExecutorContext()->GetLockManager()->LockTable(GetExecutorContext()->GetTransaction(),
                                                               LockManager::LockMode::INTENTION_EXCLUSIVE,
                                                               plan_->GetTableOid());
-        } catch (TransactionAbortException e) {
+        } catch (TransactionAbortException &e) {
             throw ExecutionException("insert get table lock failed");
         }
     }
@@ -0,0 +1,273 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table.cpp
+//
+// Identification: src/execution/join_hash_table.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/join_hash_table.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+#include "common/util/parallel_util.h"
+
+namespace bustub {
+
+namespace {
+
+/** Rows handled by one task when computing keys or scattering */
+constexpr size_t CHUNK_SIZE = 16384;
+/** Build rows per partition we aim for, so that a partition's table fits in the L2 cache */
+constexpr size_t PARTITION_ROWS = 8192;
+constexpr size_t MAX_RADIX_BITS = 12;
+
+auto IsIntegralType(TypeId type) -> bool {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+}
+
+auto IntegralValue(const Value &val) -> int64_t {
+  switch (val.GetTypeId()) {
+    case TypeId::TINYINT:
+      return val.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return val.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return val.GetAs<int32_t>();
+    case TypeId::BIGINT:
+      return val.GetAs<int64_t>();
+    default:
+      UNREACHABLE("not an integral value");
+  }
+}
+
+auto RadixBits(size_t num_rows) -> size_t {
+  size_t bits = 0;
+  while (bits < MAX_RADIX_BITS && (num_rows >> bits) > 2 * PARTITION_ROWS) {
+    bits++;
+  }
+  return bits;
+}
+
+}  // namespace
+
+RadixJoinHashTable::RadixJoinHashTable(std::vector<AbstractExpressionRef> build_keys, const Schema *build_schema,
+                                       std::vector<AbstractExpressionRef> probe_keys, const Schema *probe_schema,
+                                       size_t num_threads)
+    : build_exprs_(std::move(build_keys)),
+      build_schema_(build_schema),
+      probe_exprs_(std::move(probe_keys)),
+      probe_schema_(probe_schema),
+      num_threads_(std::max<size_t>(1, num_threads)) {
+  BUSTUB_ASSERT(build_exprs_.size() == probe_exprs_.size(), "join keys mismatch");
+  integral_ = build_exprs_.size() == 1 && IsIntegralType(build_exprs_[0]->GetReturnType()) &&
+              IsIntegralType(probe_exprs_[0]->GetReturnType());
+}
+
+void RadixJoinHashTable::ComputeKeys(const std::vector<Tuple> &rows, const std::vector<AbstractExpressionRef> &exprs,
+                                     const Schema &schema, KeyBatch *batch) const {
+  const size_t num_rows = rows.size();
+  const size_t num_keys = exprs.size();
+  batch->hashes_.resize(num_rows);
+  batch->valid_.resize(num_rows);
+  if (IsIntegral()) {
+    batch->int_keys_.resize(num_rows);
+    batch->keys_.clear();
+  } else {
+    batch->int_keys_.clear();
+    batch->keys_.assign(num_rows * num_keys, Value{});
+  }
+  ParallelUtil::ParallelFor(num_threads_, ParallelUtil::NumChunks(num_rows, CHUNK_SIZE), [&](size_t chunk) {
+    const size_t end = std::min(num_rows, (chunk + 1) * CHUNK_SIZE);
+    for (size_t i = chunk * CHUNK_SIZE; i < end; i++) {
+      if (IsIntegral()) {
+        auto key = exprs[0]->Evaluate(&rows[i], schema);
+        batch->valid_[i] = static_cast<uint8_t>(!key.IsNull());
+        batch->int_keys_[i] = key.IsNull() ? 0 : IntegralValue(key);
+        batch->hashes_[i] = HashUtil::MixHash(static_cast<uint64_t>(batch->int_keys_[i]));
+        continue;
+      }
+      hash_t hash = 0;
+      bool valid = true;
+      for (size_t k = 0; k < num_keys; k++) {
+        auto &key = batch->keys_[i * num_keys + k];
+        key = exprs[k]->Evaluate(&rows[i], schema);
+        valid = valid && !key.IsNull();
+        if (valid) {
+          hash = HashUtil::CombineHashes(hash, HashUtil::HashValue(&key));
+        }
+      }
+      batch->valid_[i] = static_cast<uint8_t>(valid);
+      batch->hashes_[i] = HashUtil::MixHash(hash);
+    }
+  });
+}
+
+void RadixJoinHashTable::Scatter(const KeyBatch &batch, std::vector<uint32_t> *order,
+                                 std::vector<size_t> *offsets) const {
+  const size_t num_rows = batch.hashes_.size();
+  const size_t num_partitions = partitions_.size();
+  const size_t num_chunks = ParallelUtil::NumChunks(num_rows, CHUNK_SIZE);
+
+  // histogram of every chunk, so that chunks can be scattered in parallel into disjoint ranges
+  std::vector<std::vector<size_t>> histograms(num_chunks, std::vector<size_t>(num_partitions, 0));
+  ParallelUtil::ParallelFor(num_threads_, num_chunks, [&](size_t chunk) {
+    const size_t end = std::min(num_rows, (chunk + 1) * CHUNK_SIZE);
+    for (size_t i = chunk * CHUNK_SIZE; i < end; i++) {
+      if (batch.valid_[i] != 0) {
+        histograms[chunk][PartitionOf(batch.hashes_[i])]++;
+      }
+    }
+  });
+
+  offsets->assign(num_partitions + 1, 0);
+  size_t total = 0;
+  for (size_t p = 0; p < num_partitions; p++) {
+    (*offsets)[p] = total;
+    for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+      size_t count = histograms[chunk][p];
+      histograms[chunk][p] = total;
+      total += count;
+    }
+  }
+  (*offsets)[num_partitions] = total;
+
+  order->resize(total);
+  ParallelUtil::ParallelFor(num_threads_, num_chunks, [&](size_t chunk) {
+    auto &cursor = histograms[chunk];
+    const size_t end = std::min(num_rows, (chunk + 1) * CHUNK_SIZE);
+    for (size_t i = chunk * CHUNK_SIZE; i < end; i++) {
+      if (batch.valid_[i] != 0) {
+        (*order)[cursor[PartitionOf(batch.hashes_[i])]++] = static_cast<uint32_t>(i);
+      }
+    }
+  });
+}
+
+void RadixJoinHashTable::Build(std::vector<Tuple> &&rows) {
+  BUSTUB_ASSERT(rows.size() < NO_MATCH, "too many build rows");
+  rows_ = std::move(rows);
+  ComputeKeys(rows_, build_exprs_, *build_schema_, &build_keys_);
+
+  radix_bits_ = RadixBits(rows_.size());
+  partitions_.clear();
+  partitions_.resize(static_cast<size_t>(1) << radix_bits_);
+
+  std::vector<uint32_t> order;
+  std::vector<size_t> offsets;
+  Scatter(build_keys_, &order, &offsets);
+
+  // insert in row order within each partition, so that probes can report matches in build order cheaply
+  ParallelUtil::ParallelFor(num_threads_, partitions_.size(), [&](size_t p) {
+    auto &partition = partitions_[p];
+    const size_t count = offsets[p + 1] - offsets[p];
+    size_t capacity = 16;
+    while (capacity < 2 * count) {
+      capacity <<= 1;
+    }
+    partition.slots_.assign(capacity, Entry{0, 0, NO_MATCH});
+    partition.mask_ = capacity - 1;
+    for (size_t i = offsets[p]; i < offsets[p + 1]; i++) {
+      uint32_t row = order[i];
+      hash_t hash = build_keys_.hashes_[row];
+      size_t slot = hash & partition.mask_;
+      while (partition.slots_[slot].row_ != NO_MATCH) {
+        slot = (slot + 1) & partition.mask_;
+      }
+      partition.slots_[slot] = {hash, IsIntegral() ? build_keys_.int_keys_[row] : 0, row};
+    }
+  });
+}
+
+auto RadixJoinHashTable::KeysEqual(const KeyBatch &probe, uint32_t probe_row, uint32_t build_row) const -> bool {
+  const size_t num_keys = build_exprs_.size();
+  for (size_t k = 0; k < num_keys; k++) {
+    const auto &l = probe.keys_[probe_row * num_keys + k];
+    const auto &r = build_keys_.keys_[build_row * num_keys + k];
+    if (l.CompareEquals(r) != CmpBool::CmpTrue) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void RadixJoinHashTable::Probe(const std::vector<Tuple> &probe, bool keep_unmatched,
+                               std::vector<std::pair<uint32_t, uint32_t>> *matches) const {
+  matches->clear();
+  const size_t num_rows = probe.size();
+  if (num_rows == 0) {
+    return;
+  }
+  KeyBatch keys;
+  ComputeKeys(probe, probe_exprs_, *probe_schema_, &keys);
+
+  std::vector<uint32_t> order;
+  std::vector<size_t> offsets;
+  Scatter(keys, &order, &offsets);
+
+  // Every probe row belongs to exactly one partition, so the partition tasks write disjoint entries of
+  // match_begin / match_count. The matched build rows are collected per partition first.
+  std::vector<std::vector<uint32_t>> partition_matches(partitions_.size());
+  std::vector<uint32_t> match_begin(num_rows, 0);
+  std::vector<uint32_t> match_count(num_rows, 0);
+  ParallelUtil::ParallelFor(num_threads_, partitions_.size(), [&](size_t p) {
+    const auto &partition = partitions_[p];
+    auto &found = partition_matches[p];
+    for (size_t i = offsets[p]; i < offsets[p + 1]; i++) {
+      uint32_t row = order[i];
+      hash_t hash = keys.hashes_[row];
+      auto begin = static_cast<uint32_t>(found.size());
+      for (size_t slot = hash & partition.mask_; partition.slots_[slot].row_ != NO_MATCH;
+           slot = (slot + 1) & partition.mask_) {
+        const auto &entry = partition.slots_[slot];
+        if (entry.hash_ != hash) {
+          continue;
+        }
+        if (IsIntegral() ? entry.key_ == keys.int_keys_[row] : KeysEqual(keys, row, entry.row_)) {
+          found.push_back(entry.row_);
+        }
+      }
+      // linear probing can wrap around the table, restore build order
+      std::sort(found.begin() + begin, found.end());
+      match_begin[row] = begin;
+      match_count[row] = static_cast<uint32_t>(found.size()) - begin;
+    }
+  });
+
+  // lay the matches out in probe order
+  const size_t num_chunks = ParallelUtil::NumChunks(num_rows, CHUNK_SIZE);
+  std::vector<size_t> chunk_offsets(num_chunks + 1, 0);
+  for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+    size_t total = 0;
+    const size_t end = std::min(num_rows, (chunk + 1) * CHUNK_SIZE);
+    for (size_t i = chunk * CHUNK_SIZE; i < end; i++) {
+      total += match_count[i] == 0 && keep_unmatched ? 1 : match_count[i];
+    }
+    chunk_offsets[chunk + 1] = chunk_offsets[chunk] + total;
+  }
+  matches->resize(chunk_offsets[num_chunks]);
+  ParallelUtil::ParallelFor(num_threads_, num_chunks, [&](size_t chunk) {
+    size_t out = chunk_offsets[chunk];
+    const size_t end = std::min(num_rows, (chunk + 1) * CHUNK_SIZE);
+    for (size_t i = chunk * CHUNK_SIZE; i < end; i++) {
+      auto row = static_cast<uint32_t>(i);
+      if (match_count[i] == 0) {
+        if (keep_unmatched) {
+          (*matches)[out++] = {row, NO_MATCH};
+        }
+        continue;
+      }
+      const auto &found = partition_matches[PartitionOf(keys.hashes_[i])];
+      for (uint32_t m = 0; m < match_count[i]; m++) {
+        (*matches)[out++] = {row, found[match_begin[i] + m]};
+      }
+    }
+  });
+}
+
+}  // namespace bustub
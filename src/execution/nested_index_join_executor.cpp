@@ -19,8 +19,7 @@ namespace bustub {
     NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                                  std::unique_ptr<AbstractExecutor> &&child_executor)
         : AbstractExecutor(exec_ctx), plan_(plan), child_exe_(std::move(child_executor)),
-          tree_{dynamic_cast<BPlusTreeIndexForTwoIntegerColumn *>(exec_ctx_->GetCatalog()->GetIndex(
-              plan_->GetIndexOid())->index_.get())} {
+          index_{exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid())->index_.get()} {
         if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
             // Note for 2023 Spring: You ONLY need to implement left join and inner join.
             throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
@@ -29,6 +28,7 @@ namespace bustub {
 
     void NestIndexJoinExecutor::Init() {
         child_exe_->Init();
+        pending_.clear();
     }
 
     auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
@@ -36,13 +36,19 @@ namespace bustub {
         RID r;
         auto index_info = exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid());
         auto expr = dynamic_cast<const ColumnValueExpression *>( plan_->KeyPredicate().get());
-        while (child_exe_->Next(&t, &r)) {
+        while (pending_.empty()) {
+            if (!child_exe_->Next(&t, &r)) {
+                return false;
+            }
             auto key = t.GetValue(&child_exe_->GetOutputSchema(), expr->GetColIdx());
             std::vector<RID> result;
             Tuple key_tuple = Tuple({key}, &exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid())->key_schema_);
-            tree_->ScanKey(key_tuple, &result, exec_ctx_->GetTransaction());
+            index_->ScanKey(key_tuple, &result, exec_ctx_->GetTransaction());
             for (auto &pair: result) {
                 auto res = index_info->table_->GetTuple(pair);
+                if (res.first.is_deleted_) {
+                    continue;
+                }
                 std::vector<Value> values;
                 values.reserve(
                     plan_->InnerTableSchema().GetColumnCount() + child_exe_->GetOutputSchema().GetColumnCount());
@@ -52,10 +58,9 @@ namespace bustub {
                 for (size_t i = 0; i < plan_->InnerTableSchema().GetColumnCount(); i++) {
                     values.push_back(res.second.GetValue(&plan_->InnerTableSchema(), i));
                 }
-                *tuple = Tuple{values, &GetOutputSchema()};
-                return true;
+                pending_.emplace_back(values, &GetOutputSchema());
             }
-            if (plan_->GetJoinType() == JoinType::LEFT) {
+            if (pending_.empty() && plan_->GetJoinType() == JoinType::LEFT) {
                 std::vector<Value> values;
                 values.reserve(
                     plan_->InnerTableSchema().GetColumnCount() + child_exe_->GetOutputSchema().GetColumnCount());
@@ -66,11 +71,12 @@ namespace bustub {
                     values.push_back(
                         ValueFactory::GetNullValueByType(plan_->InnerTableSchema().GetColumn(i).GetType()));
                 }
-                *tuple = Tuple{values, &GetOutputSchema()};
-                return true;
+                pending_.emplace_back(values, &GetOutputSchema());
             }
         }
-        return false;
+        *tuple = std::move(pending_.front());
+        pending_.pop_front();
+        return true;
     }
 
 }  // namespace bustub
@@ -30,6 +30,8 @@ namespace bustub {
 
 	void NestedLoopJoinExecutor::Init() {
 		left_executor_->Init();
+		predicate_ = CompiledPredicate::CompileJoin(plan_->Predicate(), left_executor_->GetOutputSchema(),
+													right_executor_->GetOutputSchema());
 	}
 
 	auto NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
@@ -45,10 +47,7 @@ namespace bustub {
 			}
 			for (int rdx = right_idx == -1 ? 0 : right_idx; rdx < int(right_tuple_.size()); rdx++) {
 
-				auto value = plan_->Predicate()->EvaluateJoin(&left_tuple_, left_executor_->GetOutputSchema(),
-															  &right_tuple_[rdx],
-															  right_executor_->GetOutputSchema());
-				if (!value.IsNull() && value.GetAs<bool>()) {
+				if (predicate_.MatchesJoin(&left_tuple_, &right_tuple_[rdx])) {
 
 					std::vector<Value> values;
 					for (uint32_t i = 0; i < left_executor_->GetOutputSchema().GetColumnCount(); ++i) {
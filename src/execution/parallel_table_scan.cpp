@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_table_scan.cpp
+//
+// Identification: src/execution/parallel_table_scan.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/parallel_table_scan.h"
+
+#include <algorithm>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "storage/page/table_page.h"
+
+namespace bustub {
+
+ParallelTableScan::ParallelTableScan(TableHeap *table, const CompiledPredicate *filter, size_t num_threads,
+                                     const ScanProjection *projection, const ZoneMapFilter *zone_filter,
+                                     const std::vector<RuntimeFilterProbe> *runtime_filters)
+    : table_(table),
+      filter_(filter),
+      projection_(projection),
+      zone_filter_(zone_filter),
+      runtime_filters_(runtime_filters),
+      num_threads_(std::max<size_t>(1, num_threads)),
+      scheduler_(TaskScheduler::Current()) {
+  BUSTUB_ASSERT(runtime_filters_ == nullptr || projection_ != nullptr, "runtime filters read the projection's schema");
+  std::unique_lock<std::mutex> guard(table_->latch_);
+  page_id_t last_page_id = table_->last_page_id_;
+  guard.unlock();
+
+  for (page_id_t page_id = table_->first_page_id_; page_id != INVALID_PAGE_ID;) {
+    auto page_guard = table_->bpm_->FetchPageRead(page_id);
+    auto page = page_guard.As<TablePage>();
+    page_ids_.push_back(page_id);
+    if (page_id == last_page_id) {
+      last_page_tuples_ = page->GetNumTuples();
+      break;
+    }
+    page_id = page->GetNextPageId();
+  }
+}
+
+template <typename Predicate>
+void ParallelTableScan::HelpUntil(std::unique_lock<std::mutex> *lock, const Predicate &done) {
+  while (!done()) {
+    lock->unlock();
+    if (!scheduler_->RunOne()) {
+      std::this_thread::yield();
+    }
+    lock->lock();
+  }
+}
+
+ParallelTableScan::~ParallelTableScan() {
+  std::unique_lock<std::mutex> lock(latch_);
+  stop_ = true;
+  // the tasks use this scan until they end
+  HelpUntil(&lock, [&] { return num_tasks_ == 0; });
+}
+
+void ParallelTableScan::ScanMorsel(size_t morsel, Slot *slot) const {
+  const size_t end = std::min(page_ids_.size(), (morsel + 1) * MORSEL_PAGES);
+  for (size_t i = morsel * MORSEL_PAGES; i < end; i++) {
+    if (zone_filter_ != nullptr && *zone_filter_ && !table_->PageMayMatch(page_ids_[i], *zone_filter_)) {
+      continue;
+    }
+    auto page_guard = table_->bpm_->FetchPageRead(page_ids_[i]);
+    auto page = page_guard.As<TablePage>();
+    uint32_t num_tuples = i + 1 == page_ids_.size() ? last_page_tuples_ : page->GetNumTuples();
+    for (uint32_t slot_num = 0; slot_num < num_tuples; slot_num++) {
+      RID rid{page_ids_[i], slot_num};
+      // filter in place, only the rows produced are copied out of the page
+      auto [meta, view] = page->GetTupleView(rid);
+      if (meta.is_deleted_ || (filter_->IsValid() && !filter_->Matches(&view)) ||
+          (runtime_filters_ != nullptr &&
+           !RuntimeFilterProbe::AllMayMatch(*runtime_filters_, view, *projection_->table_schema_))) {
+        continue;
+      }
+      slot->tuples_.push_back(projection_ != nullptr ? projection_->Materialize(view) : view.ToTuple());
+      slot->rids_.push_back(rid);
+    }
+  }
+}
+
+void ParallelTableScan::SpawnTasks() {
+  const size_t end = std::min(NumMorsels(), next_gathered_ + slots_.size());
+  while (!stop_ && num_tasks_ < num_threads_ && next_morsel_ + num_tasks_ < end) {
+    num_tasks_++;
+    scheduler_->Submit([this] { Work(); });
+  }
+}
+
+void ParallelTableScan::Work() {
+  while (true) {
+    size_t morsel;
+    {
+      std::scoped_lock lock(latch_);
+      if (stop_ || next_morsel_ >= std::min(NumMorsels(), next_gathered_ + slots_.size())) {
+        // the last access to this scan, which may be destroyed right after
+        num_tasks_--;
+        return;
+      }
+      morsel = next_morsel_++;
+    }
+    Slot slot;
+    try {
+      ScanMorsel(morsel, &slot);
+    } catch (...) {
+      std::scoped_lock lock(latch_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      stop_ = true;
+      num_tasks_--;
+      return;
+    }
+    slot.ready_ = true;
+    std::scoped_lock lock(latch_);
+    slots_[morsel % slots_.size()] = std::move(slot);
+  }
+}
+
+auto ParallelTableScan::Next(std::vector<Tuple> *tuples, std::vector<RID> *rids) -> bool {
+  tuples->clear();
+  rids->clear();
+  if (next_gathered_ >= NumMorsels()) {
+    return false;
+  }
+  if (scheduler_ == nullptr || num_threads_ == 1) {
+    Slot slot;
+    ScanMorsel(next_gathered_++, &slot);
+    tuples->swap(slot.tuples_);
+    rids->swap(slot.rids_);
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lock(latch_);
+  if (slots_.empty()) {
+    slots_.resize(num_threads_ * WINDOW_PER_THREAD);
+  }
+  SpawnTasks();
+  auto &slot = slots_[next_gathered_ % slots_.size()];
+  HelpUntil(&lock, [&] { return error_ != nullptr || slot.ready_; });
+  if (error_ != nullptr) {
+    std::rethrow_exception(error_);
+  }
+  tuples->swap(slot.tuples_);
+  rids->swap(slot.rids_);
+  slot = Slot{};
+  next_gathered_++;
+  SpawnTasks();
+  return true;
+}
+
+}  // namespace bustub
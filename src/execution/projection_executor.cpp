@@ -8,29 +8,38 @@ ProjectionExecutor::ProjectionExecutor(ExecutorContext *exec_ctx, const Projecti
     : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
 void ProjectionExecutor::Init() {
+  ResetBatch();
   // Initialize the child executor
   child_executor_->Init();
 }
 
-auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  Tuple child_tuple{};
+auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
 
-  // Get the next tuple
-  const auto status = child_executor_->Next(&child_tuple, rid);
-
-  if (!status) {
+auto ProjectionExecutor::NextBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size) -> bool {
+  tuples->clear();
+  rids->clear();
+  if (!child_executor_->NextBatch(&child_tuples_, &child_rids_, batch_size)) {
     return false;
   }
 
-  // Compute expressions
+  // Compute every expression over the whole batch, then stitch the columns back into tuples
+  const auto &child_schema = child_executor_->GetOutputSchema();
+  const auto &exprs = plan_->GetExpressions();
+  columns_.resize(exprs.size());
+  for (size_t col = 0; col < exprs.size(); col++) {
+    exprs[col]->EvaluateBatch(child_tuples_, child_schema, &columns_[col]);
+  }
+  tuples->reserve(child_tuples_.size());
   std::vector<Value> values{};
-  values.reserve(GetOutputSchema().GetColumnCount());
-  for (const auto &expr : plan_->GetExpressions()) {
-    values.push_back(expr->Evaluate(&child_tuple, child_executor_->GetOutputSchema()));
+  values.reserve(exprs.size());
+  for (size_t row = 0; row < child_tuples_.size(); row++) {
+    values.clear();
+    for (const auto &column : columns_) {
+      values.push_back(column.GetValue(row));
+    }
+    tuples->emplace_back(values, &GetOutputSchema());
   }
-
-  *tuple = Tuple{values, &GetOutputSchema()};
-
+  *rids = child_rids_;
   return true;
 }
 }  // namespace bustub
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.cpp
+//
+// Identification: src/execution/runtime_filter.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/runtime_filter.h"
+
+#include <algorithm>
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto IsIntegral(TypeId type) -> bool {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+}
+
+auto IntegerOf(const Value &val) -> int64_t {
+  switch (val.GetTypeId()) {
+    case TypeId::TINYINT:
+      return val.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return val.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return val.GetAs<int32_t>();
+    default:
+      return val.GetAs<int64_t>();
+  }
+}
+
+}  // namespace
+
+auto RuntimeFilter::SupportsTypes(TypeId build_type, TypeId probe_type) -> bool {
+  // integers of every width hash alike; decimals do not (0.0 == -0.0), so they are left out
+  if (IsIntegral(build_type) && IsIntegral(probe_type)) {
+    return true;
+  }
+  return build_type == probe_type && (build_type == TypeId::BOOLEAN || build_type == TypeId::VARCHAR);
+}
+
+auto RuntimeFilter::HashKey(const std::vector<Value> &key) -> std::optional<hash_t> {
+  // HashUtil::HashValue folds integers with a few shifts, which collides too often for a Bloom filter: integers of
+  // any width are mixed as int64 instead
+  hash_t hash = 0;
+  for (const auto &val : key) {
+    if (val.IsNull()) {
+      return std::nullopt;
+    }
+    hash_t val_hash = IsIntegral(val.GetTypeId()) ? static_cast<hash_t>(IntegerOf(val)) : HashUtil::HashValue(&val);
+    hash = HashUtil::MixHash(hash ^ (val_hash + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2)));
+  }
+  return hash;
+}
+
+auto RuntimeFilter::BitsOf(hash_t hash) -> uint64_t {
+  return (uint64_t{1} << (hash & 63)) | (uint64_t{1} << ((hash >> 6) & 63)) | (uint64_t{1} << ((hash >> 12) & 63)) |
+         (uint64_t{1} << ((hash >> 18) & 63));
+}
+
+void RuntimeFilter::Insert(const std::vector<Value> &key) {
+  auto hash = HashKey(key);
+  if (!hash.has_value()) {
+    return;
+  }
+  num_keys_++;
+  pending_.push_back(*hash);
+  integral_ = integral_ && key.size() == 1 && IsIntegral(key[0].GetTypeId());
+  if (integral_) {
+    auto val = IntegerOf(key[0]);
+    min_ = std::min(min_, val);
+    max_ = std::max(max_, val);
+  }
+}
+
+void RuntimeFilter::Seal() {
+  words_.assign(num_keys_ == 0 ? 0 : (num_keys_ * BITS_PER_KEY + 63) / 64, 0);
+  for (auto hash : pending_) {
+    // the high half of the hash picks the word, the low bits the bits in it
+    words_[((hash >> 32) * words_.size()) >> 32] |= BitsOf(hash);
+  }
+  pending_ = {};
+}
+
+auto RuntimeFilter::MayContain(const std::vector<Value> &key) const -> bool {
+  if (words_.empty()) {
+    return false;
+  }
+  if (integral_) {
+    auto val = key[0].IsNull() ? 0 : IntegerOf(key[0]);
+    if (val < min_ || val > max_) {
+      return false;
+    }
+  }
+  auto hash = HashKey(key);
+  if (!hash.has_value()) {
+    return false;
+  }
+  auto bits = BitsOf(*hash);
+  return (words_[((*hash >> 32) * words_.size()) >> 32] & bits) == bits;
+}
+
+auto RuntimeFilter::GetRange() const -> std::optional<std::pair<int64_t, int64_t>> {
+  if (!integral_ || num_keys_ == 0) {
+    return std::nullopt;
+  }
+  return std::make_pair(min_, max_);
+}
+
+auto RuntimeFilterProbe::MayMatch(const TupleView &row, const Schema &schema) const -> bool {
+  std::vector<Value> key;
+  key.reserve(columns_.size());
+  for (auto col : columns_) {
+    key.push_back(row.GetValue(&schema, col));
+  }
+  return filter_->MayContain(key);
+}
+
+auto RuntimeFilterProbe::MakeZoneMapFilter(const ZoneMap::Layout &layout) const -> ZoneMapFilter {
+  if (filter_->NumKeys() == 0) {
+    // an empty build side matches nothing
+    return [](const ZoneMap &) { return false; };
+  }
+  auto range = filter_->GetRange();
+  if (!range.has_value() || !layout.IsTracked(columns_[0])) {
+    return nullptr;
+  }
+  return [col = columns_[0], lo = ValueFactory::GetBigIntValue(range->first),
+          hi = ValueFactory::GetBigIntValue(range->second)](const ZoneMap &zone_map) {
+    return zone_map.MayBeGreater(col, lo, true) && zone_map.MayBeLess(col, hi, true);
+  };
+}
+
+}  // namespace bustub
@@ -1,103 +1,159 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-	SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(
-		exec_ctx), plan_(plan) {
-	}
-
-	void SeqScanExecutor::Init() {
-		auto table_info = GetExecutorContext()->GetCatalog()->GetTable(plan_->GetTableOid());
-		auto lock_mode = LockManager::LockMode::INTENTION_SHARED;
-		if (GetExecutorContext()->IsDelete())lock_mode = LockManager::LockMode::INTENTION_EXCLUSIVE;
-		try {
-			if (exec_ctx_->GetTransaction()->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED) {
-				exec_ctx_->GetLockManager()->LockTable(GetExecutorContext()->GetTransaction(),
-													   lock_mode, table_info->oid_);
-
-			}
-			iter_.emplace(table_info->table_->MakeEagerIterator());
-		} catch (const TransactionAbortException &e) {
-			LOG_ERROR("TransactionAbortException: %s", e.what());
-			throw ExecutionException("lock failed");
-		}
-
-	}
-
-	auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-		// 加锁，不满足的解锁
-		auto lock_mode = LockManager::LockMode::SHARED;
-		if (GetExecutorContext()->IsDelete()) {  // 假设已实现GetIsDelete
-			lock_mode = LockManager::LockMode::EXCLUSIVE;
-		}
-		auto table_info = GetExecutorContext()->GetCatalog()->GetTable(plan_->GetTableOid());
-
-		while (!iter_->IsEnd()) {
-			if (iter_->GetTuple().first.is_deleted_) {
-				++(*iter_);
-				continue;
-			}
-
-			try {
-				bool res = true;
-				if (exec_ctx_->GetTransaction()->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED ||
-					lock_mode != LockManager::LockMode::SHARED)
-					res = exec_ctx_->GetLockManager()->LockRow(exec_ctx_->GetTransaction(),
-															   lock_mode,
-															   table_info->oid_,
-															   iter_->GetRID());
-
-				if (res) {
-					if (plan_->filter_predicate_ != nullptr) {
-						auto t = iter_->GetTuple().second;
-						auto value = plan_->filter_predicate_->Evaluate(&t, table_info->schema_);
-						if (!value.IsNull() && value.GetAs<bool>()) {
-							*tuple = iter_->GetTuple().second;
-							*rid = iter_->GetRID();
-//							UnlockRowIfRequired(exec_ctx_->GetTransaction(), table_info->oid_, iter_->GetRID());
-							++(*iter_);
-							return true;
-						} else {
-							if (!exec_ctx_->GetLockManager()->UnlockRow(exec_ctx_->GetTransaction(), table_info->oid_,
-																		iter_->GetRID(), true)) {
-								LOG_ERROR("TransactionAbortException failed");
-								throw ExecutionException("SeqScan Executor Get Table ULock Failed");
-							}
-							++(*iter_);
-						}
-					} else {
-						*tuple = iter_->GetTuple().second;
-						*rid = iter_->GetRID();
-//						UnlockRowIfRequired(exec_ctx_->GetTransaction(), table_info->oid_, iter_->GetRID());
-						++(*iter_);
-
-						return true;
-					}
-				} else {
-					throw ExecutionException("SeqScan Executor Get Table Lock Failed");
-				}
-
-			} catch (TransactionAbortException &e) {
-				LOG_ERROR("TransactionAbortException: %s", e.GetInfo().c_str());
-				throw ExecutionException("SeqScan Executor TransactionAbortException: " + std::string(e.what()));
-			} catch (...) {
-
-				throw ExecutionException("SeqScan Executor Unknown Exception");
-			}
-		}
-		return false;
-	}
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+
+namespace bustub {
+
+	SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(
+		exec_ctx), plan_(plan) {
+	}
+
+	void SeqScanExecutor::Init() {
+		ResetBatch();
+		table_info_ = GetExecutorContext()->GetCatalog()->GetTable(plan_->GetTableOid());
+		auto table_info = table_info_;
+		zone_filter_ = nullptr;
+		runtime_filters_.clear();
+		if (plan_->filter_predicate_ != nullptr) {
+			filter_ = CompiledPredicate::Compile(plan_->filter_predicate_, table_info_->schema_);
+			if (const auto *layout = table_info_->table_->GetZoneMapLayout(); layout != nullptr) {
+				zone_filter_ = CompileZoneMapFilter(plan_->filter_predicate_, table_info_->schema_, *layout);
+			}
+		}
+		projection_ = ScanProjection{&table_info_->schema_, &plan_->OutputSchema(), plan_->column_ids_};
+		auto lock_mode = LockManager::LockMode::INTENTION_SHARED;
+		if (GetExecutorContext()->IsDelete())lock_mode = LockManager::LockMode::INTENTION_EXCLUSIVE;
+		try {
+			if (exec_ctx_->GetTransaction()->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED) {
+				exec_ctx_->GetLockManager()->LockTable(GetExecutorContext()->GetTransaction(),
+													   lock_mode, table_info->oid_);
+
+			}
+			scan_.reset();
+			iter_.reset();
+			gathered_tuples_.clear();
+			gathered_rids_.clear();
+			gathered_pos_ = 0;
+			if (exec_ctx_->GetNumThreads() > 1) {
+				scan_ = std::make_unique<ParallelTableScan>(table_info->table_.get(), &filter_,
+															exec_ctx_->GetNumThreads(), &projection_, &zone_filter_,
+															&runtime_filters_);
+				if (scan_->NumMorsels() <= 1) {
+					scan_.reset();
+				}
+			}
+			if (scan_ == nullptr) {
+				iter_.emplace(table_info->table_->MakeEagerIterator());
+			}
+		} catch (const TransactionAbortException &e) {
+			LOG_ERROR("TransactionAbortException: %s", e.what());
+			throw ExecutionException("lock failed");
+		}
+
+	}
+
+	auto SeqScanExecutor::PushRuntimeFilter(const RuntimeFilterProbe &probe) -> bool {
+		runtime_filters_.push_back(probe.OnTableColumns(plan_->column_ids_));
+		const auto *layout = table_info_->table_->GetZoneMapLayout();
+		if (layout == nullptr) {
+			return true;
+		}
+		if (auto pages = runtime_filters_.back().MakeZoneMapFilter(*layout); pages) {
+			if (zone_filter_) {
+				zone_filter_ = [filter = std::move(zone_filter_), pages = std::move(pages)](const ZoneMap &zone_map) {
+					return filter(zone_map) && pages(zone_map);
+				};
+			} else {
+				zone_filter_ = std::move(pages);
+			}
+		}
+		return true;
+	}
+
+	auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+		return NextFromBatch(tuple, rid);
+	}
+
+	auto SeqScanExecutor::NextBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size) -> bool {
+		tuples->clear();
+		rids->clear();
+		// 加锁，不满足的解锁
+		auto lock_mode = LockManager::LockMode::SHARED;
+		if (GetExecutorContext()->IsDelete()) {  // 假设已实现GetIsDelete
+			lock_mode = LockManager::LockMode::EXCLUSIVE;
+		}
+		bool need_lock = exec_ctx_->GetTransaction()->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED ||
+						 lock_mode != LockManager::LockMode::SHARED;
+		return GatherBatch(tuples, rids, batch_size, lock_mode, need_lock);
+	}
+
+	auto SeqScanExecutor::FillGathered() -> bool {
+		gathered_pos_ = 0;
+		if (scan_ != nullptr) {
+			return scan_->Next(&gathered_tuples_, &gathered_rids_);
+		}
+		gathered_tuples_.clear();
+		gathered_rids_.clear();
+		if (iter_->IsEnd()) {
+			return false;
+		}
+		// filter the page in place, only the needed columns of the matching rows are copied out of it
+		iter_->ScanPage([this](const TupleMeta &meta, const TupleView &view) {
+			if (meta.is_deleted_ || (filter_.IsValid() && !filter_.Matches(&view)) ||
+				!RuntimeFilterProbe::AllMayMatch(runtime_filters_, view, table_info_->schema_)) {
+				return;
+			}
+			gathered_tuples_.push_back(projection_.Materialize(view));
+			gathered_rids_.push_back(view.GetRid());
+		}, &zone_filter_);
+		return true;
+	}
+
+	auto SeqScanExecutor::GatherBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size,
+									  LockManager::LockMode lock_mode, bool need_lock) -> bool {
+		auto *txn = exec_ctx_->GetTransaction();
+		auto *lock_manager = exec_ctx_->GetLockManager();
+		while (tuples->size() < batch_size) {
+			if (gathered_pos_ == gathered_rids_.size()) {
+				if (!FillGathered()) {
+					break;
+				}
+				continue;
+			}
+			size_t i = gathered_pos_++;
+			RID rid = gathered_rids_[i];
+			if (need_lock) {
+				try {
+					if (!lock_manager->LockRow(txn, lock_mode, table_info_->oid_, rid)) {
+						throw ExecutionException("SeqScan Executor Get Table Lock Failed");
+					}
+					// the row was read before it was locked. Tuples are never changed in place, updates delete and
+					// re-insert them, so only the meta may have changed since
+					if (table_info_->table_->GetTupleMeta(rid).is_deleted_) {
+						if (!lock_manager->UnlockRow(txn, table_info_->oid_, rid, true)) {
+							throw ExecutionException("SeqScan Executor Get Table ULock Failed");
+						}
+						continue;
+					}
+				} catch (TransactionAbortException &e) {
+					LOG_ERROR("TransactionAbortException: %s", e.GetInfo().c_str());
+					throw ExecutionException("SeqScan Executor TransactionAbortException: " + std::string(e.what()));
+				}
+			}
+			rids->push_back(rid);
+			tuples->push_back(std::move(gathered_tuples_[i]));
+		}
+		return !tuples->empty();
+	}
+
+}  // namespace bustub
@@ -1,5 +1,7 @@
 #include "execution/executors/sort_executor.h"
 
+#include "execution/sort_key.h"
+
 namespace bustub {
 
     SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
@@ -8,55 +10,30 @@ namespace bustub {
 
     void SortExecutor::Init() {
         child_executor_->Init();
-        Tuple t;
-        RID r;
-        tuples.clear();
-        while (child_executor_->Next(&t, &r)) {
-            tuples.push_back(t);
+        // release the temp pages of a previous run before gathering the new one
+        sorter_.reset();
+        sorter_ = std::make_unique<ExternalSorter>(exec_ctx_->GetBufferPoolManager(), exec_ctx_->GetMemoryLimit(),
+                                                   exec_ctx_->GetNumThreads());
+        SortKeyEncoder encoder(plan_->GetOrderBy(), &child_executor_->GetOutputSchema());
+
+        std::vector<Tuple> batch;
+        std::vector<RID> rids;
+        while (child_executor_->NextBatch(&batch, &rids, BUSTUB_BATCH_SIZE)) {
+            for (auto &t : batch) {
+                std::string key;
+                encoder.Encode(t, &key);
+                sorter_->Add(std::move(key), std::move(t));
+            }
         }
-        std::sort(tuples.begin(), tuples.end(),
-                  [&](const Tuple &a,
-                      const Tuple &b) {
-
-                      for (const auto &expr: plan_->GetOrderBy()) {
-                          if (expr.first == OrderByType::ASC || expr.first == OrderByType::DEFAULT) {
-                              if (static_cast<bool>(expr.second->Evaluate(&a,
-                                                                          child_executor_->GetOutputSchema()).CompareLessThan(
-                                  expr.second->Evaluate(&b, child_executor_->GetOutputSchema()))))
-                                  return true;
-                              else if (static_cast<bool>(expr.second->Evaluate(&a,
-                                                                               child_executor_->GetOutputSchema()).CompareGreaterThan(
-                                  expr.second->Evaluate(&b, child_executor_->GetOutputSchema())))) {
-                                  return false;
-                              }
-                          }
-                          if (expr.first == OrderByType::DESC) {
-                              if (static_cast<bool>(expr.second->Evaluate(&a,
-                                                                          child_executor_->GetOutputSchema()).CompareLessThan(
-                                  expr.second->Evaluate(&b, child_executor_->GetOutputSchema()))))
-                                  return false;
-                              else if (static_cast<bool>(expr.second->Evaluate(&a,
-                                                                               child_executor_->GetOutputSchema()).CompareGreaterThan(
-                                  expr.second->Evaluate(&b, child_executor_->GetOutputSchema())))) {
-                                  return true;
-                              }
-                          }
-
-                      }
-                      return false;
-                  });
-
-        iter = tuples.begin();
+        sorter_->Finish();
     }
 
     auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-        if (iter != tuples.end()) {
-            *tuple = (*iter);
-            *rid = (*iter).GetRid();
-            iter++;
-            return true;
+        if (!sorter_->Next(tuple)) {
+            return false;
         }
-        return false;
+        *rid = tuple->GetRid();
+        return true;
     }
 
 }  // namespace bustub
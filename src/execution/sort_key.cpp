@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.cpp
+//
+// Identification: src/execution/sort_key.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/sort_key.h"
+
+#include <cstring>
+
+#include "common/macros.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+template <typename T>
+void AppendBigEndian(T val, std::string *key) {
+  for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8) {
+    key->push_back(static_cast<char>((val >> shift) & 0xff));
+  }
+}
+
+/** Flips the sign bit so that two's complement integers compare as unsigned ones */
+template <typename S, typename U>
+void AppendSigned(S val, std::string *key) {
+  AppendBigEndian<U>(static_cast<U>(val) ^ (static_cast<U>(1) << (sizeof(U) * 8 - 1)), key);
+}
+
+template <typename T>
+auto ReadBigEndian(const char **data) -> T {
+  T val = 0;
+  for (size_t i = 0; i < sizeof(T); i++) {
+    val = static_cast<T>(val << 8) | static_cast<uint8_t>(*(*data)++);
+  }
+  return val;
+}
+
+template <typename S, typename U>
+auto ReadSigned(const char **data) -> S {
+  return static_cast<S>(ReadBigEndian<U>(data) ^ (static_cast<U>(1) << (sizeof(U) * 8 - 1)));
+}
+
+}  // namespace
+
+void SortKeyEncoder::Encode(const Tuple &tuple, std::string *key) const {
+  for (const auto &[type, expr] : order_bys_) {
+    EncodeValue(expr->Evaluate(&tuple, *schema_), type == OrderByType::DESC, key);
+  }
+}
+
+void SortKeyEncoder::EncodeValue(const Value &val, bool descending, std::string *key) {
+  const size_t begin = key->size();
+  if (val.IsNull()) {
+    key->push_back('\0');
+  } else {
+    key->push_back('\1');
+    switch (val.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        AppendSigned<int8_t, uint8_t>(val.GetAs<int8_t>(), key);
+        break;
+      case TypeId::SMALLINT:
+        AppendSigned<int16_t, uint16_t>(val.GetAs<int16_t>(), key);
+        break;
+      case TypeId::INTEGER:
+        AppendSigned<int32_t, uint32_t>(val.GetAs<int32_t>(), key);
+        break;
+      case TypeId::BIGINT:
+        AppendSigned<int64_t, uint64_t>(val.GetAs<int64_t>(), key);
+        break;
+      case TypeId::DECIMAL: {
+        // -0.0 equals 0.0, give both the same encoding
+        double d = val.GetAs<double>() == 0 ? 0 : val.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &d, sizeof(bits));
+        // negative numbers compare reversed as unsigned, flip all of their bits; positive ones only the sign bit
+        bits = (bits >> 63) != 0 ? ~bits : bits | (static_cast<uint64_t>(1) << 63);
+        AppendBigEndian<uint64_t>(bits, key);
+        break;
+      }
+      case TypeId::TIMESTAMP:
+        AppendBigEndian<uint64_t>(val.GetAs<uint64_t>(), key);
+        break;
+      case TypeId::VARCHAR: {
+        // the stored length counts the trailing '\0'
+        const char *data = val.GetData();
+        const uint32_t len = val.GetLength() - 1;
+        for (uint32_t i = 0; i < len; i++) {
+          key->push_back(data[i]);
+          if (data[i] == '\0') {
+            key->push_back('\xff');
+          }
+        }
+        key->append(2, '\0');
+        break;
+      }
+      default:
+        UNREACHABLE("cannot sort on this type");
+    }
+  }
+  if (descending) {
+    for (size_t i = begin; i < key->size(); i++) {
+      (*key)[i] = static_cast<char>(~(*key)[i]);
+    }
+  }
+}
+
+auto SortKeyEncoder::DecodeValue(TypeId type, const char **data) -> Value {
+  if (*(*data)++ == '\0') {
+    return ValueFactory::GetNullValueByType(type);
+  }
+  switch (type) {
+    case TypeId::BOOLEAN:
+      return {type, ReadSigned<int8_t, uint8_t>(data)};
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(ReadSigned<int8_t, uint8_t>(data));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(ReadSigned<int16_t, uint16_t>(data));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(ReadSigned<int32_t, uint32_t>(data));
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(ReadSigned<int64_t, uint64_t>(data));
+    case TypeId::DECIMAL: {
+      auto bits = ReadBigEndian<uint64_t>(data);
+      bits = (bits >> 63) != 0 ? bits & ~(static_cast<uint64_t>(1) << 63) : ~bits;
+      double d;
+      memcpy(&d, &bits, sizeof(d));
+      return ValueFactory::GetDecimalValue(d);
+    }
+    case TypeId::TIMESTAMP:
+      return {type, ReadBigEndian<uint64_t>(data)};
+    case TypeId::VARCHAR: {
+      std::string str;
+      // an escaped 0x00 is followed by 0xff, the terminator by 0x00
+      for (; (*data)[0] != '\0' || (*data)[1] != '\0'; (*data)++) {
+        str.push_back(**data);
+        if (**data == '\0') {
+          (*data)++;
+        }
+      }
+      *data += 2;
+      return ValueFactory::GetVarcharValue(str);
+    }
+    default:
+      UNREACHABLE("cannot sort on this type");
+  }
+}
+
+}  // namespace bustub
@@ -1,5 +1,8 @@
 #include "execution/executors/topn_executor.h"
 
+#include "common/util/parallel_sort.h"
+#include "execution/sort_key.h"
+
 namespace bustub {
 
     TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
@@ -8,81 +11,52 @@ namespace bustub {
 
     void TopNExecutor::Init() {
         child_executor_->Init();
-        Tuple t;
-        RID r;
-        auto cmp = [&](const Tuple &a, const Tuple &b) {
-            for (auto &expr: plan_->GetOrderBy()) {
-                switch (expr.first) {
-                    case OrderByType::ASC:
-                        if (static_cast<bool>(expr.second->Evaluate(&a, plan_->OutputSchema()).
-                            CompareLessThan(expr.second->Evaluate(&b, plan_->OutputSchema())))) {
-                            return true;
-                        }
-                        if (static_cast<bool>(expr.second->Evaluate(&a, plan_->OutputSchema()).
-                            CompareGreaterThan(expr.second->Evaluate(&b, plan_->OutputSchema())))) {
-                            return false;
-                        }
-                        break;
-                    case OrderByType::DEFAULT:
-                        if (static_cast<bool>(expr.second->Evaluate(&a, plan_->OutputSchema()).
-                            CompareLessThan(expr.second->Evaluate(&b, plan_->OutputSchema())))) {
-                            return true;
-                        }
-                        if (static_cast<bool>(expr.second->Evaluate(&a, plan_->OutputSchema()).
-                            CompareGreaterThan(expr.second->Evaluate(&b, plan_->OutputSchema())))) {
-                            return false;
-                        }
-                        break;
-                    case OrderByType::INVALID:
-                    case OrderByType::DESC:
-                        if (static_cast<bool>(expr.second->Evaluate(&a, plan_->OutputSchema()).
-                            CompareLessThan(expr.second->Evaluate(&b, plan_->OutputSchema())))) {
-                            return false;
-                        }
-                        if (static_cast<bool>(expr.second->Evaluate(&a, plan_->OutputSchema()).
-                            CompareGreaterThan(expr.second->Evaluate(&b, plan_->OutputSchema())))) {
-                            return true;
-                        }
-                        break;
+        entries_.clear();
+        num_in_heap_ = 0;
+        cursor_ = 0;
+        const size_t n = plan_->GetN();
+        SortKeyEncoder encoder(plan_->GetOrderBy(), &child_executor_->GetOutputSchema());
+
+        std::vector<Tuple> batch;
+        std::vector<RID> rids;
+        std::string key;
+        while (child_executor_->NextBatch(&batch, &rids, BUSTUB_BATCH_SIZE)) {
+            for (auto &t: batch) {
+                key.clear();
+                encoder.Encode(t, &key);
+                // on equal keys the earlier row wins, so a row has to beat the current N-th one
+                if (num_in_heap_ == n && (n == 0 || key >= entries_[n - 1].key_)) {
+                    continue;
                 }
+                entries_.push_back({key, std::move(t)});
             }
-            return false;
-        };
-        std::priority_queue<Tuple, std::vector<Tuple>, decltype(cmp)> pq(cmp);
-        while (child_executor_->Next(&t, &r)) {
-            if (pq.size() == plan_->GetN()) {
-                auto u = pq.top();
-                if (cmp(t, u)) {
-                    pq.push(t);
-                    pq.pop();
-                }
-            } else if (pq.size() < plan_->GetN()) {
-                pq.push(t);
+            if (entries_.size() >= n + TOPN_BUFFER_ROWS) {
+                CutBack();
             }
         }
+        CutBack();
+    }
 
-        tuples.resize(pq.size());
-        auto i = int(pq.size()) - 1;
-        while (!pq.empty()) {
-            const auto &u = pq.top();
-            tuples[i--] = u;
-            pq.pop();
+    void TopNExecutor::CutBack() {
+        ParallelSort::Sort(
+            &entries_, [](const Entry &a, const Entry &b) { return a.key_ < b.key_; }, exec_ctx_->GetNumThreads());
+        if (entries_.size() > plan_->GetN()) {
+            entries_.resize(plan_->GetN());
         }
-        iter = tuples.begin();
+        num_in_heap_ = entries_.size();
     }
 
     auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-        if (iter != tuples.end()) {
-            *tuple = *iter;
+        if (cursor_ < entries_.size()) {
+            *tuple = entries_[cursor_++].tuple_;
             *rid = tuple->GetRid();
-            iter++;
             return true;
         }
         return false;
     }
 
     auto TopNExecutor::GetNumInHeap() -> size_t {
-        return tuples.size();
+        return num_in_heap_;
     };
 
 }  // namespace bustub
@@ -0,0 +1,398 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vector_kernels.cpp
+//
+// Identification: src/execution/vector_kernels.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/expressions/vector_kernels.h"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+#include "common/macros.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/logic_expression.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BUSTUB_AVX2_KERNELS
+#include <immintrin.h>
+#define BUSTUB_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace bustub {
+
+namespace {
+
+#ifdef BUSTUB_AVX2_KERNELS
+auto CpuHasAvx2() -> bool {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2") != 0;
+  return has_avx2;
+}
+#else
+auto CpuHasAvx2() -> bool { return false; }
+#endif
+
+std::atomic<bool> use_simd{CpuHasAvx2()};
+
+/*****************************************************************************
+ * Scalar kernels, also used for the tails the SIMD loops leave behind.
+ *****************************************************************************/
+
+template <ComparisonType OP, typename T>
+inline auto CompareOp(T a, T b) -> bool {
+  if constexpr (OP == ComparisonType::Equal) {
+    return a == b;
+  } else if constexpr (OP == ComparisonType::NotEqual) {
+    return a != b;
+  } else if constexpr (OP == ComparisonType::LessThan) {
+    return a < b;
+  } else if constexpr (OP == ComparisonType::LessThanOrEqual) {
+    return a <= b;
+  } else if constexpr (OP == ComparisonType::GreaterThan) {
+    return a > b;
+  } else {
+    return a >= b;
+  }
+}
+
+/** out[i] = lhs[i] OP rhs[i], or lhs[i] OP rhs[0] when RHS_CONST */
+template <typename T, ComparisonType OP, bool RHS_CONST>
+void CompareScalar(const T *lhs, const T *rhs, size_t n, int8_t *out) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = static_cast<int8_t>(CompareOp<OP>(lhs[i], RHS_CONST ? rhs[0] : rhs[i]));
+  }
+}
+
+void ArithmeticScalar(const int32_t *lhs, const int32_t *rhs, size_t n, ArithmeticType op, int32_t *out) {
+  // wrap around on overflow like the per-tuple path does in practice, without the signed overflow UB
+  if (op == ArithmeticType::Plus) {
+    for (size_t i = 0; i < n; i++) {
+      out[i] = static_cast<int32_t>(static_cast<uint32_t>(lhs[i]) + static_cast<uint32_t>(rhs[i]));
+    }
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      out[i] = static_cast<int32_t>(static_cast<uint32_t>(lhs[i]) - static_cast<uint32_t>(rhs[i]));
+    }
+  }
+}
+
+void SelectScalar(const int8_t *values, const uint8_t *nulls, size_t begin, size_t n, SelectionVector *selection) {
+  for (size_t i = begin; i < n; i++) {
+    if (values[i] != 0 && (nulls == nullptr || nulls[i] == 0)) {
+      selection->push_back(static_cast<uint32_t>(i));
+    }
+  }
+}
+
+/*****************************************************************************
+ * AVX2 kernels. Comparisons produce a lane bitmask with movemask, which is
+ * expanded to one byte per row through a lookup table.
+ *****************************************************************************/
+
+#ifdef BUSTUB_AVX2_KERNELS
+
+/** BIT_TO_BYTES[m] has byte k set to 1 iff bit k of m is set */
+constexpr auto MakeBitToBytes() -> std::array<uint64_t, 256> {
+  std::array<uint64_t, 256> table{};
+  for (uint32_t m = 0; m < 256; m++) {
+    uint64_t bytes = 0;
+    for (uint32_t k = 0; k < 8; k++) {
+      if ((m >> k) & 1) {
+        bytes |= uint64_t{1} << (8 * k);
+      }
+    }
+    table[m] = bytes;
+  }
+  return table;
+}
+
+constexpr std::array<uint64_t, 256> BIT_TO_BYTES = MakeBitToBytes();
+
+template <size_t LANES>
+inline void StoreMask(uint32_t mask, int8_t *out) {
+  memcpy(out, &BIT_TO_BYTES[mask], LANES);
+}
+
+BUSTUB_AVX2_TARGET inline auto Load(const int32_t *p) -> __m256i {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+BUSTUB_AVX2_TARGET inline auto Load(const int64_t *p) -> __m256i {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+BUSTUB_AVX2_TARGET inline auto Load(const double *p) -> __m256d { return _mm256_loadu_pd(p); }
+BUSTUB_AVX2_TARGET inline auto Set1(int32_t v) -> __m256i { return _mm256_set1_epi32(v); }
+BUSTUB_AVX2_TARGET inline auto Set1(int64_t v) -> __m256i { return _mm256_set1_epi64x(v); }
+BUSTUB_AVX2_TARGET inline auto Set1(double v) -> __m256d { return _mm256_set1_pd(v); }
+
+/** Lane masks of a == b and a > b for the integer types, everything else is derived from those two */
+template <typename T>
+BUSTUB_AVX2_TARGET inline auto EqMask(__m256i a, __m256i b) -> uint32_t {
+  if constexpr (sizeof(T) == 4) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+  } else {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)));
+  }
+}
+
+template <typename T>
+BUSTUB_AVX2_TARGET inline auto GtMask(__m256i a, __m256i b) -> uint32_t {
+  if constexpr (sizeof(T) == 4) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b)));
+  } else {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b)));
+  }
+}
+
+template <typename T, ComparisonType OP>
+BUSTUB_AVX2_TARGET inline auto CompareMask(__m256i a, __m256i b) -> uint32_t {
+  constexpr uint32_t all = (1U << (32 / sizeof(T))) - 1;
+  if constexpr (OP == ComparisonType::Equal) {
+    return EqMask<T>(a, b);
+  } else if constexpr (OP == ComparisonType::NotEqual) {
+    return EqMask<T>(a, b) ^ all;
+  } else if constexpr (OP == ComparisonType::LessThan) {
+    return GtMask<T>(b, a);
+  } else if constexpr (OP == ComparisonType::LessThanOrEqual) {
+    return GtMask<T>(a, b) ^ all;
+  } else if constexpr (OP == ComparisonType::GreaterThan) {
+    return GtMask<T>(a, b);
+  } else {
+    return GtMask<T>(b, a) ^ all;
+  }
+}
+
+template <typename T, ComparisonType OP>
+BUSTUB_AVX2_TARGET inline auto CompareMask(__m256d a, __m256d b) -> uint32_t {
+  // ordered predicates, except != which has to be true for NaN like the scalar operator
+  if constexpr (OP == ComparisonType::Equal) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+  } else if constexpr (OP == ComparisonType::NotEqual) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_NEQ_UQ));
+  } else if constexpr (OP == ComparisonType::LessThan) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ));
+  } else if constexpr (OP == ComparisonType::LessThanOrEqual) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ));
+  } else if constexpr (OP == ComparisonType::GreaterThan) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ));
+  } else {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ));
+  }
+}
+
+template <typename T, ComparisonType OP, bool RHS_CONST>
+BUSTUB_AVX2_TARGET void CompareAvx2(const T *lhs, const T *rhs, size_t n, int8_t *out) {
+  constexpr size_t lanes = 32 / sizeof(T);
+  size_t i = 0;
+  if constexpr (RHS_CONST) {
+    const auto constant = Set1(rhs[0]);
+    for (; i + lanes <= n; i += lanes) {
+      StoreMask<lanes>(CompareMask<T, OP>(Load(lhs + i), constant), out + i);
+    }
+  } else {
+    for (; i + lanes <= n; i += lanes) {
+      StoreMask<lanes>(CompareMask<T, OP>(Load(lhs + i), Load(rhs + i)), out + i);
+    }
+  }
+  CompareScalar<T, OP, RHS_CONST>(lhs + i, RHS_CONST ? rhs : rhs + i, n - i, out + i);
+}
+
+BUSTUB_AVX2_TARGET void ArithmeticAvx2(const int32_t *lhs, const int32_t *rhs, size_t n, ArithmeticType op,
+                                       int32_t *out) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i res = op == ArithmeticType::Plus ? _mm256_add_epi32(Load(lhs + i), Load(rhs + i))
+                                             : _mm256_sub_epi32(Load(lhs + i), Load(rhs + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), res);
+  }
+  ArithmeticScalar(lhs + i, rhs + i, n - i, op, out + i);
+}
+
+BUSTUB_AVX2_TARGET void SelectAvx2(const int8_t *values, const uint8_t *nulls, size_t n, SelectionVector *selection) {
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+    auto bits = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero)));
+    if (nulls != nullptr) {
+      __m256i nv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(nulls + i));
+      bits &= static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(nv, zero)));
+    }
+    while (bits != 0) {
+      selection->push_back(static_cast<uint32_t>(i + __builtin_ctz(bits)));
+      bits &= bits - 1;
+    }
+  }
+  SelectScalar(values, nulls, i, n, selection);
+}
+
+#endif
+
+/*****************************************************************************
+ * Dispatch
+ *****************************************************************************/
+
+template <typename T, ComparisonType OP, bool RHS_CONST>
+void Compare(const T *lhs, const T *rhs, size_t n, int8_t *out) {
+#ifdef BUSTUB_AVX2_KERNELS
+  if constexpr (!std::is_same_v<T, int8_t>) {
+    if (use_simd.load(std::memory_order_relaxed)) {
+      CompareAvx2<T, OP, RHS_CONST>(lhs, rhs, n, out);
+      return;
+    }
+  }
+#endif
+  CompareScalar<T, OP, RHS_CONST>(lhs, rhs, n, out);
+}
+
+template <typename T, bool RHS_CONST>
+void Compare(const T *lhs, const T *rhs, size_t n, ComparisonType op, int8_t *out) {
+  switch (op) {
+    case ComparisonType::Equal:
+      return Compare<T, ComparisonType::Equal, RHS_CONST>(lhs, rhs, n, out);
+    case ComparisonType::NotEqual:
+      return Compare<T, ComparisonType::NotEqual, RHS_CONST>(lhs, rhs, n, out);
+    case ComparisonType::LessThan:
+      return Compare<T, ComparisonType::LessThan, RHS_CONST>(lhs, rhs, n, out);
+    case ComparisonType::LessThanOrEqual:
+      return Compare<T, ComparisonType::LessThanOrEqual, RHS_CONST>(lhs, rhs, n, out);
+    case ComparisonType::GreaterThan:
+      return Compare<T, ComparisonType::GreaterThan, RHS_CONST>(lhs, rhs, n, out);
+    case ComparisonType::GreaterThanOrEqual:
+      return Compare<T, ComparisonType::GreaterThanOrEqual, RHS_CONST>(lhs, rhs, n, out);
+    default:
+      UNREACHABLE("Unsupported comparison type.");
+  }
+}
+
+/** Runs the comparison over the storage type of `type`. @return false for types without a kernel */
+template <bool RHS_CONST>
+auto CompareTyped(TypeId type, const ColumnVector &lhs, const void *rhs, ComparisonType op, int8_t *out) -> bool {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      Compare<int8_t, RHS_CONST>(lhs.Data<int8_t>(), static_cast<const int8_t *>(rhs), lhs.Size(), op, out);
+      return true;
+    case TypeId::INTEGER:
+      Compare<int32_t, RHS_CONST>(lhs.Data<int32_t>(), static_cast<const int32_t *>(rhs), lhs.Size(), op, out);
+      return true;
+    case TypeId::BIGINT:
+      Compare<int64_t, RHS_CONST>(lhs.Data<int64_t>(), static_cast<const int64_t *>(rhs), lhs.Size(), op, out);
+      return true;
+    case TypeId::DECIMAL:
+      Compare<double, RHS_CONST>(lhs.Data<double>(), static_cast<const double *>(rhs), lhs.Size(), op, out);
+      return true;
+    default:
+      return false;
+  }
+}
+
+auto HasCompareKernel(TypeId type) -> bool {
+  return type == TypeId::BOOLEAN || type == TypeId::TINYINT || type == TypeId::INTEGER || type == TypeId::BIGINT ||
+         type == TypeId::DECIMAL;
+}
+
+}  // namespace
+
+auto CompareKernel(const ColumnVector &lhs, const ColumnVector &rhs, ComparisonType op, ColumnVector *result)
+    -> bool {
+  if (lhs.GetType() != rhs.GetType() || !HasCompareKernel(lhs.GetType())) {
+    return false;
+  }
+  BUSTUB_ASSERT(lhs.Size() == rhs.Size(), "Comparing vectors of different sizes.");
+  result->Reset(TypeId::BOOLEAN, lhs.Size());
+  CompareTyped<false>(lhs.GetType(), lhs, rhs.Data<uint8_t>(), op, result->Data<int8_t>());
+  result->MergeNulls(lhs, rhs);
+  return true;
+}
+
+auto CompareConstantKernel(const ColumnVector &lhs, const Value &rhs, ComparisonType op, ColumnVector *result)
+    -> bool {
+  if (lhs.GetType() != rhs.GetTypeId() || !HasCompareKernel(lhs.GetType())) {
+    return false;
+  }
+  result->Reset(TypeId::BOOLEAN, lhs.Size());
+  if (rhs.IsNull()) {
+    // comparing against NULL is NULL for every row
+    result->InitNulls();
+    memset(result->Nulls(), 1, lhs.Size());
+    return true;
+  }
+  alignas(8) std::array<char, 8> constant{};
+  Type::GetInstance(rhs.GetTypeId())->SerializeTo(rhs, constant.data());
+  CompareTyped<true>(lhs.GetType(), lhs, constant.data(), op, result->Data<int8_t>());
+  result->MergeNulls(lhs, lhs);
+  return true;
+}
+
+void ArithmeticKernel(const ColumnVector &lhs, const ColumnVector &rhs, ArithmeticType op, ColumnVector *result) {
+  BUSTUB_ASSERT(lhs.GetType() == TypeId::INTEGER && rhs.GetType() == TypeId::INTEGER, "Only integers for now.");
+  BUSTUB_ASSERT(lhs.Size() == rhs.Size(), "Computing on vectors of different sizes.");
+  result->Reset(TypeId::INTEGER, lhs.Size());
+#ifdef BUSTUB_AVX2_KERNELS
+  if (use_simd.load(std::memory_order_relaxed)) {
+    ArithmeticAvx2(lhs.Data<int32_t>(), rhs.Data<int32_t>(), lhs.Size(), op, result->Data<int32_t>());
+    result->MergeNulls(lhs, rhs);
+    return;
+  }
+#endif
+  ArithmeticScalar(lhs.Data<int32_t>(), rhs.Data<int32_t>(), lhs.Size(), op, result->Data<int32_t>());
+  result->MergeNulls(lhs, rhs);
+}
+
+void LogicKernel(const ColumnVector &lhs, const ColumnVector &rhs, LogicType op, ColumnVector *result) {
+  BUSTUB_ASSERT(lhs.GetType() == TypeId::BOOLEAN && rhs.GetType() == TypeId::BOOLEAN, "Expect boolean vectors.");
+  BUSTUB_ASSERT(lhs.Size() == rhs.Size(), "Combining vectors of different sizes.");
+  const size_t n = lhs.Size();
+  result->Reset(TypeId::BOOLEAN, n);
+  const int8_t *l = lhs.Data<int8_t>();
+  const int8_t *r = rhs.Data<int8_t>();
+  int8_t *out = result->Data<int8_t>();
+  const bool is_and = op == LogicType::And;
+  if (!lhs.HasNulls() && !rhs.HasNulls()) {
+    // branch-free so the compiler can vectorize it
+    for (size_t i = 0; i < n; i++) {
+      out[i] = static_cast<int8_t>(is_and ? ((l[i] != 0) & (r[i] != 0)) : ((l[i] != 0) | (r[i] != 0)));
+    }
+    return;
+  }
+  // three-valued logic: a false operand decides AND, a true operand decides OR, otherwise NULL wins
+  result->InitNulls();
+  uint8_t *nulls = result->Nulls();
+  for (size_t i = 0; i < n; i++) {
+    bool ln = lhs.IsNull(i);
+    bool rn = rhs.IsNull(i);
+    bool lv = !ln && l[i] != 0;
+    bool rv = !rn && r[i] != 0;
+    bool decided = is_and ? ((!ln && !lv) || (!rn && !rv)) : (lv || rv);
+    out[i] = static_cast<int8_t>(is_and ? (lv && rv) : (lv || rv));
+    nulls[i] = static_cast<uint8_t>(!decided && (ln || rn));
+  }
+}
+
+void SelectTrue(const ColumnVector &predicate, SelectionVector *selection) {
+  BUSTUB_ASSERT(predicate.GetType() == TypeId::BOOLEAN, "Expect a boolean vector.");
+  selection->clear();
+  const uint8_t *nulls = predicate.HasNulls() ? predicate.Nulls() : nullptr;
+#ifdef BUSTUB_AVX2_KERNELS
+  if (use_simd.load(std::memory_order_relaxed)) {
+    SelectAvx2(predicate.Data<int8_t>(), nulls, predicate.Size(), selection);
+    return;
+  }
+#endif
+  SelectScalar(predicate.Data<int8_t>(), nulls, 0, predicate.Size(), selection);
+}
+
+auto SimdKernelsEnabled() -> bool { return use_simd.load(); }
+
+void SetSimdKernelsEnabled(bool enabled) { use_simd.store(enabled && CpuHasAvx2()); }
+
+}  // namespace bustub
@@ -81,6 +81,10 @@ class ExplainStatement;
 class IndexStatement;
 class DeleteStatement;
 class UpdateStatement;
+class AnalyzeStatement;
+class PrepareStatement;
+class ExecuteStatement;
+class DeallocateStatement;
 
 /**
  * The binder is responsible for transforming the Postgres parse tree to a binder tree
@@ -143,6 +147,8 @@ class Binder {
 
   auto BindConstant(duckdb_libpgquery::PGAConst *node) -> std::unique_ptr<BoundExpression>;
 
+  auto BindParameter(duckdb_libpgquery::PGParamRef *node) -> std::unique_ptr<BoundExpression>;
+
   auto BindColumnRef(duckdb_libpgquery::PGColumnRef *node) -> std::unique_ptr<BoundExpression>;
 
   auto BindResTarget(duckdb_libpgquery::PGResTarget *root) -> std::unique_ptr<BoundExpression>;
@@ -204,6 +210,14 @@ class Binder {
 
   auto BindVariableShow(duckdb_libpgquery::PGVariableShowStmt *stmt) -> std::unique_ptr<VariableShowStatement>;
 
+  auto BindAnalyze(duckdb_libpgquery::PGVacuumStmt *stmt) -> std::unique_ptr<AnalyzeStatement>;
+
+  auto BindPrepare(duckdb_libpgquery::PGPrepareStmt *stmt) -> std::unique_ptr<PrepareStatement>;
+
+  auto BindExecute(duckdb_libpgquery::PGExecuteStmt *stmt) -> std::unique_ptr<ExecuteStatement>;
+
+  auto BindDeallocate(duckdb_libpgquery::PGDeallocateStmt *stmt) -> std::unique_ptr<DeallocateStatement>;
+
   class ContextGuard {
    public:
     explicit ContextGuard(const BoundTableRef **scope, const CTEList **cte_scope) {
@@ -252,6 +266,9 @@ class Binder {
   /** Sometimes we will need to assign a name to some unnamed items. This variable gives them a universal ID. */
   size_t universal_id_{0};
 
+  /** The highest `$n` parameter bound so far, the number of values a prepared statement takes */
+  size_t parameter_count_{0};
+
   duckdb::PostgresParser parser_;
 };
 
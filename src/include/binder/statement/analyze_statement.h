@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/analyze_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "binder/bound_statement.h"
+#include "binder/table_ref/bound_base_table_ref.h"
+#include "common/enums/statement_type.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+class AnalyzeStatement : public BoundStatement {
+ public:
+  explicit AnalyzeStatement(std::unique_ptr<BoundBaseTableRef> table)
+      : BoundStatement(StatementType::ANALYZE_STATEMENT), table_(std::move(table)) {}
+
+  /** The table to collect statistics of, nullptr for every table */
+  std::unique_ptr<BoundBaseTableRef> table_;
+
+  auto ToString() const -> std::string override {
+    return fmt::format("BoundAnalyze {{ table={} }}", table_ == nullptr ? "<all>" : table_->ToString());
+  }
+};
+
+}  // namespace bustub
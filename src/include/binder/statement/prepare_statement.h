@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//                         BusTub
+//
+// binder/prepare_statement.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_statement.h"
+#include "common/enums/statement_type.h"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+#include "type/value.h"
+
+namespace bustub {
+
+class PrepareStatement : public BoundStatement {
+ public:
+  explicit PrepareStatement(std::string name, std::unique_ptr<BoundStatement> statement,
+                            std::vector<TypeId> parameter_types, size_t parameter_count)
+      : BoundStatement(StatementType::PREPARE_STATEMENT),
+        name_(std::move(name)),
+        statement_(std::move(statement)),
+        parameter_types_(std::move(parameter_types)),
+        parameter_count_(parameter_count) {}
+
+  std::string name_;
+
+  /** The statement, planned again on every EXECUTE with the `$n` parameters replaced by the values passed */
+  std::unique_ptr<BoundStatement> statement_;
+
+  /** The types the values of the first parameters are cast to, as declared by `PREPARE name(type, ...)` */
+  std::vector<TypeId> parameter_types_;
+
+  /** The number of values EXECUTE has to pass */
+  size_t parameter_count_;
+
+  auto ToString() const -> std::string override {
+    return fmt::format("BoundPrepare {{ name={}, parameters={}, statement={} }}", name_, parameter_count_,
+                       statement_->ToString());
+  }
+};
+
+class ExecuteStatement : public BoundStatement {
+ public:
+  explicit ExecuteStatement(std::string name, std::vector<Value> parameters)
+      : BoundStatement(StatementType::EXECUTE_STATEMENT), name_(std::move(name)), parameters_(std::move(parameters)) {}
+
+  std::string name_;
+
+  /** The values of `$1`, `$2`, ... */
+  std::vector<Value> parameters_;
+
+  auto ToString() const -> std::string override {
+    std::vector<std::string> parameters;
+    for (const auto &parameter : parameters_) {
+      parameters.push_back(parameter.ToString());
+    }
+    return fmt::format("BoundExecute {{ name={}, parameters=[{}] }}", name_, fmt::join(parameters, ", "));
+  }
+};
+
+class DeallocateStatement : public BoundStatement {
+ public:
+  explicit DeallocateStatement(std::optional<std::string> name)
+      : BoundStatement(StatementType::DEALLOCATE_STATEMENT), name_(std::move(name)) {}
+
+  /** The prepared statement to drop, std::nullopt for all of them */
+  std::optional<std::string> name_;
+
+  auto ToString() const -> std::string override {
+    return fmt::format("BoundDeallocate {{ name={} }}", name_.value_or("<all>"));
+  }
+};
+
+}  // namespace bustub
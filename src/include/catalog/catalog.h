@@ -20,6 +20,8 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "catalog/table_stats.h"
+#include "common/util/parallel_sort.h"
 #include "container/hash/hash_function.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
@@ -56,11 +58,16 @@ struct TableInfo {
   std::unique_ptr<TableHeap> table_;
   /** The table OID */
   const table_oid_t oid_;
+  /** The statistics of the table collected by the last ANALYZE, nullptr if it was never analyzed */
+  std::shared_ptr<const TableStats> stats_;
 };
 
 /**
  * The IndexInfo class maintains metadata about a index.
  */
+/** The access method backing an index. */
+enum class IndexType { BPlusTreeIndex, HashTableIndex };
+
 struct IndexInfo {
   /**
    * Construct a new IndexInfo instance.
@@ -70,15 +77,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The access method backing the index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,6 +100,8 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The access method backing the index; only B+ tree indexes are ordered */
+  const IndexType index_type_;
 };
 
 /**
@@ -136,7 +147,7 @@ class Catalog {
     // When create_table_heap == false, it means that we're running binder tests (where no txn will be provided) or
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
-      table = std::make_unique<TableHeap>(bpm_);
+      table = std::make_unique<TableHeap>(bpm_, &schema);
     }
 
     // Fetch the table OID for the new table
@@ -150,6 +161,7 @@ class Catalog {
     tables_.emplace(table_oid, std::move(meta));
     table_names_.emplace(table_name, table_oid);
     index_names_.emplace(table_name, std::unordered_map<std::string, index_oid_t>{});
+    version_.fetch_add(1);
 
     return tmp;
   }
@@ -196,12 +208,15 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param index_type The kind of index to create
+   * @param num_threads The number of threads sorting the existing data before it is inserted
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, IndexType index_type = IndexType::BPlusTreeIndex,
+                   size_t num_threads = 1) -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -221,31 +236,45 @@ class Catalog {
     auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
 
     // Construct the index, take ownership of metadata
-    // TODO(Kyle): We should update the API for CreateIndex
-    // to allow specification of the index type itself, not
-    // just the key, value, and comparator types
-
-    // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+    std::unique_ptr<Index> index;
+    if (index_type == IndexType::HashTableIndex) {
+      index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                            hash_function);
+    } else {
+      index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+    }
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap. The keys are sorted first, so that they are inserted in key
+    // order and every insert lands next to the previous one.
     auto *table_meta = GetTable(table_name);
+    std::vector<std::pair<Tuple, RID>> entries;
+    std::vector<std::pair<KeyType, size_t>> order;
     for (auto iter = table_meta->table_->MakeIterator(); !iter.IsEnd(); ++iter) {
       auto [meta, tuple] = iter.GetTuple();
-      index->InsertEntry(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid(), txn);
+      entries.emplace_back(tuple.KeyFromTuple(schema, key_schema, key_attrs), tuple.GetRid());
+      order.emplace_back();
+      order.back().first.SetFromKey(entries.back().first);
+      order.back().second = entries.size() - 1;
+    }
+    KeyComparator comparator(index->GetKeySchema());
+    ParallelSort::Sort(
+        &order, [&comparator](const auto &a, const auto &b) { return comparator(a.first, b.first) < 0; }, num_threads);
+    for (const auto &[key, pos] : order) {
+      index->InsertEntry(entries[pos].first, entries[pos].second, txn);
     }
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
 
     // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
     auto *tmp = index_info.get();
 
     // Update internal tracking
     indexes_.emplace(index_oid, std::move(index_info));
     table_indexes.emplace(index_name, index_oid);
+    version_.fetch_add(1);
 
     return tmp;
   }
@@ -298,7 +327,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
@@ -333,6 +362,22 @@ class Catalog {
     return indexes;
   }
 
+  /**
+   * Replace the statistics the optimizer costs plans of a table with.
+   * @param table_info The table the statistics were collected from
+   * @param stats The new statistics
+   */
+  void SetTableStats(TableInfo *table_info, std::shared_ptr<const TableStats> stats) {
+    table_info->stats_ = std::move(stats);
+    version_.fetch_add(1);
+  }
+
+  /**
+   * @return a number that changes whenever a table or an index is created or statistics are replaced, so that plans
+   * made with an older version can be told apart
+   */
+  auto GetVersion() const -> uint64_t { return version_.load(); }
+
   auto GetTableNames() -> std::vector<std::string> {
     std::vector<std::string> result;
     for (const auto &x : table_names_) {
@@ -371,6 +416,9 @@ class Catalog {
 
   /** The next index identifier to be used. */
   std::atomic<index_oid_t> next_index_oid_{0};
+
+  /** Bumped by every change that can change plans. */
+  std::atomic<uint64_t> version_{0};
 };
 
 }  // namespace bustub
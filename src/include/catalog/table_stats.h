@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_stats.h
+//
+// Identification: src/include/catalog/table_stats.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/util/hash_util.h"
+#include "storage/table/table_heap.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * HyperLogLog estimates the number of distinct values of a stream in constant space: every value sets the register
+ * its hash picks to the longest run of leading zeros seen in the rest of the hash. The relative error is about
+ * 1.04 / sqrt(NUM_REGISTERS), i.e. under 2%.
+ */
+class HyperLogLog {
+ public:
+  /** Bits of the hash picking the register */
+  static constexpr uint32_t PRECISION = 12;
+  static constexpr size_t NUM_REGISTERS = size_t{1} << PRECISION;
+
+  /** Adds a value, given by a well-mixed 64-bit hash of it */
+  void Add(hash_t hash);
+
+  /** @return the estimated number of distinct values added */
+  auto Estimate() const -> double;
+
+ private:
+  std::array<uint8_t, NUM_REGISTERS> registers_{};
+};
+
+/** Statistics of one column of a table, collected by ANALYZE */
+struct ColumnStats {
+  /** Buckets of the equi-depth histogram */
+  static constexpr size_t NUM_BUCKETS = 32;
+
+  /** Estimated number of distinct non-NULL values */
+  double ndv_{0};
+  /** Fraction of the rows that are NULL */
+  double null_fraction_{0};
+  /**
+   * Bounds of the equi-depth histogram over the non-NULL values of a numeric column: NUM_BUCKETS + 1 ascending
+   * values, the first one the minimum and the last one the maximum, with about as many rows between each two. Empty
+   * for other columns and for columns without non-NULL values.
+   */
+  std::vector<double> bounds_;
+
+  /** @return the numeric value of `val`, or nullopt if it is NULL or not a number */
+  static auto NumericOf(const Value &val) -> std::optional<double>;
+
+  /** @return the estimated fraction of the rows equal to `val`, from the histogram if `val` is a frequent value */
+  auto EqualSelectivity(const Value &val) const -> double;
+
+  /**
+   * @return the estimated fraction of the rows less than (or equal to) `val`, a third of the non-NULL rows if the
+   * column has no histogram
+   */
+  auto LessSelectivity(const Value &val, bool or_equal) const -> double;
+
+  /** @return the estimated fraction of the rows greater than (or equal to) `val` */
+  auto GreaterSelectivity(const Value &val, bool or_equal) const -> double;
+};
+
+/**
+ * TableStats are the statistics of a table the optimizer estimates cardinalities with. They are a snapshot taken by
+ * ANALYZE and are not maintained afterwards.
+ */
+struct TableStats {
+  /** Rows sampled for the histograms */
+  static constexpr size_t SAMPLE_SIZE = 16384;
+
+  /** Number of rows in the table */
+  size_t row_count_{0};
+  /** Statistics of every column, in schema order */
+  std::vector<ColumnStats> columns_;
+
+  /**
+   * Scans `table` and computes its statistics. Deleted rows are left out; rows of running transactions are not,
+   * the statistics do not need to be exact.
+   */
+  static auto Collect(TableHeap *table, const Schema &schema) -> TableStats;
+};
+
+}  // namespace bustub
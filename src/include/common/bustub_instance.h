@@ -14,9 +14,11 @@
 
 #include <iostream>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <optional>
 #include <shared_mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -24,6 +26,9 @@
 
 #include "catalog/catalog.h"
 #include "common/config.h"
+#include "common/plan_cache.h"
+#include "common/task_scheduler.h"
+#include "common/util/parallel_util.h"
 #include "common/util/string_util.h"
 #include "execution/check_options.h"
 #include "libfort/lib/fort.hpp"
@@ -47,6 +52,10 @@ class IndexStatement;
 class VariableSetStatement;
 class VariableShowStatement;
 class ExplainStatement;
+class AnalyzeStatement;
+class PrepareStatement;
+class ExecuteStatement;
+class DeallocateStatement;
 
 class ResultWriter {
  public:
@@ -275,6 +284,48 @@ class BustubInstance {
     return variable == "1" || variable == "true" || variable == "yes";
   }
 
+  /** @return the number of threads set by `set execution_threads=N`, or one per core if unset or invalid */
+  auto GetExecutionThreads() -> size_t {
+    auto variable = GetSessionVariable("execution_threads");
+    try {
+      if (auto threads = std::stoul(variable); threads > 0) {
+        return threads;
+      }
+    } catch (std::logic_error &e) {
+      // fall back to the default below
+    }
+    return ParallelUtil::DefaultThreads();
+  }
+
+  /** @return the number of scheduler workers set by `set scheduler_threads=N`, or one per core if unset or invalid */
+  auto GetSchedulerThreads() -> size_t {
+    auto variable = GetSessionVariable("scheduler_threads");
+    try {
+      if (auto threads = std::stoul(variable); threads > 0) {
+        return threads;
+      }
+    } catch (std::logic_error &e) {
+      // fall back to the default below
+    }
+    return ParallelUtil::DefaultThreads();
+  }
+
+  /**
+   * @return the task scheduler that runs the parallel parts of queries. It is started on first use, and restarted
+   * with the new number of workers when `scheduler_threads` changed, which must not happen while a query runs.
+   */
+  auto GetTaskScheduler() -> TaskScheduler *;
+
+  /** @return the executor memory budget set by `set execution_memory_limit=N` in bytes, or the default */
+  auto GetExecutionMemoryLimit() -> size_t {
+    auto variable = GetSessionVariable("execution_memory_limit");
+    try {
+      return std::stoull(variable);
+    } catch (std::logic_error &e) {
+      return BUSTUB_EXECUTION_MEMORY_LIMIT;
+    }
+  }
+
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
@@ -286,8 +337,29 @@ class BustubInstance {
   void HandleExplainStatement(Transaction *txn, const ExplainStatement &stmt, ResultWriter &writer);
   void HandleVariableShowStatement(Transaction *txn, const VariableShowStatement &stmt, ResultWriter &writer);
   void HandleVariableSetStatement(Transaction *txn, const VariableSetStatement &stmt, ResultWriter &writer);
+  void HandleAnalyzeStatement(Transaction *txn, const AnalyzeStatement &stmt, ResultWriter &writer);
+  void HandlePrepareStatement(Transaction *txn, std::unique_ptr<PrepareStatement> stmt, ResultWriter &writer);
+  void HandleDeallocateStatement(Transaction *txn, const DeallocateStatement &stmt, ResultWriter &writer);
+
+  /** @return the prepared statement EXECUTE runs, and the values of its parameters cast to their declared types */
+  auto ResolveExecuteStatement(const ExecuteStatement &stmt)
+      -> std::pair<std::shared_ptr<const PrepareStatement>, std::vector<Value>>;
+
+  /** Run an optimized plan and write the rows it produces. */
+  auto ExecutePlan(Transaction *txn, const PlanCache::Entry &plan, ResultWriter &writer,
+                   std::shared_ptr<CheckOptions> check_options) -> bool;
 
   std::unordered_map<std::string, std::string> session_variables_;
+
+  /** The optimized plans of recently run statements */
+  PlanCache plan_cache_{PLAN_CACHE_SIZE};
+
+  std::mutex prepared_statements_latch_;
+  /** The statements prepared by PREPARE, by name */
+  std::unordered_map<std::string, std::shared_ptr<const PrepareStatement>> prepared_statements_;
+
+  std::mutex task_scheduler_latch_;
+  std::unique_ptr<TaskScheduler> task_scheduler_;
 };
 
 }  // namespace bustub
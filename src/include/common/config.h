@@ -21,6 +21,9 @@ namespace bustub {
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
+/** Background B+ tree compaction runs every BTREE_COMPACTION_INTERVAL milliseconds. */
+extern std::chrono::milliseconds btree_compaction_interval;
+
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
@@ -36,6 +39,14 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int BUSTUB_BATCH_SIZE = 1024;  // number of rows an executor produces per NextBatch call
+static constexpr int HASH_JOIN_PROBE_CHUNK = 65536;  // number of left rows a hash join probes at a time
+static constexpr size_t BUSTUB_EXECUTION_MEMORY_LIMIT = 128 << 20;  // bytes an executor keeps before spilling
+static constexpr int GRACE_JOIN_FANOUT = 16;    // partitions a spilling hash join splits its inputs into per level
+static constexpr int GRACE_JOIN_MAX_LEVEL = 3;  // deepest re-partitioning level of a spilling hash join
+static constexpr int TOPN_BUFFER_ROWS = 65536;  // rows a top-n gathers beyond N before cutting back to the best N
+static constexpr int AGGREGATION_INPUT_CHUNK = 65536;  // number of input rows an aggregation adds at a time
+static constexpr int PLAN_CACHE_SIZE = 256;  // number of optimized plans an instance keeps for repeated statements
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
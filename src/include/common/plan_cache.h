@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// plan_cache.h
+//
+// Identification: src/include/common/plan_cache.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "catalog/schema.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * PlanCache keeps the optimized plans of recently run statements, keyed on their normalized SQL text, so that running
+ * a statement again skips parsing, binding, planning and optimizing it.
+ *
+ * Every plan remembers the catalog version it was made with. Creating a table or an index, or replacing the statistics
+ * of a table, changes the version, and a plan made with another version is never returned. The least recently used
+ * plan is evicted once the cache is full.
+ */
+class PlanCache {
+ public:
+  /** A cached plan, with what is needed to run it. */
+  struct Entry {
+    /** The optimized plan */
+    AbstractPlanNodeRef plan_;
+    /** The schema of the rows written to the client, as named by the planner */
+    SchemaRef output_schema_;
+    /** Whether the plan modifies or deletes rows */
+    bool is_modify_;
+    /** The catalog version the plan was made with */
+    uint64_t catalog_version_;
+  };
+
+  explicit PlanCache(size_t capacity) : capacity_(capacity) {}
+
+  /** @return the plan cached for `key` and made with `catalog_version`, nullptr if there is none */
+  auto Get(const std::string &key, uint64_t catalog_version) -> std::shared_ptr<const Entry>;
+
+  /** Cache `entry` for `key`, replacing the plan cached for it before. */
+  void Put(const std::string &key, std::shared_ptr<const Entry> entry);
+
+  /** Drop every cached plan. */
+  void Clear();
+
+  /** @return the number of cached plans */
+  auto Size() -> size_t;
+
+  /**
+   * @return `sql` with comments dropped, runs of whitespace replaced by one space, and everything lowercased, except
+   * the text of quoted strings and identifiers, which is kept as it is. Trailing semicolons are dropped.
+   */
+  static auto NormalizeSql(const std::string &sql) -> std::string;
+
+ private:
+  std::mutex latch_;
+  size_t capacity_;
+  /** The cached plans, the most recently used first */
+  std::list<std::pair<std::string, std::shared_ptr<const Entry>>> lru_;
+  std::unordered_map<std::string, decltype(lru_)::iterator> entries_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// task_scheduler.h
+//
+// Identification: src/include/common/task_scheduler.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * TaskScheduler is a pool of worker threads that steal work from each other.
+ *
+ * Every worker owns a deque. A task submitted by a worker goes to the back of its own deque, and the worker takes its
+ * next task from there, so nested work stays on the core that created it. A worker whose deque is empty steals from
+ * the front of the others. Tasks submitted from outside the pool are spread over the deques round robin.
+ *
+ * The caller of a parallel operation does not sleep while it waits for the tasks it submitted: it runs queued tasks
+ * with RunOne(), which makes nested parallelism safe. A worker about to block, e.g. on disk I/O in the buffer pool,
+ * enters a BlockingRegion; another thread may then run tasks in its place, so the cores stay busy. Such spare threads
+ * are started on demand, at most one per worker.
+ *
+ * Tasks must not throw. ParallelUtil::ParallelFor() runs its tasks on the scheduler of the calling thread.
+ */
+class TaskScheduler {
+ public:
+  using Task = std::function<void()>;
+
+  /** Starts `num_workers` worker threads, at least one */
+  explicit TaskScheduler(size_t num_workers);
+
+  /** Runs the queued tasks to completion and joins the threads */
+  ~TaskScheduler();
+
+  DISALLOW_COPY_AND_MOVE(TaskScheduler);
+
+  /** @return the number of workers, which is the number of tasks that run at once unless workers block */
+  auto NumWorkers() const -> size_t { return num_workers_; }
+
+  /** @return the number of threads started so far, spare threads included */
+  auto NumThreads() -> size_t;
+
+  /** Queues a task. */
+  void Submit(Task task);
+
+  /**
+   * Runs one queued task on the calling thread, preferring the thread's own deque.
+   * @return `false` if no task was queued
+   */
+  auto RunOne() -> bool;
+
+  /** @return the scheduler the calling thread works for, or the one a Scope installed on it, or `nullptr` */
+  static auto Current() -> TaskScheduler *;
+
+  /** Makes a scheduler the Current() one of the calling thread while the Scope lives */
+  class Scope {
+   public:
+    explicit Scope(TaskScheduler *scheduler);
+    ~Scope();
+    DISALLOW_COPY_AND_MOVE(Scope);
+
+   private:
+    TaskScheduler *previous_;
+  };
+
+  /** Marks the calling worker as blocked while the region lives. Does nothing on other threads. */
+  class BlockingRegion {
+   public:
+    BlockingRegion();
+    ~BlockingRegion();
+    DISALLOW_COPY_AND_MOVE(BlockingRegion);
+
+   private:
+    TaskScheduler *scheduler_;
+  };
+
+ private:
+  struct Queue {
+    std::mutex latch_;
+    std::deque<Task> tasks_;
+  };
+
+  void WorkerLoop(size_t queue);
+  /** Takes a task from the back of deque `queue`, or else from the front of another. `queue` may be out of range. */
+  auto TryPop(size_t queue, Task *task) -> bool;
+  void BeginBlocking();
+  void EndBlocking();
+
+  size_t num_workers_;
+  /** The deque of every worker, then of every spare thread */
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::atomic<size_t> num_queued_{0};
+  std::atomic<size_t> next_queue_{0};
+
+  std::mutex latch_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  /** Threads running a task, and workers blocked in a BlockingRegion; num_workers_ + num_blocked_ tasks may run */
+  size_t num_running_{0};
+  size_t num_blocked_{0};
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace bustub
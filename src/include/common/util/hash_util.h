@@ -45,6 +45,19 @@ class HashUtil {
     return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
   }
 
+  /**
+   * Finalizer of MurmurHash3. HashBytes leaves the high bits of short inputs mostly empty, mix the hash before
+   * taking bits off it, e.g. to pick a partition.
+   */
+  static inline auto MixHash(hash_t h) -> hash_t {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
   static inline auto SumHashes(hash_t l, hash_t r) -> hash_t {
     return (l % PRIME_FACTOR + r % PRIME_FACTOR) % PRIME_FACTOR;
   }
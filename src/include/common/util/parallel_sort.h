@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_sort.h
+//
+// Identification: src/include/common/util/parallel_sort.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "common/util/parallel_util.h"
+
+namespace bustub {
+
+/**
+ * ParallelSort is a stable multi-threaded merge sort.
+ *
+ * The items are cut into one run per thread and the runs are sorted concurrently. Adjacent runs are then merged
+ * pairwise until one run is left. Every merge is itself split into independent pieces with merge path: the output
+ * is cut into equal ranges, and a binary search along each cut's diagonal finds how many items of either input come
+ * before it. So all threads stay busy in the last merges too, when there are fewer pairs than threads.
+ */
+class ParallelSort {
+ public:
+  /** Inputs smaller than this are sorted on the calling thread */
+  static constexpr size_t MIN_PARALLEL_ITEMS = 8192;
+
+  /**
+   * Sorts `items` like std::stable_sort on up to `num_threads` threads.
+   * @param items the items to sort, which must be default constructible and movable
+   * @param less the strict weak order to sort by
+   * @param num_threads the number of threads to use, the calling thread included
+   */
+  template <typename T, typename Less>
+  static void Sort(std::vector<T> *items, const Less &less, size_t num_threads) {
+    const size_t n = items->size();
+    num_threads = std::min(num_threads, n / (MIN_PARALLEL_ITEMS / 2));
+    if (num_threads <= 1) {
+      std::stable_sort(items->begin(), items->end(), less);
+      return;
+    }
+
+    // run i covers [bounds[i], bounds[i + 1])
+    std::vector<size_t> bounds(num_threads + 1);
+    for (size_t i = 0; i <= num_threads; i++) {
+      bounds[i] = n * i / num_threads;
+    }
+    ParallelUtil::ParallelFor(num_threads, num_threads, [&](size_t run) {
+      std::stable_sort(items->begin() + bounds[run], items->begin() + bounds[run + 1], less);
+    });
+
+    std::vector<T> buffer(n);
+    std::vector<T> *src = items;
+    std::vector<T> *dst = &buffer;
+    const size_t piece = std::max(MIN_PARALLEL_ITEMS, n / num_threads);
+    while (bounds.size() > 2) {
+      // merge runs 2k and 2k + 1; an odd last run is just moved over
+      struct Piece {
+        size_t begin_, mid_, end_, out_begin_, out_end_;
+      };
+      std::vector<Piece> pieces;
+      std::vector<size_t> next_bounds{0};
+      for (size_t run = 0; run + 1 < bounds.size(); run += 2) {
+        const size_t begin = bounds[run];
+        const size_t mid = bounds[run + 1];
+        const size_t end = run + 2 < bounds.size() ? bounds[run + 2] : mid;
+        for (size_t out = begin; out < end; out += piece) {
+          pieces.push_back({begin, mid, end, out, std::min(end, out + piece)});
+        }
+        next_bounds.push_back(end);
+      }
+      ParallelUtil::ParallelFor(num_threads, pieces.size(), [&](size_t i) {
+        const auto &p = pieces[i];
+        auto first = src->begin();
+        size_t a_lo = p.begin_ + Split(first + p.begin_, p.mid_ - p.begin_, first + p.mid_, p.end_ - p.mid_,
+                                       p.out_begin_ - p.begin_, less);
+        size_t a_hi = p.begin_ + Split(first + p.begin_, p.mid_ - p.begin_, first + p.mid_, p.end_ - p.mid_,
+                                       p.out_end_ - p.begin_, less);
+        size_t b_lo = p.mid_ + (p.out_begin_ - p.begin_) - (a_lo - p.begin_);
+        size_t b_hi = p.mid_ + (p.out_end_ - p.begin_) - (a_hi - p.begin_);
+        std::merge(std::make_move_iterator(first + a_lo), std::make_move_iterator(first + a_hi),
+                   std::make_move_iterator(first + b_lo), std::make_move_iterator(first + b_hi),
+                   dst->begin() + p.out_begin_, less);
+      });
+      bounds = std::move(next_bounds);
+      std::swap(src, dst);
+    }
+    if (src != items) {
+      items->swap(buffer);
+    }
+  }
+
+ private:
+  /**
+   * Merge path: @return how many items of `a` are among the first `diagonal` items of the stable merge of `a` and
+   * `b`, where items of `a` go first on ties.
+   */
+  template <typename Iter, typename Less>
+  static auto Split(Iter a, size_t a_len, Iter b, size_t b_len, size_t diagonal, const Less &less) -> size_t {
+    size_t lo = diagonal > b_len ? diagonal - b_len : 0;
+    size_t hi = std::min(diagonal, a_len);
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      // a[mid] is among the first `diagonal` items iff it does not come after b[diagonal - mid - 1]
+      if (less(b[diagonal - mid - 1], a[mid])) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    return lo;
+  }
+};
+
+}  // namespace bustub
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_util.h
+//
+// Identification: src/include/common/util/parallel_util.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/task_scheduler.h"
+
+namespace bustub {
+
+class ParallelUtil {
+ public:
+  /**
+   * Runs task(i) for every i in [0, num_tasks) on up to num_threads threads, the calling thread included.
+   * Tasks are handed out one at a time, so tasks of uneven cost still balance out. The first exception
+   * thrown by a task is rethrown once every thread has stopped.
+   *
+   * The helpers run on the TaskScheduler of the calling thread if it has one, and on threads of their own
+   * otherwise. The caller runs queued tasks while it waits for the helpers to finish.
+   */
+  static void ParallelFor(size_t num_threads, size_t num_tasks, const std::function<void(size_t)> &task) {
+    num_threads = std::max<size_t>(1, std::min(num_threads, num_tasks));
+    if (num_threads == 1) {
+      for (size_t i = 0; i < num_tasks; i++) {
+        task(i);
+      }
+      return;
+    }
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_latch;
+    auto worker = [&]() {
+      for (size_t i = next++; i < num_tasks; i = next++) {
+        try {
+          task(i);
+        } catch (...) {
+          std::scoped_lock lock(error_latch);
+          if (!error) {
+            error = std::current_exception();
+          }
+          // stop handing out tasks
+          next = num_tasks;
+        }
+      }
+    };
+    if (auto *scheduler = TaskScheduler::Current(); scheduler != nullptr) {
+      std::atomic<size_t> num_helpers{num_threads - 1};
+      for (size_t i = 1; i < num_threads; i++) {
+        scheduler->Submit([&]() {
+          worker();
+          num_helpers--;
+        });
+      }
+      worker();
+      while (num_helpers > 0) {
+        if (!scheduler->RunOne()) {
+          std::this_thread::yield();
+        }
+      }
+    } else {
+      std::vector<std::thread> threads;
+      threads.reserve(num_threads - 1);
+      for (size_t i = 1; i < num_threads; i++) {
+        threads.emplace_back(worker);
+      }
+      worker();
+      for (auto &thread : threads) {
+        thread.join();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  /** @return the number of chunks of at most `chunk_size` items covering `num_items` items */
+  static auto NumChunks(size_t num_items, size_t chunk_size) -> size_t {
+    return (num_items + chunk_size - 1) / chunk_size;
+  }
+
+  /** @return the threads to use when the caller has no better estimate, at least one */
+  static auto DefaultThreads() -> size_t { return std::max<size_t>(1, std::thread::hardware_concurrency()); }
+};
+
+}  // namespace bustub
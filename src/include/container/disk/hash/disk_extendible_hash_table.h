@@ -19,6 +19,7 @@
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/transaction.h"
 #include "container/hash/hash_function.h"
+#include "storage/page/extendible_htable_header_page.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
 
@@ -30,6 +31,16 @@ namespace bustub {
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table grows/shrinks dynamically as buckets become full/empty.
+ *
+ * The table has three levels: a header page routes the high bits of the
+ * hash to one of up to HTABLE_HEADER_ARRAY_SIZE directory pages, and each
+ * directory maps the low bits to its bucket pages. Directory pages are
+ * created lazily the first time a key hashes to them.
+ *
+ * Operations that stay within one bucket only hold their directory page
+ * latch in shared mode plus the latch of that bucket page, so they scale
+ * with the number of buckets. Splits and merges latch only their own
+ * directory page exclusively.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class DiskExtendibleHashTable {
@@ -40,9 +51,11 @@ class DiskExtendibleHashTable {
    * @param buffer_pool_manager buffer pool manager to be used
    * @param comparator comparator for keys
    * @param hash_fn the hash function
+   * @param header_max_depth number of high hash bits the header page uses to pick a directory page
    */
   explicit DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                   uint32_t header_max_depth = HTABLE_HEADER_MAX_DEPTH);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -75,12 +88,12 @@ class DiskExtendibleHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Returns the global depth
+   * Returns the largest global depth over all directory pages
    */
   auto GetGlobalDepth() -> uint32_t;
 
   /**
-   * Helper function to verify the integrity of the extendible hash table's directory.
+   * Helper function to verify the integrity of every directory of the extendible hash table.
    */
   void VerifyIntegrity();
 
@@ -122,11 +135,26 @@ class DiskExtendibleHashTable {
   auto KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t;
 
   /**
-   * Fetches the directory page from the buffer pool manager.
+   * Get the directory page_id the header page routes a key to. The caller must hold table_latch_.
    *
-   * @return a pointer to the directory page
+   * @param key the key for lookup
+   * @return the directory page_id, INVALID_PAGE_ID if the directory was not created yet
+   */
+  auto KeyToDirectoryPageId(KeyType key) -> page_id_t;
+
+  /**
+   * Creates the directory page (with a single empty bucket) a key is routed to, if it does not exist yet.
+   *
+   * @param key the key that needs a directory
+   */
+  void CreateDirectory(KeyType key);
+
+  /**
+   * Fetches the header page from the buffer pool manager.
+   *
+   * @return a pointer to the header page
    */
-  auto FetchDirectoryPage() -> HashTableDirectoryPage *;
+  auto FetchHeaderPage() -> ExtendibleHTableHeaderPage *;
 
   /**
    * Fetches the a bucket page from the buffer pool manager using the bucket's page_id.
@@ -162,11 +190,12 @@ class DiskExtendibleHashTable {
   void Merge(Transaction *transaction, const KeyType &key, const ValueType &value);
 
   // member variables
-  page_id_t directory_page_id_;
+  page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writers are splits and merges
+  // Latch on the header page. Taken exclusively only to create a new directory page; every other operation
+  // takes it shared and then latches the directory page (exclusively for splits and merges) and bucket page.
   ReaderWriterLatch table_latch_;
   HashFunction<KeyType> hash_fn_;
 };
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <string>
 #include <vector>
@@ -24,12 +25,20 @@
 
 namespace bustub {
 
-#define HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
+#define LINEAR_PROBE_HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
 
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Slots are numbered across the block pages listed in the header page. A key
+ * probes forward from hash % size until it reaches a never-occupied slot;
+ * removed entries stay behind as tombstones so later probes do not stop early.
+ * Once live entries plus tombstones pass the load factor the table is rebuilt
+ * from its live entries only, which drops all tombstones. It doubles when the
+ * live entries alone fill more than half of it and keeps its size otherwise, so
+ * a workload with stable cardinality settles on a fixed size.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable {
@@ -85,15 +94,24 @@ class LinearProbeHashTable {
   auto GetSize() -> size_t;
 
  private:
+  /** Maximum fraction of occupied slots (live entries and tombstones) before the table doubles */
+  static constexpr double MAX_LOAD_FACTOR = 0.75;
+
   auto GetHeaderPage() -> HashTableHeaderPage *;
   auto GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE *;
+  void Rebuild(size_t new_size);
   void ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value);
   void DeleteBlockPages(HashTableHeaderPage *old_header_page);
   void CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks);
   auto GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
+  auto GetSizeLatchFree() -> size_t;
 
   // member variable
   page_id_t header_page_id_;
+  // number of occupied slots, tombstones included; reset by Rebuild
+  std::atomic<size_t> num_occupied_{0};
+  // number of readable slots
+  std::atomic<size_t> num_live_{0};
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
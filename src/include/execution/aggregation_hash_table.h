@@ -0,0 +1,187 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table.h
+//
+// Identification: src/include/execution/aggregation_hash_table.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/util/hash_util.h"
+#include "execution/plans/aggregation_plan.h"
+#include "storage/table/tmp_tuple_heap.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * AggregationHashTable computes the groups of a hash aggregation in two phases.
+ *
+ * In the first phase every input chunk is split across up to `num_threads` threads, and each thread pre-aggregates
+ * its rows into a small table of its own. A local table that outgrows the cache is flushed into radix partitions on
+ * the high bits of the group hash. In the second phase the partitions, which hold disjoint groups, are merged into
+ * their final tables in parallel.
+ *
+ * Groups are stored flat. The group-by values form one normalized key (see SortKeyEncoder) that is hashed and
+ * compared as bytes, so NULL group-by values form a group of their own. Counts and the aggregates of integral inputs
+ * are 64-bit states; only aggregates of other input types keep Values.
+ *
+ * When the flushed groups exceed the memory limit, every partition is spilled to temp pages of its own, and so is
+ * what is flushed later. The spilled partitions are then aggregated one at a time while the groups are read. A
+ * partition that still does not fit is split again on the next bits of the hash. Without a buffer pool nothing is
+ * spilled. Few groups never leave the local tables, so they never reach the partitions, let alone the disk.
+ */
+class AggregationHashTable {
+ public:
+  /**
+   * @param plan the aggregation plan
+   * @param input_schema the schema of the input rows
+   * @param num_threads the number of threads both phases may use
+   * @param bpm the buffer pool for spilled partitions, may be `nullptr`
+   * @param memory_limit the bytes of group state kept in memory before spilling
+   */
+  AggregationHashTable(const AggregationPlanNode *plan, const Schema *input_schema, size_t num_threads,
+                       BufferPoolManager *bpm, size_t memory_limit);
+
+  /** Aggregates a chunk of input rows. */
+  void Add(const std::vector<Tuple> &rows);
+
+  /** Merges the partial groups. Must be called after the last Add() and before reading the groups. */
+  void Finish();
+
+  /**
+   * Produces the next group.
+   * @param[out] values the group-by values and then the aggregates of the group
+   * @return `false` once every group was produced
+   */
+  auto NextGroup(std::vector<Value> *values) -> bool;
+
+  /** @return whether no rows were added */
+  auto IsEmpty() const -> bool { return num_rows_ == 0; }
+
+  /** @return the number of partitions spilled to temp pages, counting re-partitioned ones */
+  auto NumSpilledPartitions() const -> size_t { return num_spilled_; }
+
+  /** Appends the aggregates over an empty input to `values`. */
+  void GetEmptyAggregates(std::vector<Value> *values) const;
+
+ private:
+  /** Running aggregate of a group; `value_` is a count or an integral sum, min or max */
+  struct State {
+    int64_t value_;
+    bool null_;
+  };
+
+  /** A list of groups */
+  struct Groups {
+    std::vector<hash_t> hashes_;
+    /** The keys of all groups back to back; group i owns [key_ends_[i - 1], key_ends_[i]) */
+    std::string keys_;
+    std::vector<size_t> key_ends_;
+    /** num_aggregates states per group */
+    std::vector<State> states_;
+    /** num_aggregates Values per group if some aggregate is not integral, otherwise empty */
+    std::vector<Value> values_;
+
+    auto Size() const -> size_t { return hashes_.size(); }
+    auto Key(size_t group) const -> std::string_view {
+      size_t begin = group == 0 ? 0 : key_ends_[group - 1];
+      return {keys_.data() + begin, key_ends_[group] - begin};
+    }
+    void Clear();
+  };
+
+  /** Groups with a linear-probing index on their keys */
+  struct Table {
+    Groups groups_;
+    /** group index + 1, 0 for an empty slot */
+    std::vector<uint32_t> slots_;
+  };
+
+  /** A partition on temp pages; `level` is the number of times its groups were partitioned */
+  struct SpilledPartition {
+    std::unique_ptr<TmpTupleHeap> heap_;
+    size_t level_;
+  };
+
+  /** @return the partition of `hash` when partitioning for the `level`-th time */
+  auto PartitionOf(hash_t hash, size_t level = 0) const -> size_t;
+  /** @return the bytes `groups` takes in memory */
+  auto BytesOf(const Groups &groups) const -> size_t;
+  /** @return the group of `key` in `table`, which is created with initial states if it does not exist yet */
+  auto FindOrInsert(Table *table, hash_t hash, std::string_view key) const -> size_t;
+  /** Updates the states of `group` with the aggregate inputs of one row */
+  void Update(Groups *groups, size_t group, const std::vector<Value> &inputs) const;
+  /** Combines the states of group `from` of `src` into group `to` of `dst` */
+  void Merge(Groups *dst, size_t to, const Groups &src, size_t from) const;
+  /** Appends group `group` of `src` to `dst` */
+  void Append(Groups *dst, const Groups &src, size_t group) const;
+  /** Scatters the groups of local table `task` into its partitions and empties the table */
+  void Flush(size_t task);
+  /** Flushes the local tables and moves the groups of every partition to its temp pages */
+  void Spill();
+  /** Writes group `group` of `groups` to `heap` */
+  void WriteGroup(const Groups &groups, size_t group, TmpTupleHeap *heap) const;
+  /** Reads a group written by WriteGroup() and appends it to `groups` */
+  void ReadGroup(const Tuple &tuple, Groups *groups) const;
+  /**
+   * Aggregates a spilled partition into current_. If it does not fit, its groups are partitioned once more and the
+   * parts queued instead. @return whether current_ holds the partition
+   */
+  auto LoadPartition(SpilledPartition *partition) -> bool;
+  /** Adds two integral values, failing like Value::Add if the sum leaves the range of aggregate `agg`'s type */
+  auto CheckedAdd(size_t agg, int64_t a, int64_t b) const -> int64_t;
+  auto StateToValue(size_t agg, const State &state) const -> Value;
+  /** Appends the group-by values and then the aggregates of group `group` of `groups` to `values` */
+  void GetGroup(const Groups &groups, size_t group, std::vector<Value> *values) const;
+
+  const AggregationPlanNode *plan_;
+  const Schema *input_schema_;
+  size_t num_threads_;
+  BufferPoolManager *bpm_;
+  size_t memory_limit_;
+  size_t num_aggregates_;
+  /** Whether aggregate i keeps a typed state, otherwise a Value */
+  std::vector<bool> typed_;
+  bool has_values_{false};
+  /** The range of the input type of every typed aggregate */
+  std::vector<int64_t> min_;
+  std::vector<int64_t> max_;
+
+  size_t num_rows_{0};
+  /** The pre-aggregation table of every task */
+  std::vector<Table> locals_;
+  /** The flushed groups of every task, by partition, and the bytes they take per task */
+  std::vector<std::vector<Groups>> partitions_;
+  std::vector<size_t> partition_bytes_;
+  bool flushed_{false};
+  /** The temp pages of every partition once the partitions spilled, otherwise empty */
+  std::vector<std::unique_ptr<TmpTupleHeap>> spilled_;
+  size_t num_spilled_{0};
+
+  /** The in-memory final tables and the next group to produce */
+  std::vector<Table> finals_;
+  size_t table_cursor_{0};
+  size_t group_cursor_{0};
+  /** The spilled partitions still to aggregate, and the one being produced */
+  std::deque<SpilledPartition> pending_;
+  Table current_;
+  bool current_valid_{false};
+};
+
+}  // namespace bustub
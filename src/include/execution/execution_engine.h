@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <functional>
+#include <iterator>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -31,6 +33,9 @@ namespace bustub {
  */
 	class ExecutionEngine {
 	public:
+		/** Receives the output of a plan one batch of at most BUSTUB_BATCH_SIZE tuples at a time, and may move them out */
+		using BatchSink = std::function<void(std::vector<Tuple> *)>;
+
 		/**
 		 * Construct a new ExecutionEngine instance.
 		 * @param bpm The buffer pool manager used by the execution engine
@@ -53,6 +58,30 @@ namespace bustub {
 		// NOLINTNEXTLINE
 		auto Execute(const AbstractPlanNodeRef &plan, std::vector<Tuple> *result_set, Transaction *txn,
 					 ExecutorContext *exec_ctx) -> bool {
+			auto executor_succeeded = ExecuteStreaming(plan, [&](std::vector<Tuple> *tuples) {
+				if (result_set != nullptr) {
+					result_set->insert(result_set->end(), std::make_move_iterator(tuples->begin()),
+									   std::make_move_iterator(tuples->end()));
+				}
+			}, txn, exec_ctx);
+			if (!executor_succeeded && result_set != nullptr) {
+				result_set->clear();
+			}
+			return executor_succeeded;
+		}
+
+		/**
+		 * Execute a query plan, handing its output to `sink` as it is produced. The next batch is only pulled from
+		 * the executors once `sink` returned, so at most one batch of output is held at a time. If execution fails,
+		 * the batches already handed out are not taken back.
+		 * @param plan The query plan to execute
+		 * @param sink Receives the tuples produced by executing the plan
+		 * @param txn The transaction context in which the query executes
+		 * @param exec_ctx The executor context in which the query executes
+		 * @return `true` if execution of the query plan succeeds, `false` otherwise
+		 */
+		auto ExecuteStreaming(const AbstractPlanNodeRef &plan, const BatchSink &sink, Transaction *txn,
+							  ExecutorContext *exec_ctx) -> bool {
 			BUSTUB_ASSERT((txn == exec_ctx->GetTransaction()), "Broken Invariant");
 
 			// Construct the executor for the abstract plan node
@@ -63,13 +92,10 @@ namespace bustub {
 
 			try {
 				executor->Init();
-				PollExecutor(executor.get(), plan, result_set);
+				PollExecutor(executor.get(), plan, sink);
 				PerformChecks(exec_ctx);
 			} catch (const ExecutionException &ex) {
 				executor_succeeded = false;
-				if (result_set != nullptr) {
-					result_set->clear();
-				}
 			}
 
 			return executor_succeeded;
@@ -90,19 +116,16 @@ namespace bustub {
 
 	private:
 		/**
-		 * Poll the executor until exhausted, or exception escapes.
+		 * Poll the executor a batch at a time until exhausted, or exception escapes.
 		 * @param executor The root executor
 		 * @param plan The plan to execute
-		 * @param result_set The tuple result set
+		 * @param sink Receives every batch
 		 */
-		static void PollExecutor(AbstractExecutor *executor, const AbstractPlanNodeRef &plan,
-								 std::vector<Tuple> *result_set) {
-			RID rid{};
-			Tuple tuple{};
-			while (executor->Next(&tuple, &rid)) {
-				if (result_set != nullptr) {
-					result_set->push_back(tuple);
-				}
+		static void PollExecutor(AbstractExecutor *executor, const AbstractPlanNodeRef &plan, const BatchSink &sink) {
+			std::vector<Tuple> tuples;
+			std::vector<RID> rids;
+			while (executor->NextBatch(&tuples, &rids, BUSTUB_BATCH_SIZE)) {
+				sink(&tuples);
 			}
 		}
 
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <unordered_set>
@@ -93,6 +94,16 @@ class ExecutorContext {
 
   auto IsDelete() const -> bool { return is_delete_; }
 
+  /** @return the number of threads an executor may use for intra-operator parallelism */
+  auto GetNumThreads() const -> size_t { return num_threads_; }
+
+  void SetNumThreads(size_t num_threads) { num_threads_ = std::max<size_t>(1, num_threads); }
+
+  /** @return the bytes of intermediate results an executor may keep in memory before spilling to temp pages */
+  auto GetMemoryLimit() const -> size_t { return memory_limit_; }
+
+  void SetMemoryLimit(size_t memory_limit) { memory_limit_ = memory_limit; }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -109,6 +120,10 @@ class ExecutorContext {
   /** The set of check options associated with this executor context */
   std::shared_ptr<CheckOptions> check_options_;
   bool is_delete_;
+  /** The number of threads an executor may use, see GetNumThreads() */
+  size_t num_threads_{1};
+  /** The memory budget of an executor, see GetMemoryLimit() */
+  size_t memory_limit_{BUSTUB_EXECUTION_MEMORY_LIMIT};
 };
 
 }  // namespace bustub
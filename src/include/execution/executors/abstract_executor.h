@@ -12,15 +12,25 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
 #include "execution/executor_context.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 class ExecutorContext;
+struct RuntimeFilterProbe;
 /**
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
+ *
+ * Executors may additionally produce rows a batch at a time through NextBatch().
+ * Each interface has a default adapter on top of the other, so an executor only
+ * needs to implement one of them natively; a consumer should stick to one of the
+ * two between calls to Init().
  */
 class AbstractExecutor {
  public:
@@ -47,6 +57,34 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid) -> bool = 0;
 
+  /**
+   * Yield the next batch of tuples from this executor. The default implementation
+   * pulls up to `batch_size` tuples through Next().
+   * @param[out] tuples The next tuples produced by this executor, replacing any previous contents
+   * @param[out] rids The RIDs of those tuples, one per tuple
+   * @param batch_size The maximum number of tuples to produce
+   * @return `true` if at least one tuple was produced, `false` if there are no more tuples
+   */
+  virtual auto NextBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size) -> bool {
+    tuples->clear();
+    rids->clear();
+    Tuple tuple{};
+    RID rid{};
+    while (tuples->size() < batch_size && Next(&tuple, &rid)) {
+      tuples->push_back(std::move(tuple));
+      rids->push_back(rid);
+    }
+    return !tuples->empty();
+  }
+
+  /**
+   * Offers a runtime filter on output columns of this executor: rows it rules out cannot find a join partner
+   * upstream and may be dropped early. Filters are offered after Init() and before the first row is pulled, and
+   * Init() drops them again.
+   * @return `true` if the executor applies the filter
+   */
+  virtual auto PushRuntimeFilter(const RuntimeFilterProbe & /* probe */) -> bool { return false; }
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
@@ -54,7 +92,36 @@ class AbstractExecutor {
   auto GetExecutorContext() -> ExecutorContext * { return exec_ctx_; }
 
  protected:
+  /**
+   * Adapter for executors that implement NextBatch() natively: serves Next() one
+   * tuple at a time out of a buffered batch.
+   */
+  auto NextFromBatch(Tuple *tuple, RID *rid) -> bool {
+    if (batch_cursor_ >= batch_tuples_.size()) {
+      batch_cursor_ = 0;
+      if (!NextBatch(&batch_tuples_, &batch_rids_, BUSTUB_BATCH_SIZE)) {
+        return false;
+      }
+    }
+    *tuple = std::move(batch_tuples_[batch_cursor_]);
+    *rid = batch_rids_[batch_cursor_];
+    batch_cursor_++;
+    return true;
+  }
+
+  /** Drop any tuples buffered by NextFromBatch(), must be called when the executor is re-initialized */
+  void ResetBatch() {
+    batch_tuples_.clear();
+    batch_rids_.clear();
+    batch_cursor_ = 0;
+  }
+
   /** The executor context in which the executor runs */
   ExecutorContext *exec_ctx_;
+
+ private:
+  std::vector<Tuple> batch_tuples_;
+  std::vector<RID> batch_rids_;
+  size_t batch_cursor_{0};
 };
 }  // namespace bustub
@@ -20,6 +20,7 @@
 #include "common/util/hash_util.h"
 #include "container/hash/hash_function.h"
 #include "execution/executor_context.h"
+#include "execution/aggregation_hash_table.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/aggregation_plan.h"
@@ -28,157 +29,12 @@
 
 namespace bustub {
 
-/**
- * A simplified hash table that has all the necessary functionality for aggregations.
- */
-    class SimpleAggregationHashTable {
-    public:
-        /**
-         * Construct a new SimpleAggregationHashTable instance.
-         * @param agg_exprs the aggregation expressions
-         * @param agg_types the types of aggregations
-         */
-        SimpleAggregationHashTable(const std::vector<AbstractExpressionRef> &agg_exprs,
-                                   const std::vector<AggregationType> &agg_types)
-            : agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
-
-        /** @return The initial aggregate value for this aggregation executor */
-        auto GenerateInitialAggregateValue() -> AggregateValue {
-            std::vector<Value> values{};
-            for (const auto &agg_type: agg_types_) {
-                switch (agg_type) {
-                    case AggregationType::CountStarAggregate:
-                        // Count start starts at zero.
-                        values.emplace_back(ValueFactory::GetIntegerValue(0));
-                        break;
-                    case AggregationType::CountAggregate:
-                    case AggregationType::SumAggregate:
-                    case AggregationType::MinAggregate:
-                    case AggregationType::MaxAggregate:
-                        // Others starts at null.
-                        values.emplace_back(ValueFactory::GetNullValueByType(TypeId::INTEGER));
-                        break;
-                }
-            }
-            return {values};
-        }
-
-        /**
-         * TODO(Student)
-         *
-         * Combines the input into the aggregation result.
-         * @param[out] result The output aggregate value
-         * @param input The input value
-         */
-        void CombineAggregateValues(AggregateValue *result, const AggregateValue &input) {
-            for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
-                switch (agg_types_[i]) {
-                    case AggregationType::CountStarAggregate:
-                        result->aggregates_[i] = result->aggregates_[i].Add(ValueFactory::GetIntegerValue(1));
-                        break;
-                    case AggregationType::CountAggregate:
-                        if (result->aggregates_[i].IsNull()) {
-                            result->aggregates_[i] = ValueFactory::GetIntegerValue(0);
-                        }
-                        if (!input.aggregates_[i].IsNull()) {
-                            result->aggregates_[i] = result->aggregates_[i].Add(ValueFactory::GetIntegerValue(1));
-                        }
-                        break;
-                    case AggregationType::SumAggregate:
-                        if (result->aggregates_[i].IsNull()) {
-                            result->aggregates_[i] = input.aggregates_[i];
-                        } else if (!input.aggregates_[i].IsNull()) {
-                            result->aggregates_[i] = result->aggregates_[i].Add(input.aggregates_[i]);
-                        }
-                        break;
-                    case AggregationType::MinAggregate:
-                        if (result->aggregates_[i].IsNull()) {
-                            result->aggregates_[i] = input.aggregates_[i];
-                        } else if (!input.aggregates_[i].IsNull()) {
-                            result->aggregates_[i] = result->aggregates_[i].Min(input.aggregates_[i]);
-                        }
-                        break;
-                    case AggregationType::MaxAggregate:
-                        if (result->aggregates_[i].IsNull()) {
-                            result->aggregates_[i] = input.aggregates_[i];
-                        } else if (!input.aggregates_[i].IsNull()) {
-                            result->aggregates_[i] = result->aggregates_[i].Max(input.aggregates_[i]);
-                        }
-                        break;
-                }
-            }
-        }
-
-        /**
-         * Inserts a value into the hash table and then combines it with the current aggregation.
-         * @param agg_key the key to be inserted
-         * @param agg_val the value to be inserted
-         */
-        void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-            if (ht_.count(agg_key) == 0) {
-                ht_.insert({agg_key, GenerateInitialAggregateValue()});
-            }
-            CombineAggregateValues(&ht_[agg_key], agg_val);
-        }
-
-        void Initial() {
-            ht_.insert({{std::vector<Value>()}, GenerateInitialAggregateValue()});
-        }
-
-        /**
-         * Clear the hash table
-         */
-        void Clear() { ht_.clear(); }
-
-        /** An iterator over the aggregation hash table */
-        class Iterator {
-        public:
-            /** Creates an iterator for the aggregate map. */
-            explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_{iter} {}
-
-            /** @return The key of the iterator */
-            auto Key() -> const AggregateKey & { return iter_->first; }
-
-            /** @return The value of the iterator */
-            auto Val() -> const AggregateValue & { return iter_->second; }
-
-            /** @return The iterator before it is incremented */
-            auto operator++() -> Iterator & {
-                ++iter_;
-                return *this;
-            }
-
-            /** @return `true` if both iterators are identical */
-            auto operator==(const Iterator &other) -> bool { return this->iter_ == other.iter_; }
-
-            /** @return `true` if both iterators are different */
-            auto operator!=(const Iterator &other) -> bool { return this->iter_ != other.iter_; }
-
-        private:
-            /** Aggregates map */
-            std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
-        };
-
-        /** @return Iterator to the start of the hash table */
-        auto Begin() -> Iterator { return Iterator{ht_.cbegin()}; }
-
-        /** @return Iterator to the end of the hash table */
-        auto End() -> Iterator { return Iterator{ht_.cend()}; }
-
-        auto Size() -> size_t { return ht_.size(); }
-
-    private:
-        /** The hash table is just a map from aggregate keys to aggregate values */
-        std::unordered_map<AggregateKey, AggregateValue> ht_{};
-        /** The aggregate expressions that we have */
-        const std::vector<AbstractExpressionRef> &agg_exprs_;
-        /** The types of aggregations that we have */
-        const std::vector<AggregationType> &agg_types_;
-    };
-
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX)
  * over the tuples produced by a child executor.
+ *
+ * The input is gathered in chunks of AGGREGATION_INPUT_CHUNK rows, which an AggregationHashTable
+ * aggregates on the executor's threads. Groups beyond the executor's memory limit are spilled to temp pages.
  */
     class AggregationExecutor : public AbstractExecutor {
     public:
@@ -202,31 +58,21 @@ namespace bustub {
          */
         auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+        /**
+         * Yield up to `batch_size` aggregated groups.
+         * @param[out] tuples The groups produced by the aggregation
+         * @param[out] rids The RIDs of the produced groups (always invalid)
+         * @param batch_size The maximum number of groups to produce
+         * @return `true` if at least one group was produced, `false` if there are no more groups
+         */
+        auto NextBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size) -> bool override;
+
         /** @return The output schema for the aggregation */
         auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
         /** Do not use or remove this function, otherwise you will get zero points. */
         auto GetChildExecutor() const -> const AbstractExecutor *;
 
-    private:
-        /** @return The tuple as an AggregateKey */
-        auto MakeAggregateKey(const Tuple *tuple) -> AggregateKey {
-            std::vector<Value> keys;
-            for (const auto &expr: plan_->GetGroupBys()) {
-                keys.emplace_back(expr->Evaluate(tuple, child_executor_->GetOutputSchema()));
-            }
-            return {keys};
-        }
-
-        /** @return The tuple as an AggregateValue */
-        auto MakeAggregateValue(const Tuple *tuple) -> AggregateValue {
-            std::vector<Value> vals;
-            for (const auto &expr: plan_->GetAggregates()) {
-                vals.emplace_back(expr->Evaluate(tuple, child_executor_->GetOutputSchema()));
-            }
-            return {vals};
-        }
-
     private:
         /** The aggregation plan node */
         const AggregationPlanNode *plan_;
@@ -234,10 +80,10 @@ namespace bustub {
         /** The child executor that produces tuples over which the aggregation is computed */
         std::unique_ptr<AbstractExecutor> child_executor_;
 
-        /** Simple aggregation hash table */
-        SimpleAggregationHashTable aht_;
+        /** The groups, built by Init() */
+        std::unique_ptr<AggregationHashTable> aht_;
 
-        /** Simple aggregation hash table iterator */
-        SimpleAggregationHashTable::Iterator aht_iterator_;
+        /** Whether the single row of an aggregation without GROUP BY over an empty input is still to be produced */
+        bool empty_row_pending_{false};
     };
 }  // namespace bustub
@@ -17,6 +17,7 @@
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/vector_kernels.h"
 #include "execution/plans/filter_plan.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "storage/table/tuple.h"
@@ -48,6 +49,16 @@ class FilterExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the filter, processing a whole batch of child tuples at a time.
+   */
+  auto NextBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size) -> bool override;
+
+  /** Hands the runtime filter on to the child, whose rows have the same columns */
+  auto PushRuntimeFilter(const RuntimeFilterProbe &probe) -> bool override {
+    return child_executor_->PushRuntimeFilter(probe);
+  }
+
   /** @return The output schema for the filter plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -57,5 +68,11 @@ class FilterExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** Buffers for the batch pulled from the child */
+  std::vector<Tuple> child_tuples_;
+  std::vector<RID> child_rids_;
+  /** The predicate evaluated over the child batch, and the rows it selected */
+  ColumnVector predicate_;
+  SelectionVector selection_;
 };
 }  // namespace bustub
@@ -12,14 +12,20 @@
 
 #pragma once
 
+#include <deque>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/join_hash_table.h"
 #include "execution/plans/hash_join_plan.h"
+#include "execution/runtime_filter.h"
+#include "storage/table/tmp_tuple_heap.h"
 #include "storage/table/tuple.h"
-#include "common/util/hash_util.h"
 
 namespace bustub {
 
@@ -184,7 +190,10 @@ namespace bustub {
                          std::unique_ptr<AbstractExecutor> &&left_child,
                          std::unique_ptr<AbstractExecutor> &&right_child);
 
-        /** Initialize the join */
+        /**
+         * Initialize the join. If the right side does not fit in the memory limit of the executor context, it
+         * is hash partitioned and the partitions that do not fit are spilled to temp pages (hybrid hash join).
+         */
         void Init() override;
 
         /**
@@ -195,6 +204,19 @@ namespace bustub {
          */
         auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+        /**
+         * Yield up to `batch_size` joined tuples. The left side is probed a chunk at a time, in parallel across
+         * the partitions of the hash table, and the joined tuples of a chunk are handed out over several batches.
+         * @param[out] tuples The joined tuples
+         * @param[out] rids The RIDs of the joined tuples, not used by hash join
+         * @param batch_size The maximum number of tuples to produce
+         * @return `true` if at least one tuple was produced, `false` if there are no more tuples
+         */
+        auto NextBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size) -> bool override;
+
+        /** Hands a runtime filter on the left columns of the output on to the left child */
+        auto PushRuntimeFilter(const RuntimeFilterProbe &probe) -> bool override;
+
         /** @return The output schema for the join */
         auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
@@ -203,10 +225,46 @@ namespace bustub {
         const HashJoinPlanNode *plan_;
         std::unique_ptr<AbstractExecutor> left_child;
         std::unique_ptr<AbstractExecutor> right_child;
-        std::unordered_map<hash_t, std::vector<Tuple>> ht_{};
-        int idx{-1};
-        std::unordered_map<hash_t, std::vector<Tuple>::iterator> ht_iter_{};
-        Tuple left_tuple;
+        /** Hands out the next batch of tuples, @return `false` once exhausted */
+        using TupleSource = std::function<bool(std::vector<Tuple> *)>;
+
+        /** A partition of both sides spilled to temp pages, joined once the resident partitions are done */
+        struct SpilledPartition {
+            explicit SpilledPartition(BufferPoolManager *bpm, size_t level) : right_(bpm), left_(bpm), level_(level) {}
+            TmpTupleHeap right_;
+            TmpTupleHeap left_;
+            /** The partitioning level the partition was split off at */
+            size_t level_;
+        };
+
+        auto JoinTuples(const Tuple &left, const Tuple *right) const -> Tuple;
+        /**
+         * @return the left columns an inner join can filter on with a runtime filter over the right keys, or nullopt
+         * if the left keys are not plain columns or the key types do not hash alike
+         */
+        auto RuntimeFilterColumns() const -> std::optional<std::vector<uint32_t>>;
+        /** Builds ht_ from `right`, partitioning it at `level` and spilling partitions if it does not fit */
+        void Build(const TupleSource &right, size_t level);
+        /** @return the partition of `tuple` at the current level, or GRACE_JOIN_FANOUT if its key is NULL */
+        auto PartitionOf(const Tuple &tuple, const std::vector<AbstractExpressionRef> &exprs,
+                         const Schema &schema) const -> size_t;
+        /** Probes the next chunk of left tuples into output_, @return `false` if the left side is exhausted */
+        auto ProbeNextChunk() -> bool;
+        /** Moves on to the next spilled partition, @return `false` if there is none left */
+        auto NextSpilledPartition() -> bool;
+
+        /** The resident part of the right side, hashed on the right join keys */
+        std::unique_ptr<RadixJoinHashTable> ht_;
+        TupleSource left_source_;
+        size_t level_{0};
+        /** The spilled partitions of the current level, nullptr for resident ones; empty if nothing spilled */
+        std::vector<std::unique_ptr<SpilledPartition>> spilled_;
+        /** Spilled partitions waiting to be joined, and the one being joined */
+        std::deque<std::unique_ptr<SpilledPartition>> pending_;
+        std::unique_ptr<SpilledPartition> current_;
+        /** The joined tuples of the last probed chunk, and the next one to hand out */
+        std::vector<Tuple> output_;
+        size_t output_cursor_{0};
     };
 
 }  // namespace bustub
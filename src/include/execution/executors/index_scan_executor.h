@@ -12,18 +12,21 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/index_scan_plan.h"
+#include "execution/runtime_filter.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * IndexScanExecutor executes an index scan over a table.
+ * IndexScanExecutor executes an index scan over a table. A full scan walks the B+ tree in key order; a point
+ * lookup probes any index type (B+ tree or hash) through Index::ScanKey.
  */
 
     class IndexScanExecutor : public AbstractExecutor {
@@ -41,12 +44,26 @@ namespace bustub {
 
         auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+        /** Drops the rows the runtime filter rules out before they are produced */
+        auto PushRuntimeFilter(const RuntimeFilterProbe &probe) -> bool override;
+
     private:
+        /** @return the columns of `row` the plan produces */
+        auto Produce(const Tuple &row) const -> Tuple;
+        /** @return whether the runtime filters let the table row `row` pass */
+        auto PassesRuntimeFilters(const Tuple &row) const -> bool;
+
         /** The index scan plan node to be executed. */
         const IndexScanPlanNode *plan_;
-        BPlusTreeIndexForTwoIntegerColumn *tree_;
-        BPlusTreeIndexIteratorForTwoIntegerColumn iter_;
+        IndexInfo *index_info_;
         TableInfo *tableInfo;
+        /** Full scan: the ordered iterator over the B+ tree. */
+        std::unique_ptr<BPlusTreeIndexIteratorForTwoIntegerColumn> iter_;
+        /** Point lookup: the rids matching the key and the next one to emit. */
+        std::vector<RID> rids_;
+        size_t rid_cursor_{0};
+        /** The runtime filters pushed by joins above, on table columns */
+        std::vector<RuntimeFilterProbe> runtime_filters_;
 
     };
 }  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -51,6 +52,9 @@ namespace bustub {
         /** The nested index join plan node. */
         const NestedIndexJoinPlanNode *plan_;
         std::unique_ptr<AbstractExecutor> child_exe_;
-        BPlusTreeIndexForTwoIntegerColumn *tree_;
+        /** The inner index, probed through Index::ScanKey so both B+ tree and hash indexes work. */
+        Index *index_;
+        /** Joined tuples of the current outer tuple that have not been emitted yet. */
+        std::deque<Tuple> pending_;
     };
 }  // namespace bustub
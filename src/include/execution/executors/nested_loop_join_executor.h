@@ -17,6 +17,7 @@
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/compiled_expression.h"
 #include "execution/plans/nested_loop_join_plan.h"
 #include "storage/table/tuple.h"
 
@@ -59,6 +60,8 @@ namespace bustub {
         std::vector<Tuple> right_tuple_;
         int right_idx{-1};
         Tuple left_tuple_;
+        /** The join predicate, compiled once in Init() */
+        CompiledPredicate predicate_;
     };
 
 }  // namespace bustub
@@ -20,6 +20,7 @@
 #include "execution/plans/projection_plan.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "storage/table/tuple.h"
+#include "type/column_vector.h"
 
 namespace bustub {
 
@@ -47,6 +48,11 @@ class ProjectionExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the projection, processing a whole batch of child tuples at a time.
+   */
+  auto NextBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size) -> bool override;
+
   /** @return The output schema for the projection plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -56,5 +62,10 @@ class ProjectionExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** Buffers for the batch pulled from the child */
+  std::vector<Tuple> child_tuples_;
+  std::vector<RID> child_rids_;
+  /** One evaluated column per projected expression */
+  std::vector<ColumnVector> columns_;
 };
 }  // namespace bustub
@@ -12,17 +12,27 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/compiled_expression.h"
+#include "execution/parallel_table_scan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/runtime_filter.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * Rows are filtered in place on the pinned page and only copied out when they pass, narrowed to the columns of the
+ * plan, and pages whose zone map rules out the filter are skipped. Runtime filters pushed by hash joins drop rows
+ * the same way. With more than one execution
+ * thread, tables of several morsels are read by a ParallelTableScan, otherwise the table is read a page at a time.
+ * Either way row locks are taken on the gathered rows, after the page latch was released.
  */
 	class SeqScanExecutor : public AbstractExecutor {
 	public:
@@ -44,13 +54,43 @@ namespace bustub {
 		 */
 		auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+		/**
+		 * Yield the next batch of tuples from the sequential scan, applying the
+		 * pushed-down filter and taking row locks as the iterator advances.
+		 */
+		auto NextBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size) -> bool override;
+
+		/** Applies the runtime filter to the rows in place, and to the pages through their zone maps */
+		auto PushRuntimeFilter(const RuntimeFilterProbe &probe) -> bool override;
+
 		/** @return The output schema for the sequential scan */
 		auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
 
 	private:
+		/** Produces the gathered rows, locking them first if `need_lock` */
+		auto GatherBatch(std::vector<Tuple> *tuples, std::vector<RID> *rids, size_t batch_size,
+						 LockManager::LockMode lock_mode, bool need_lock) -> bool;
+		/** Gathers the rows of the next morsel of scan_, or of the next page of iter_. @return `false` at the end */
+		auto FillGathered() -> bool;
+
 		/** The sequential scan plan node to be executed */
 		const SeqScanPlanNode *plan_;
 		std::optional<TableIterator> iter_;
+		/** The parallel scan replacing iter_ on large tables */
+		std::unique_ptr<ParallelTableScan> scan_;
+		/** The rows of the morsel or page being gathered, and the next of them to produce */
+		std::vector<Tuple> gathered_tuples_;
+		std::vector<RID> gathered_rids_;
+		size_t gathered_pos_{0};
+		const TableInfo *table_info_{nullptr};
+		/** The pushed-down filter, compiled once in Init() */
+		CompiledPredicate filter_;
+		/** The part of the filter page zone maps can answer, empty if it cannot rule out any page */
+		ZoneMapFilter zone_filter_;
+		/** The runtime filters pushed by joins above, on table columns */
+		std::vector<RuntimeFilterProbe> runtime_filters_;
+		/** The columns the plan reads, the filter sees whole rows */
+		ScanProjection projection_;
 	};
 }  // namespace bustub
@@ -17,6 +17,7 @@
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/external_sorter.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/sort_plan.h"
 #include "storage/table/tuple.h"
@@ -25,6 +26,9 @@ namespace bustub {
 
 /**
  * The SortExecutor executor executes a sort.
+ *
+ * The ORDER BY values of every tuple are encoded once into a normalized key (see SortKeyEncoder), and the tuples
+ * are sorted on those keys by an ExternalSorter, which spills sorted runs to temp pages past the memory limit.
  */
     class SortExecutor : public AbstractExecutor {
     public:
@@ -54,7 +58,6 @@ namespace bustub {
         /** The sort plan node to be executed */
         const SortPlanNode *plan_;
         std::unique_ptr<AbstractExecutor> child_executor_;
-        std::vector<Tuple> tuples;
-        std::vector<Tuple>::iterator iter;
+        std::unique_ptr<ExternalSorter> sorter_;
     };
 }  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -26,6 +27,10 @@ namespace bustub {
 
 /**
  * The TopNExecutor executor executes a topn.
+ *
+ * Rows are keyed on normalized sort keys (see SortKeyEncoder) and gathered into a buffer. Whenever the buffer holds
+ * TOPN_BUFFER_ROWS rows more than N, it is sorted with ParallelSort and cut back to the best N; rows whose key does
+ * not beat the current N-th key are dropped without being buffered.
  */
 	class TopNExecutor : public AbstractExecutor {
 	public:
@@ -64,8 +69,17 @@ namespace bustub {
 		const TopNPlanNode *plan_;
 		/** The child executor from which tuples are obtained */
 		std::unique_ptr<AbstractExecutor> child_executor_;
-		std::vector<Tuple> tuples;
-		std::vector<Tuple>::iterator iter;
+		struct Entry {
+			std::string key_;
+			Tuple tuple_;
+		};
+		/** Sorts the gathered rows and keeps the best N */
+		void CutBack();
+
+		std::vector<Entry> entries_;
+		/** The number of rows kept as the current top N */
+		size_t num_in_heap_{0};
+		size_t cursor_{0};
 
 	};
 }  // namespace bustub
@@ -20,6 +20,7 @@
 #include "catalog/schema.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
+#include "type/column_vector.h"
 
 #define BUSTUB_EXPR_CLONE_WITH_CHILDREN(cname)                                                                   \
   auto CloneWithChildren(std::vector<AbstractExpressionRef> children) const->std::unique_ptr<AbstractExpression> \
@@ -65,6 +66,20 @@ class AbstractExpression {
   virtual auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                             const Schema &right_schema) const -> Value = 0;
 
+  /**
+   * Evaluates the expression over a whole batch of tuples into a column vector, one row per tuple.
+   * The default goes through Evaluate() row by row; expressions with vectorized kernels override it.
+   * @param tuples The batch of tuples
+   * @param schema The schema of the tuples
+   * @param[out] result The evaluated column, of type GetReturnType()
+   */
+  virtual void EvaluateBatch(const std::vector<Tuple> &tuples, const Schema &schema, ColumnVector *result) const {
+    result->Reset(GetReturnType(), 0);
+    for (const auto &tuple : tuples) {
+      result->Append(Evaluate(&tuple, schema));
+    }
+  }
+
   /** @return the child_idx'th child of this expression */
   auto GetChildAt(uint32_t child_idx) const -> const AbstractExpressionRef & { return children_[child_idx]; }
 
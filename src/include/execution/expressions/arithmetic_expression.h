@@ -21,6 +21,7 @@
 #include "common/exception.h"
 #include "common/macros.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/vector_kernels.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
 #include "type/type_id.h"
@@ -65,6 +66,14 @@ class ArithmeticExpression : public AbstractExpression {
     return ValueFactory::GetIntegerValue(*res);
   }
 
+  void EvaluateBatch(const std::vector<Tuple> &tuples, const Schema &schema, ColumnVector *result) const override {
+    ColumnVector lhs;
+    ColumnVector rhs;
+    GetChildAt(0)->EvaluateBatch(tuples, schema, &lhs);
+    GetChildAt(1)->EvaluateBatch(tuples, schema, &rhs);
+    ArithmeticKernel(lhs, rhs, compute_type_, result);
+  }
+
   /** @return the string representation of the expression node and its children */
   auto ToString() const -> std::string override {
     return fmt::format("({}{}{})", *GetChildAt(0), compute_type_, *GetChildAt(1));
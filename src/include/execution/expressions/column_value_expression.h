@@ -45,6 +45,10 @@ class ColumnValueExpression : public AbstractExpression {
                            : right_tuple->GetValue(&right_schema, col_idx_);
   }
 
+  void EvaluateBatch(const std::vector<Tuple> &tuples, const Schema &schema, ColumnVector *result) const override {
+    result->LoadColumn(tuples, schema, col_idx_);
+  }
+
   auto GetTupleIdx() const -> uint32_t { return tuple_idx_; }
   auto GetColIdx() const -> uint32_t { return col_idx_; }
 
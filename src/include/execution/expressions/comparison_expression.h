@@ -18,6 +18,8 @@
 
 #include "catalog/schema.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/vector_kernels.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
@@ -49,6 +51,26 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  void EvaluateBatch(const std::vector<Tuple> &tuples, const Schema &schema, ColumnVector *result) const override {
+    ColumnVector lhs;
+    GetChildAt(0)->EvaluateBatch(tuples, schema, &lhs);
+    // `column op constant` compares against the constant directly instead of broadcasting it
+    const auto *constant = dynamic_cast<const ConstantValueExpression *>(GetChildAt(1).get());
+    if (constant != nullptr && CompareConstantKernel(lhs, constant->val_, comp_type_, result)) {
+      return;
+    }
+    ColumnVector rhs;
+    GetChildAt(1)->EvaluateBatch(tuples, schema, &rhs);
+    if (CompareKernel(lhs, rhs, comp_type_, result)) {
+      return;
+    }
+    // no kernel for these operand types (VARCHAR, mixed numeric types), compare through Value
+    result->Reset(TypeId::BOOLEAN, 0);
+    for (size_t i = 0; i < tuples.size(); i++) {
+      result->Append(ValueFactory::GetBooleanValue(PerformComparison(lhs.GetValue(i), rhs.GetValue(i))));
+    }
+  }
+
   /** @return the string representation of the expression node and its children */
   auto ToString() const -> std::string override {
     return fmt::format("({}{}{})", *GetChildAt(0), comp_type_, *GetChildAt(1));
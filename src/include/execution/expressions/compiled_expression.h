@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression.h
+//
+// Identification: src/include/execution/expressions/compiled_expression.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <utility>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
+#include "type/type.h"
+
+namespace bustub {
+
+/**
+ * CompiledPredicate is a boolean expression tree turned into a closure once, before execution starts.
+ *
+ * Comparisons of a fixed-width column against a constant or another column of the same type are specialized
+ * on the column type and the operator: they read the raw bytes out of the tuple, check the type's null sentinel
+ * and compare native values, without creating any Value or going through Type dispatch. AND / OR are compiled
+ * with three-valued logic and short-circuiting. Subtrees without a specialization fall back to Evaluate().
+ *
+ * Predicates read TupleViews, so rows can be filtered in place on a pinned page; the fallback materializes a view into
+ * a Tuple unless it views one.
+ *
+ * For single-tuple predicates the right tuple is ignored; for join predicates a ColumnValueExpression with
+ * tuple_idx 0 reads the left tuple and one with tuple_idx 1 reads the right tuple.
+ */
+class CompiledPredicate {
+ public:
+  using Function = std::function<CmpBool(const TupleView *left, const TupleView *right)>;
+
+  CompiledPredicate() = default;
+
+  /** Compiles a predicate evaluated against tuples of `schema`. */
+  static auto Compile(const AbstractExpressionRef &expr, const Schema &schema) -> CompiledPredicate;
+
+  /** Compiles a join predicate evaluated against a left tuple of `left_schema` and a right tuple of `right_schema`. */
+  static auto CompileJoin(const AbstractExpressionRef &expr, const Schema &left_schema, const Schema &right_schema)
+      -> CompiledPredicate;
+
+  /** @return the three-valued result of the predicate */
+  auto Evaluate(const TupleView *tuple) const -> CmpBool { return fn_(tuple, tuple); }
+  auto Evaluate(const Tuple *tuple) const -> CmpBool {
+    TupleView view(*tuple);
+    return Evaluate(&view);
+  }
+  auto EvaluateJoin(const TupleView *left, const TupleView *right) const -> CmpBool { return fn_(left, right); }
+  auto EvaluateJoin(const Tuple *left, const Tuple *right) const -> CmpBool {
+    TupleView left_view(*left);
+    TupleView right_view(*right);
+    return EvaluateJoin(&left_view, &right_view);
+  }
+
+  /** @return whether the predicate holds, i.e. is neither false nor NULL */
+  auto Matches(const TupleView *tuple) const -> bool { return Evaluate(tuple) == CmpBool::CmpTrue; }
+  auto Matches(const Tuple *tuple) const -> bool { return Evaluate(tuple) == CmpBool::CmpTrue; }
+  auto MatchesJoin(const Tuple *left, const Tuple *right) const -> bool {
+    return EvaluateJoin(left, right) == CmpBool::CmpTrue;
+  }
+
+  /** @return whether the predicate was set up by Compile / CompileJoin */
+  auto IsValid() const -> bool { return static_cast<bool>(fn_); }
+
+  /** @return how many comparisons got a specialized implementation, for tests */
+  auto NumSpecialized() const -> size_t { return num_specialized_; }
+
+ private:
+  CompiledPredicate(Function fn, size_t num_specialized) : fn_(std::move(fn)), num_specialized_(num_specialized) {}
+
+  Function fn_;
+  size_t num_specialized_{0};
+};
+
+/**
+ * Compiles the part of a scan predicate that zone maps can answer: comparisons of a tracked column of `schema` with a
+ * constant of the same type, combined with AND / OR. Other subtrees may match any page.
+ * @return a filter that is `false` for pages where the predicate cannot hold, or an empty function if no page can be
+ * ruled out
+ */
+auto CompileZoneMapFilter(const AbstractExpressionRef &expr, const Schema &schema, const ZoneMap::Layout &layout)
+    -> ZoneMapFilter;
+
+}  // namespace bustub
@@ -34,6 +34,10 @@ class ConstantValueExpression : public AbstractExpression {
     return val_;
   }
 
+  void EvaluateBatch(const std::vector<Tuple> &tuples, const Schema &schema, ColumnVector *result) const override {
+    result->Broadcast(val_, tuples.size());
+  }
+
   /** @return the string representation of the plan node and its children */
   auto ToString() const -> std::string override { return val_.ToString(); }
 
@@ -20,6 +20,7 @@
 #include "common/exception.h"
 #include "common/macros.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/vector_kernels.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
 #include "type/type.h"
@@ -57,6 +58,14 @@ class LogicExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComputation(lhs, rhs));
   }
 
+  void EvaluateBatch(const std::vector<Tuple> &tuples, const Schema &schema, ColumnVector *result) const override {
+    ColumnVector lhs;
+    ColumnVector rhs;
+    GetChildAt(0)->EvaluateBatch(tuples, schema, &lhs);
+    GetChildAt(1)->EvaluateBatch(tuples, schema, &rhs);
+    LogicKernel(lhs, rhs, logic_type_, result);
+  }
+
   /** @return the string representation of the expression node and its children */
   auto ToString() const -> std::string override {
     return fmt::format("({}{}{})", *GetChildAt(0), logic_type_, *GetChildAt(1));
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vector_kernels.h
+//
+// Identification: src/include/execution/expressions/vector_kernels.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "type/column_vector.h"
+#include "type/value.h"
+
+namespace bustub {
+
+enum class ComparisonType;
+enum class ArithmeticType;
+enum class LogicType;
+
+/**
+ * Vectorized kernels used by AbstractExpression::EvaluateBatch. Each kernel runs over whole ColumnVectors and
+ * has an AVX2 implementation, picked at runtime when the CPU supports it, and a portable scalar fallback.
+ * Null handling is done on the null masks, so the kernels never see the types' null sentinels.
+ */
+
+/**
+ * Computes `lhs op rhs` for every row into a BOOLEAN vector.
+ * @return false if there is no kernel for the operand types (the caller then compares through Value)
+ */
+auto CompareKernel(const ColumnVector &lhs, const ColumnVector &rhs, ComparisonType op, ColumnVector *result) -> bool;
+
+/**
+ * Computes `lhs op rhs` for every row of `lhs` against a constant into a BOOLEAN vector.
+ * @return false if there is no kernel for the operand types
+ */
+auto CompareConstantKernel(const ColumnVector &lhs, const Value &rhs, ComparisonType op, ColumnVector *result)
+    -> bool;
+
+/** Computes `lhs op rhs` for every row of two INTEGER vectors. */
+void ArithmeticKernel(const ColumnVector &lhs, const ColumnVector &rhs, ArithmeticType op, ColumnVector *result);
+
+/** Combines two BOOLEAN vectors with three-valued AND / OR. */
+void LogicKernel(const ColumnVector &lhs, const ColumnVector &rhs, LogicType op, ColumnVector *result);
+
+/** Collects the indexes of the rows of a BOOLEAN vector that are true (not false and not null). */
+void SelectTrue(const ColumnVector &predicate, SelectionVector *selection);
+
+/** @return whether the kernels currently dispatch to their AVX2 implementations */
+auto SimdKernelsEnabled() -> bool;
+
+/** Forces the scalar kernels (`false`) or re-enables AVX2 when the CPU supports it (`true`). */
+void SetSimdKernelsEnabled(bool enabled);
+
+}  // namespace bustub
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sorter.h
+//
+// Identification: src/include/execution/external_sorter.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/table/tmp_tuple_heap.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * ExternalSorter sorts tuples on normalized keys (see SortKeyEncoder) within a memory budget.
+ *
+ * Tuples are gathered into a run until the run exceeds the budget; the run is then sorted and spilled to temp
+ * pages. Once all tuples are added, the runs are merged with a k-way merge, in several passes if there are more
+ * runs than the budget has room for one page of each. Keys are compared with memcmp only, and equal keys keep the
+ * order they were added in. Without a buffer pool, or if everything fits, the sort stays in memory.
+ *
+ * Runs are sorted with ParallelSort on up to `num_threads` threads.
+ */
+class ExternalSorter {
+ public:
+  ExternalSorter(BufferPoolManager *bpm, size_t memory_limit, size_t num_threads);
+
+  ~ExternalSorter();
+
+  DISALLOW_COPY_AND_MOVE(ExternalSorter);
+
+  /** Adds a tuple with its normalized key. Must not be called after Finish(). */
+  void Add(std::string key, Tuple tuple);
+
+  /** Sorts what was added, after which Next() hands out the tuples in order. */
+  void Finish();
+
+  /** @return `false` once every tuple was handed out */
+  auto Next(Tuple *tuple) -> bool;
+
+  /** @return the number of runs spilled to temp pages */
+  auto NumSpilledRuns() const -> size_t { return num_spilled_runs_; }
+
+ private:
+  struct Entry {
+    std::string key_;
+    Tuple tuple_;
+  };
+  class RunReader;
+  class Merger;
+
+  /** Sorts the run being gathered and spills it */
+  void SpillRun();
+  /** Sorts the run being gathered in place */
+  void SortRun();
+
+  BufferPoolManager *bpm_;
+  size_t memory_limit_;
+  size_t num_threads_;
+  std::vector<Entry> run_;
+  size_t run_bytes_{0};
+  std::vector<std::unique_ptr<TmpTupleHeap>> spilled_runs_;
+  size_t num_spilled_runs_{0};
+
+  /** Set by Finish(): the in-memory result, or the merge of the spilled runs */
+  size_t cursor_{0};
+  std::unique_ptr<Merger> merger_;
+};
+
+}  // namespace bustub
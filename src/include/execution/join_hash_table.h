@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table.h
+//
+// Identification: src/include/execution/join_hash_table.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/util/hash_util.h"
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * RadixJoinHashTable is the build side of an equi-join.
+ *
+ * The build rows are stored once. Their keys are evaluated and hashed once, and the rows are then radix-partitioned
+ * on the high bits of the hash so that every partition's table stays cache sized. Each partition is a linear-probing
+ * table of compact entries (hash, key, build row index). A single integral key is stored in the entry itself and
+ * compared directly; other keys are kept as Values next to the rows and only compared on a full hash match.
+ *
+ * Build and probe both run across partitions on up to `num_threads` threads. Rows with a NULL key never match.
+ */
+class RadixJoinHashTable {
+ public:
+  /** Build row index reported for a probe row without any match */
+  static constexpr uint32_t NO_MATCH = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @param build_keys the key expressions evaluated against the build rows
+   * @param build_schema the schema of the build rows
+   * @param probe_keys the key expressions evaluated against the probe rows, one per build key
+   * @param probe_schema the schema of the probe rows
+   * @param num_threads the number of threads build and probe may use
+   */
+  RadixJoinHashTable(std::vector<AbstractExpressionRef> build_keys, const Schema *build_schema,
+                     std::vector<AbstractExpressionRef> probe_keys, const Schema *probe_schema, size_t num_threads);
+
+  /** Replaces the contents of the table with `rows`. */
+  void Build(std::vector<Tuple> &&rows);
+
+  /**
+   * Probes the table with a chunk of rows.
+   * @param probe the probe rows
+   * @param keep_unmatched whether probe rows without a match are reported, paired with NO_MATCH
+   * @param[out] matches (probe row index, build row index) pairs, ordered by probe row and then by build row
+   */
+  void Probe(const std::vector<Tuple> &probe, bool keep_unmatched,
+             std::vector<std::pair<uint32_t, uint32_t>> *matches) const;
+
+  /** @return the build row at `row` */
+  auto GetBuildRow(uint32_t row) const -> const Tuple & { return rows_[row]; }
+
+  /** @return the number of build rows */
+  auto Size() const -> size_t { return rows_.size(); }
+
+  /** @return the number of radix partitions */
+  auto NumPartitions() const -> size_t { return partitions_.size(); }
+
+ private:
+  struct Entry {
+    hash_t hash_;
+    int64_t key_;
+    /** NO_MATCH for an empty slot */
+    uint32_t row_;
+  };
+
+  struct Partition {
+    std::vector<Entry> slots_;
+    hash_t mask_{0};
+  };
+
+  /** Keys and hashes of a batch of rows */
+  struct KeyBatch {
+    std::vector<hash_t> hashes_;
+    /** The integral keys if IsIntegral(), otherwise empty */
+    std::vector<int64_t> int_keys_;
+    /** num_rows * num_keys Values if not IsIntegral(), otherwise empty */
+    std::vector<Value> keys_;
+    /** 0 for a row with a NULL key */
+    std::vector<uint8_t> valid_;
+  };
+
+  auto IsIntegral() const -> bool { return integral_; }
+  auto PartitionOf(hash_t hash) const -> size_t { return radix_bits_ == 0 ? 0 : hash >> (64 - radix_bits_); }
+  void ComputeKeys(const std::vector<Tuple> &rows, const std::vector<AbstractExpressionRef> &exprs,
+                   const Schema &schema, KeyBatch *batch) const;
+  /** Groups the valid rows of `batch` by partition: partition p owns (*order)[(*offsets)[p], (*offsets)[p + 1]) */
+  void Scatter(const KeyBatch &batch, std::vector<uint32_t> *order, std::vector<size_t> *offsets) const;
+  auto KeysEqual(const KeyBatch &probe, uint32_t probe_row, uint32_t build_row) const -> bool;
+
+  std::vector<AbstractExpressionRef> build_exprs_;
+  const Schema *build_schema_;
+  std::vector<AbstractExpressionRef> probe_exprs_;
+  const Schema *probe_schema_;
+  size_t num_threads_;
+  /** Whether there is a single key of integral type on both sides */
+  bool integral_{false};
+
+  std::vector<Tuple> rows_;
+  KeyBatch build_keys_;
+  size_t radix_bits_{0};
+  std::vector<Partition> partitions_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_table_scan.h
+//
+// Identification: src/include/execution/parallel_table_scan.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <exception>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "common/rid.h"
+#include "common/task_scheduler.h"
+#include "execution/expressions/compiled_expression.h"
+#include "execution/runtime_filter.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/** The columns of a table a scan produces. Rows are read in place and only these columns are copied out. */
+struct ScanProjection {
+  const Schema *table_schema_{nullptr};
+  const Schema *output_schema_{nullptr};
+  /** The table columns to produce, in order; empty to produce whole rows */
+  std::vector<uint32_t> column_ids_;
+
+  auto Materialize(const TupleView &view) const -> Tuple {
+    return column_ids_.empty() ? view.ToTuple() : view.Project(*table_schema_, *output_schema_, column_ids_);
+  }
+};
+
+/**
+ * ParallelTableScan reads a TableHeap on several threads, morsel by morsel.
+ *
+ * The page chain is walked once up front and cut into morsels of MORSEL_PAGES consecutive pages. Up to `num_threads`
+ * tasks on the TaskScheduler of the creating thread claim the next morsel from a shared dispenser as soon as they are
+ * done with the previous one, so that slow morsels do not hold up the others, and apply the filter to the rows they
+ * read. The rows are gathered back in table order on the calling thread, so the scan feeds single-threaded parents
+ * unchanged. Tasks run at most WINDOW_PER_THREAD morsels per thread ahead of the gatherer, which bounds the memory the
+ * gathered rows take; a task that runs into the window ends, and the gatherer queues new ones as it moves on. Without
+ * a scheduler the morsels are scanned by the gatherer itself.
+ *
+ * Like TableHeap::MakeIterator(), the scan stops at the last tuple that existed when it was created. Deleted rows are
+ * skipped. Rows are filtered in place and only the columns of the ScanProjection are copied out. Pages ruled out by
+ * their zone map are not read at all: only the last page of the snapshot takes inserts, and the tuples of it the scan
+ * reads are covered by its zone map already. No locks are taken; callers that need row locks take them on the
+ * gathered rows.
+ */
+class ParallelTableScan {
+ public:
+  /** Pages per morsel */
+  static constexpr size_t MORSEL_PAGES = 16;
+  /** Morsels per worker that may be scanned but not gathered yet */
+  static constexpr size_t WINDOW_PER_THREAD = 2;
+
+  /**
+   * Snapshots the pages of `table`. No task is queued before the first Next().
+   * @param table the table to scan
+   * @param filter the rows to produce, may be invalid to produce every row
+   * @param num_threads the number of tasks scanning at once
+   * @param projection the columns to produce, nullptr to produce whole rows
+   * @param zone_filter skips the pages whose zone map rules out the filter, nullptr or empty to read every page
+   * @param runtime_filters further rows to drop, on columns of the table schema of `projection`; nullptr for none
+   * The filters are read once the scan starts, so they may still change until the first Next().
+   */
+  ParallelTableScan(TableHeap *table, const CompiledPredicate *filter, size_t num_threads,
+                    const ScanProjection *projection = nullptr, const ZoneMapFilter *zone_filter = nullptr,
+                    const std::vector<RuntimeFilterProbe> *runtime_filters = nullptr);
+
+  /** Stops the tasks and waits for them to end */
+  ~ParallelTableScan();
+
+  DISALLOW_COPY_AND_MOVE(ParallelTableScan);
+
+  /** @return the number of morsels of the table */
+  auto NumMorsels() const -> size_t { return (page_ids_.size() + MORSEL_PAGES - 1) / MORSEL_PAGES; }
+
+  /**
+   * Gathers the rows of the next morsel that pass the filter. A morsel may have no such rows.
+   * @param[out] tuples the rows, replacing the previous contents
+   * @param[out] rids the RIDs of the rows
+   * @return `false` once every morsel was gathered
+   * @throw the first exception a task ran into
+   */
+  auto Next(std::vector<Tuple> *tuples, std::vector<RID> *rids) -> bool;
+
+ private:
+  /** The rows of a scanned morsel */
+  struct Slot {
+    bool ready_{false};
+    std::vector<Tuple> tuples_;
+    std::vector<RID> rids_;
+  };
+
+  /** Claims and scans morsels until none can be claimed */
+  void Work();
+  void ScanMorsel(size_t morsel, Slot *slot) const;
+  /** Queues tasks for the morsels that can be claimed, up to num_threads_ running tasks. Requires latch_ */
+  void SpawnTasks();
+  /** Runs queued tasks until `done` holds. Requires `lock` */
+  template <typename Predicate>
+  void HelpUntil(std::unique_lock<std::mutex> *lock, const Predicate &done);
+
+  TableHeap *table_;
+  const CompiledPredicate *filter_;
+  const ScanProjection *projection_;
+  const ZoneMapFilter *zone_filter_;
+  const std::vector<RuntimeFilterProbe> *runtime_filters_;
+  size_t num_threads_;
+  TaskScheduler *scheduler_;
+  std::vector<page_id_t> page_ids_;
+  /** The tuples of the last page when the scan was created */
+  uint32_t last_page_tuples_{0};
+
+  std::mutex latch_;
+  /** The next morsel to hand out and to gather */
+  size_t next_morsel_{0};
+  size_t next_gathered_{0};
+  /** The morsels in flight, morsel i is in slot i % slots_.size() */
+  std::vector<Slot> slots_;
+  size_t num_tasks_{0};
+  bool stop_{false};
+  std::exception_ptr error_;
+};
+
+}  // namespace bustub
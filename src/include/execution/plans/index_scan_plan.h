@@ -14,6 +14,7 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "catalog/catalog.h"
 #include "execution/expressions/abstract_expression.h"
@@ -21,17 +22,19 @@
 
 namespace bustub {
 /**
- * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
+ * IndexScanPlanNode identifies a table that should be scanned through an index. Without a key it walks the whole
+ * (ordered) index; with a key it is a point lookup of `indexed column = key`.
  */
 class IndexScanPlanNode : public AbstractPlanNode {
  public:
   /**
    * Creates a new index scan plan node.
    * @param output The output format of this scan plan node
-   * @param table_oid The identifier of table to be scanned
+   * @param index_oid The identifier of the index to be scanned
+   * @param pred_key The constant to probe the index with, or nullptr for a full index scan
    */
-  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
-      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, AbstractExpressionRef pred_key = nullptr)
+      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid), pred_key_(std::move(pred_key)) {}
 
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
@@ -43,11 +46,22 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** The key of a point lookup, nullptr when the whole index is scanned. */
+  AbstractExpressionRef pred_key_;
+
+  /** The columns of the table the scan produces, in order, set by the PruneColumns rule. Empty for every column. */
+  std::vector<uint32_t> column_ids_;
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    std::string columns;
+    if (!column_ids_.empty()) {
+      columns = fmt::format(", column_ids=[{}]", fmt::join(column_ids_, ", "));
+    }
+    if (pred_key_ != nullptr) {
+      return fmt::format("IndexScan {{ index_oid={}, pred_key={}{} }}", index_oid_, pred_key_, columns);
+    }
+    return fmt::format("IndexScan {{ index_oid={}{} }}", index_oid_, columns);
   }
 };
 
@@ -15,6 +15,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "binder/table_ref/bound_base_table_ref.h"
 #include "catalog/catalog.h"
@@ -62,12 +63,20 @@ class SeqScanPlanNode : public AbstractPlanNode {
   */
   AbstractExpressionRef filter_predicate_;
 
+  /** The columns of the table the scan produces, in order, set by the PruneColumns rule. Empty for every column.
+      The filter predicate still refers to the columns of the table. */
+  std::vector<uint32_t> column_ids_;
+
  protected:
   auto PlanNodeToString() const -> std::string override {
+    std::string columns;
+    if (!column_ids_.empty()) {
+      columns = fmt::format(", column_ids=[{}]", fmt::join(column_ids_, ", "));
+    }
     if (filter_predicate_) {
-      return fmt::format("SeqScan {{ table={}, filter={} }}", table_name_, filter_predicate_);
+      return fmt::format("SeqScan {{ table={}, filter={}{} }}", table_name_, filter_predicate_, columns);
     }
-    return fmt::format("SeqScan {{ table={} }}", table_name_);
+    return fmt::format("SeqScan {{ table={}{} }}", table_name_, columns);
   }
 };
 
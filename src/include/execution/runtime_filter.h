@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.h
+//
+// Identification: src/include/execution/runtime_filter.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/util/hash_util.h"
+#include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * RuntimeFilter summarizes the join keys of the build side of a hash join, so that the probe side can drop rows that
+ * cannot find a match before they are copied, locked or probed.
+ *
+ * It is a blocked Bloom filter over the key hashes: every key sets a few bits of a single 64-bit word. A single
+ * integral key also keeps its minimum and maximum, which are checked first and let scans skip whole pages through
+ * their zone maps. Keys with a NULL column never match and are left out. The filter may let non-matching keys pass,
+ * but never drops a matching one.
+ *
+ * Keys are added with Insert() and the filter is sealed with Seal() before it is read; it is immutable afterwards and
+ * may be read by several threads.
+ */
+class RuntimeFilter {
+ public:
+  /** Bloom filter bits per build key */
+  static constexpr size_t BITS_PER_KEY = 16;
+  /** Build sides with more keys get no filter: it would not fit in the cache and would hardly drop anything */
+  static constexpr size_t MAX_KEYS = 1 << 22;
+
+  /** @return whether build keys of `build_type` can filter probe keys of `probe_type`: equal keys hash alike */
+  static auto SupportsTypes(TypeId build_type, TypeId probe_type) -> bool;
+
+  /** Adds the key of a build row */
+  void Insert(const std::vector<Value> &key);
+
+  /** Builds the Bloom filter from the inserted keys */
+  void Seal();
+
+  /** @return `false` if no build row has `key` */
+  auto MayContain(const std::vector<Value> &key) const -> bool;
+
+  /** @return the number of keys inserted, NULL keys left out */
+  auto NumKeys() const -> size_t { return num_keys_; }
+
+  /** @return the smallest and largest key, if the key is a single integral column and there is a key */
+  auto GetRange() const -> std::optional<std::pair<int64_t, int64_t>>;
+
+ private:
+  /** @return the hash of `key`, or nullopt if a column is NULL */
+  static auto HashKey(const std::vector<Value> &key) -> std::optional<hash_t>;
+  /** @return the bits `hash` sets in its word */
+  static auto BitsOf(hash_t hash) -> uint64_t;
+
+  size_t num_keys_{0};
+  /** The key hashes until the filter is sealed */
+  std::vector<hash_t> pending_;
+  std::vector<uint64_t> words_;
+  /** Whether every key so far was a single integral column, and their range */
+  bool integral_{true};
+  int64_t min_{std::numeric_limits<int64_t>::max()};
+  int64_t max_{std::numeric_limits<int64_t>::min()};
+};
+
+/** A runtime filter pushed into a scan, on columns of the rows the scan reads */
+struct RuntimeFilterProbe {
+  std::shared_ptr<const RuntimeFilter> filter_;
+  /** The columns of the scanned rows that make up the key, in key order */
+  std::vector<uint32_t> columns_;
+
+  /** @return the probe on the table columns of a scan producing `column_ids`, empty if it produces whole rows */
+  auto OnTableColumns(const std::vector<uint32_t> &column_ids) const -> RuntimeFilterProbe {
+    RuntimeFilterProbe probe{filter_, columns_};
+    if (!column_ids.empty()) {
+      for (auto &col : probe.columns_) {
+        col = column_ids[col];
+      }
+    }
+    return probe;
+  }
+
+  /** @return `false` if `row`, a row of `schema`, cannot match any build row */
+  auto MayMatch(const TupleView &row, const Schema &schema) const -> bool;
+
+  /** @return `false` if any of `probes` rules `row` out */
+  static auto AllMayMatch(const std::vector<RuntimeFilterProbe> &probes, const TupleView &row, const Schema &schema)
+      -> bool {
+    for (const auto &probe : probes) {
+      if (!probe.MayMatch(row, schema)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @return a zone map filter ruling out the pages whose range of the key column misses the key range of the filter,
+   * or an empty function if the filter has no range or the column is not tracked by `layout`
+   */
+  auto MakeZoneMapFilter(const ZoneMap::Layout &layout) const -> ZoneMapFilter;
+};
+
+}  // namespace bustub
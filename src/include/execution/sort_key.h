@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.h
+//
+// Identification: src/include/execution/sort_key.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * SortKeyEncoder turns the ORDER BY values of a tuple into a normalized key: a byte string whose memcmp order is
+ * the order the tuples are sorted in. Sorting then evaluates the ORDER BY expressions once per tuple instead of
+ * on every comparison.
+ *
+ * Every value is encoded as a NULL marker byte followed by an order-preserving encoding of the value: integers
+ * big-endian with the sign bit flipped, doubles with the IEEE bits adjusted to compare as unsigned integers, and
+ * strings with their 0x00 bytes escaped and a 0x00 0x00 terminator, so that no encoding is a prefix of another.
+ * NULL sorts before every other value. For DESC all the bytes of the value are inverted.
+ */
+class SortKeyEncoder {
+ public:
+  SortKeyEncoder(std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys, const Schema *schema)
+      : order_bys_(std::move(order_bys)), schema_(schema) {}
+
+  /** Appends the normalized key of `tuple` to `key`. */
+  void Encode(const Tuple &tuple, std::string *key) const;
+
+  /** Appends the normalized encoding of `val` to `key`. */
+  static void EncodeValue(const Value &val, bool descending, std::string *key);
+
+  /** Decodes the ascending encoding of a value of type `type` at `*data`, and moves `*data` past it. */
+  static auto DecodeValue(TypeId type, const char **data) -> Value;
+
+ private:
+  std::vector<std::pair<OrderByType, AbstractExpressionRef>> order_bys_;
+  const Schema *schema_;
+};
+
+}  // namespace bustub
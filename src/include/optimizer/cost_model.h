@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cost_model.h
+//
+// Identification: src/include/optimizer/cost_model.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "catalog/table_stats.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * CostModel estimates how many rows a plan produces and what the access paths and joins the optimizer chooses between
+ * cost. Estimates come from the statistics ANALYZE collected; tables that were never analyzed fall back to the size
+ * their name suggests (e.g. `t_1m`) and are unknown otherwise, in which case the optimizer keeps its heuristics.
+ *
+ * Costs are in units of reading one row of a table sequentially.
+ */
+class CostModel {
+ public:
+  /** Cost of reading a row of a table page by page */
+  static constexpr double SEQ_ROW_COST = 1;
+  /** Cost of a lookup in an index: the descent from the root, which mostly misses the buffer pool */
+  static constexpr double INDEX_PROBE_COST = 20;
+  /** Cost of fetching a row an index lookup found, a random page access */
+  static constexpr double INDEX_ROW_COST = 4;
+  /** Cost of inserting a row into the hash table of a hash join */
+  static constexpr double HASH_BUILD_ROW_COST = 2;
+  /** Cost of probing the hash table of a hash join with a row */
+  static constexpr double HASH_PROBE_ROW_COST = 1;
+
+  /** Selectivities of predicates without statistics to estimate them with */
+  static constexpr double DEFAULT_EQUAL_SELECTIVITY = 0.1;
+  static constexpr double DEFAULT_RANGE_SELECTIVITY = 1.0 / 3;
+  static constexpr double DEFAULT_SELECTIVITY = 0.5;
+
+  explicit CostModel(const Catalog &catalog) : catalog_(catalog) {}
+
+  /** @return the number of rows of a table, nullopt if it was never analyzed and its name does not tell */
+  auto TableRows(const std::string &table_name) const -> std::optional<double>;
+
+  /** @return the estimated number of rows `plan` produces, nullopt if it reads a table of unknown size */
+  auto EstimateRows(const AbstractPlanNode &plan) const -> std::optional<double>;
+
+  /** @return the estimated fraction of the rows produced by `plan` that satisfy `predicate` */
+  auto Selectivity(const AbstractExpression &predicate, const AbstractPlanNode &plan) const -> double;
+
+  /**
+   * @return the estimated fraction of the pairs of rows of `left` and `right` that satisfy a join predicate, which
+   * reads the left row as tuple 0 and the right one as tuple 1
+   */
+  auto JoinSelectivity(const AbstractExpression &predicate, const AbstractPlanNode &left,
+                       const AbstractPlanNode &right) const -> double;
+
+  /**
+   * @return the estimated fraction of the combinations of rows of `inputs` that satisfy a predicate, which reads the
+   * columns of all inputs one after the other as tuple 0
+   */
+  auto JoinSelectivity(const AbstractExpression &predicate, const std::vector<const AbstractPlanNode *> &inputs) const
+      -> double;
+
+  /** @return the estimated number of distinct values of column `col_idx` of the rows produced by `plan` */
+  auto DistinctValues(const AbstractPlanNode &plan, uint32_t col_idx) const -> std::optional<double>;
+
+  /** @return the cost of reading `rows` rows sequentially */
+  static auto SeqScanCost(double rows) -> double { return rows * SEQ_ROW_COST; }
+
+  /** @return the cost of `lookups` index lookups finding `rows` rows altogether */
+  static auto IndexLookupCost(double lookups, double rows) -> double {
+    return lookups * INDEX_PROBE_COST + rows * INDEX_ROW_COST;
+  }
+
+  /** @return the cost of a hash join building on `build_rows` rows and probing with `probe_rows` rows */
+  static auto HashJoinCost(double build_rows, double probe_rows) -> double {
+    return build_rows * HASH_BUILD_ROW_COST + probe_rows * HASH_PROBE_ROW_COST;
+  }
+
+ private:
+  /** @return the statistics of every column `plan` produces, nullptr where there are none */
+  auto ColumnStatsOf(const AbstractPlanNode &plan) const -> std::vector<const ColumnStats *>;
+
+  /**
+   * @return the selectivity of `predicate` over rows made of the columns in `columns`, where the columns of tuple 1
+   * start at `right_offset` and `column_rows` holds the rows of the input each column comes from
+   */
+  auto SelectivityOn(const AbstractExpression &predicate, const std::vector<const ColumnStats *> &columns,
+                     const std::vector<std::optional<double>> &column_rows, size_t right_offset) const -> double;
+
+  const Catalog &catalog_;
+};
+
+}  // namespace bustub
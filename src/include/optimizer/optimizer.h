@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -11,16 +12,19 @@
 #include "concurrency/transaction.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "optimizer/cost_model.h"
 
 namespace bustub {
 
+class ColumnValueExpression;
+
 /**
  * The optimizer takes an `AbstractPlanNode` and outputs an optimized `AbstractPlanNode`.
  */
 class Optimizer {
  public:
   explicit Optimizer(const Catalog &catalog, bool force_starter_rule)
-      : catalog_(catalog), force_starter_rule_(force_starter_rule) {}
+      : catalog_(catalog), force_starter_rule_(force_starter_rule), cost_model_(catalog) {}
 
   auto Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
@@ -43,8 +47,8 @@ class Optimizer {
 
   /**
    * @brief optimize nested loop join into hash join.
-   * In the starter code, we will check NLJs with exactly one equal condition. You can further support optimizing joins
-   * with multiple eq conditions.
+   * Every `<column> = <column>` conjunct comparing the two sides becomes a pair of join keys. The other conjuncts of an
+   * inner join are checked by a filter above the hash join; a left join with such conjuncts stays a nested loop join.
    */
   auto OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
@@ -53,6 +57,28 @@ class Optimizer {
    */
   auto OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief push the conjuncts of filters and join predicates down to the lowest plan node that produces the columns
+   * they read: into the sides of joins, through projections and sorts, and below aggregations when they only read the
+   * group-by keys. Below a left join only the conjuncts on its left side go, and the conjuncts of its predicate that
+   * read only the right side filter the right side. `a = b AND a < 5` also yields `b < 5` for inner joins.
+   */
+  auto OptimizePushDownPredicates(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /** @brief push `conjuncts`, which read the output of `plan`, and the ones in `plan` down into `plan` */
+  auto PushDownPredicates(const AbstractPlanNodeRef &plan, std::vector<AbstractExpressionRef> conjuncts)
+      -> AbstractPlanNodeRef;
+
+  /**
+   * @brief reorder trees of inner joins by their estimated cost.
+   * The inputs of the tree and the conjuncts of its join and filter predicates are collected. Conjuncts on one input
+   * become a filter on it, and the inputs are joined in the cheapest order found: by dynamic programming over the
+   * subsets of inputs connected by a predicate for small trees, greedily joining the cheapest pair for larger ones.
+   * Only trees of three or more inputs whose sizes can all be estimated are reordered. Must run before the rules that
+   * turn nested loop joins into hash or index joins, which pick up the join predicates left on the new joins.
+   */
+  auto OptimizeJoinOrder(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /**
    * @brief eliminate always true filter
    */
@@ -75,26 +101,63 @@ class Optimizer {
   auto RewriteExpressionForJoin(const AbstractExpressionRef &expr, size_t left_column_cnt, size_t right_column_cnt)
       -> AbstractExpressionRef;
 
+  /**
+   * @brief rewrite every column an expression reads with `remap`, e.g. to move it to another position of the rows, or
+   * to substitute the expression a projection computes it with
+   */
+  auto RemapColumns(const AbstractExpressionRef &expr,
+                    const std::function<AbstractExpressionRef(const ColumnValueExpression &)> &remap)
+      -> AbstractExpressionRef;
+
+  /** @brief collect the columns of tuple 0 an expression reads, once per time it reads them */
+  void CollectColumns(const AbstractExpression &expr, std::vector<uint32_t> *columns);
+
   /** @brief check if the predicate is true::boolean */
   auto IsPredicateTrue(const AbstractExpressionRef &expr) -> bool;
 
+  /** @brief split a predicate into the conjuncts it ANDs together, leaving out the ones that are always true */
+  auto SplitConjuncts(const AbstractExpressionRef &expr) -> std::vector<AbstractExpressionRef>;
+
+  /** @brief AND conjuncts together into one predicate, true::boolean if there are none */
+  auto CombineConjuncts(const std::vector<AbstractExpressionRef> &conjuncts) -> AbstractExpressionRef;
+
   /**
    * @brief optimize order by as index scan if there's an index on a table
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
-  /** @brief check if the index can be matched */
+  /**
+   * @brief optimize a scan filtered by `<column> = <constant>` into a point lookup on an index over that column,
+   * preferring a hash index when there is one
+   */
+  auto OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /** @brief check if the index can be matched, a hash index wins over a B+ tree on the same column */
   auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
 
+  /**
+   * @brief push the columns each plan reads down into the scans, so that they only materialize those columns.
+   * Joins, filters, sorts and limits pass on the columns their parents read plus the ones they read themselves.
+   * Must run last, the other rules expect scans to produce whole rows.
+   */
+  auto OptimizePruneColumns(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /**
    * @brief optimize sort + limit as top N
    */
   auto OptimizeSortLimitAsTopN(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
   /**
-   * @brief get the estimated cardinality for a table based on the table name. Useful when join reordering. BusTub
-   * doesn't support statistics for now, so it's the only way for you to get the table size :(
+   * @brief build the hash table of an inner hash join on its smaller side. The executor builds on the right child, so
+   * the children are swapped when the cost model expects the right one to be larger, and a projection restores the
+   * column order.
+   */
+  auto OptimizeHashJoinBuildSide(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief get the estimated cardinality for a table, from the statistics collected by ANALYZE, or else based on the
+   * table name.
    *
    * @param table_name
    * @return std::optional<size_t>
@@ -107,6 +170,9 @@ class Optimizer {
   const Catalog &catalog_;
 
   const bool force_starter_rule_;
+
+  /** Estimates the rows and costs of plans, from the statistics in the catalog */
+  CostModel cost_model_;
 };
 
 }  // namespace bustub
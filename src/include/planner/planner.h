@@ -14,6 +14,7 @@
 #include "common/exception.h"
 #include "common/macros.h"
 #include "execution/plans/aggregation_plan.h"
+#include "type/value.h"
 
 namespace bustub {
 
@@ -37,6 +38,7 @@ class BoundAggCall;
 class BoundCTERef;
 class BoundFuncCall;
 class ColumnValueExpression;
+class BoundParameter;
 
 /**
  * The context for the planner. Used for planning aggregation calls.
@@ -45,7 +47,7 @@ class PlannerContext {
  public:
   PlannerContext() = default;
 
-  void AddAggregation(std::unique_ptr<BoundExpression> expr);
+  void AddAggregation(const BoundExpression *expr);
 
   /** Indicates whether aggregation is allowed in this context. */
   bool allow_aggregation_{false};
@@ -56,9 +58,10 @@ class PlannerContext {
   /**
    * In the first phase of aggregation planning, we put all agg calls expressions into this vector.
    * The expressions in this vector should be used over the output of the original filter / table
-   * scan plan node.
+   * scan plan node. They point into the bound statement, which planning leaves as it is, so that a
+   * prepared statement can be planned again.
    */
-  std::vector<std::unique_ptr<BoundExpression>> aggregations_;
+  std::vector<const BoundExpression *> aggregations_;
 
   /**
    * In the second phase of aggregation planning, we plan agg calls from `aggregations_`, and generate
@@ -79,7 +82,9 @@ class PlannerContext {
  */
 class Planner {
  public:
-  explicit Planner(const Catalog &catalog) : catalog_(catalog) {}
+  /** @param parameters the values of the `$n` parameters of a prepared statement, `$1` first */
+  explicit Planner(const Catalog &catalog, std::vector<Value> parameters = {})
+      : catalog_(catalog), parameters_(std::move(parameters)) {}
 
   // The following parts are undocumented. One `PlanXXX` functions simply corresponds to a
   // bound thing in the binder.
@@ -111,7 +116,7 @@ class Planner {
 
   auto PlanExpressionListRef(const BoundExpressionListRef &table_ref) -> AbstractPlanNodeRef;
 
-  void AddAggCallToContext(BoundExpression &expr);
+  void AddAggCallToContext(const BoundExpression &expr);
 
   auto PlanExpression(const BoundExpression &expr, const std::vector<AbstractPlanNodeRef> &children)
       -> std::tuple<std::string, AbstractExpressionRef>;
@@ -128,6 +133,9 @@ class Planner {
   auto PlanConstant(const BoundConstant &expr, const std::vector<AbstractPlanNodeRef> &children)
       -> AbstractExpressionRef;
 
+  auto PlanParameter(const BoundParameter &expr, const std::vector<AbstractPlanNodeRef> &children)
+      -> AbstractExpressionRef;
+
   auto PlanSelectAgg(const SelectStatement &statement, AbstractPlanNodeRef child) -> AbstractPlanNodeRef;
 
   auto PlanAggCall(const BoundAggCall &agg_call, const std::vector<AbstractPlanNodeRef> &children)
@@ -182,6 +190,9 @@ class Planner {
    */
   const Catalog &catalog_;
 
+  /** The values the `$n` parameters are planned as */
+  std::vector<Value> parameters_;
+
   /** An id for all unnamed things */
   size_t universal_id_{0};
 };
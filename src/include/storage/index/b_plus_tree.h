@@ -11,12 +11,15 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <deque>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <queue>
 #include <shared_mutex>
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "common/config.h"
@@ -72,6 +75,8 @@ namespace bustub {
                            const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
                            int internal_max_size = INTERNAL_PAGE_SIZE);
 
+        ~BPlusTree();
+
         // Returns true if this B+ tree has no keys and values.
         auto IsEmpty() const -> bool;
 
@@ -99,6 +104,26 @@ namespace bustub {
 
         auto SplitInternalNode(InternalPage *node) -> InternalPage *;
 
+        /**
+         * @brief Merge sparse neighbouring leaves left behind by lazy deletion.
+         *
+         * Remove() lets a leaf drain down to the low-water mark without touching its
+         * siblings. Compact() walks the tree and folds every pair of adjacent leaves
+         * under the same parent whose combined size fits in one page, returning the
+         * emptied pages to the buffer pool through DeletePage().
+         *
+         * @return number of leaf pages reclaimed
+         */
+        auto Compact() -> size_t;
+
+        // Run Compact() every `btree_compaction_interval` on a background thread.
+        void StartBackgroundCompaction();
+
+        void StopBackgroundCompaction();
+
+        // Leaves smaller than this are rebalanced eagerly by Remove().
+        auto GetLeafLowWaterMark() const -> int { return leaf_low_water_mark_; }
+
         // Index iterator
         auto Begin() -> INDEXITERATOR_TYPE;
 
@@ -156,6 +181,10 @@ namespace bustub {
          */
         auto ToPrintableBPlusTree(page_id_t root_id) -> PrintableBPlusTree;
 
+        auto CompactNode(page_id_t page_id) -> size_t;
+
+        void RunBackgroundCompaction();
+
         // member variable
         std::string index_name_;
         BufferPoolManager *bpm_;
@@ -166,6 +195,9 @@ namespace bustub {
         page_id_t header_page_id_;
         page_id_t root_page_id_;
         ReaderWriterLatch root_page_id_latch_;
+        int leaf_low_water_mark_;
+        std::atomic<bool> enable_compaction_{false};
+        std::unique_ptr<std::thread> compaction_thread_;
     };
 
 /**
@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_htable_header_page.h
+//
+// Identification: src/include/storage/page/extendible_htable_header_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdlib>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * HTABLE_HEADER_MAX_DEPTH is the number of high hash bits the header page uses to pick a directory page.
+ * 2^9 page_ids is the largest power of two that still leaves room for the metadata in one page.
+ */
+static constexpr uint32_t HTABLE_HEADER_MAX_DEPTH = 9;
+static constexpr uint32_t HTABLE_HEADER_ARRAY_SIZE = 1 << HTABLE_HEADER_MAX_DEPTH;
+
+/**
+ *
+ * Header Page for extendible hash table. It sits above the directory pages
+ * and routes a hash to one of them by its most significant bits, while the
+ * directory itself consumes the least significant bits.
+ *
+ * Header format (size in byte):
+ * ------------------------------------------------------
+ * | DirectoryPageIds(2048) | MaxDepth (4) | Free(2044)
+ * ------------------------------------------------------
+ */
+class ExtendibleHTableHeaderPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  ExtendibleHTableHeaderPage() = delete;
+  DISALLOW_COPY_AND_MOVE(ExtendibleHTableHeaderPage);
+
+  /**
+   * After creating a new header page from buffer pool, must call initialize
+   * method to set default values
+   *
+   * @param max_depth number of hash bits used to pick a directory page
+   */
+  void Init(uint32_t max_depth = HTABLE_HEADER_MAX_DEPTH);
+
+  /**
+   * Get the directory index that the key is hashed to
+   *
+   * @param hash the hash of the key
+   * @return directory index the key is hashed to
+   */
+  auto HashToDirectoryIndex(uint32_t hash) const -> uint32_t;
+
+  /**
+   * Get the directory page id at an index
+   *
+   * @param directory_idx index in the directory page id array
+   * @return directory page_id at index, INVALID_PAGE_ID if it was not created yet
+   */
+  auto GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t;
+
+  /**
+   * Set the directory page id at an index
+   *
+   * @param directory_idx index in the directory page id array
+   * @param directory_page_id page id of the directory
+   */
+  void SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id);
+
+  /**
+   * @return the maximum number of directory page ids the header page could handle
+   */
+  auto MaxSize() const -> uint32_t;
+
+  /**
+   * Prints the header's occupancy information
+   */
+  void PrintHeader() const;
+
+ private:
+  page_id_t directory_page_ids_[HTABLE_HEADER_ARRAY_SIZE];
+  uint32_t max_depth_;
+};
+
+static_assert(sizeof(ExtendibleHTableHeaderPage) <= BUSTUB_PAGE_SIZE);
+
+}  // namespace bustub
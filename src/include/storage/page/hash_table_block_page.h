@@ -93,6 +93,23 @@ class HashTableBlockPage {
    */
   auto IsReadable(slot_offset_t bucket_ind) const -> bool;
 
+  /**
+   * Finds the first never-occupied slot at or after start. Whole bytes of the
+   * occupied bitmap are skipped at a time, so long clusters are cheap to walk.
+   *
+   * @param start first slot to look at
+   * @return index of the first unoccupied slot, or BLOCK_ARRAY_SIZE if every slot from start is occupied
+   */
+  auto FindUnoccupied(slot_offset_t start) const -> slot_offset_t;
+
+  /**
+   * Finds the first readable slot in [start, end), skipping empty bytes of
+   * the readable bitmap.
+   *
+   * @return index of the first readable slot, or end if there is none
+   */
+  auto NextReadable(slot_offset_t start, slot_offset_t end) const -> slot_offset_t;
+
   /**
    * Scan the bucket and collect values that have the matching key
    *
@@ -138,6 +155,12 @@ class HashTableBlockPage {
    */
   void PrintBucket();
 
+  /**
+   * Resets the occupied and readable bitmaps, must be called on a freshly
+   * allocated block page
+   */
+  void Init();
+
  private:
   std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
 
@@ -26,13 +26,31 @@ namespace bustub {
  *
  * Header Page for linear probing hash table.
  *
- * Header format (size in byte, 16 bytes in total):
+ * Header format (size in byte, 32 bytes in total with alignment padding):
  * -------------------------------------------------------------
- * | LSN (4) | Size (4) | PageId(4) | NextBlockIndex(4)
+ * | LSN (4) | Size (8) | PageId(4) | NextBlockIndex(8) | BlockPageIds...
  * -------------------------------------------------------------
  */
 class HashTableHeaderPage {
+  static constexpr size_t HEADER_FIELDS_SIZE = 32;
+
  public:
+  /**
+   * The maximum number of block page ids that fit after the header fields.
+   */
+  static constexpr auto MaxNumBlocks() -> size_t {
+    return (BUSTUB_PAGE_SIZE - HEADER_FIELDS_SIZE) / sizeof(page_id_t);
+  }
+
+  /**
+   * After creating a new header page from buffer pool, must call initialize
+   * method to set default values
+   *
+   * @param page_id the page id of this header page
+   * @param size the number of slots in the hash table
+   */
+  void Init(page_id_t page_id, size_t size);
+
   /**
    * @return the number of buckets in the hash table;
    */
@@ -90,12 +108,12 @@ class HashTableHeaderPage {
   auto NumBlocks() -> size_t;
 
  private:
-  __attribute__((unused)) lsn_t lsn_;
-  __attribute__((unused)) size_t size_;
-  __attribute__((unused)) page_id_t page_id_;
-  __attribute__((unused)) size_t next_ind_;
+  lsn_t lsn_;
+  size_t size_;
+  page_id_t page_id_;
+  size_t next_ind_;
   // Flexible array member for page data.
-  __attribute__((unused)) page_id_t block_page_ids_[1];
+  page_id_t block_page_ids_[1];
 };
 
 }  // namespace bustub
@@ -85,6 +85,12 @@ class TablePage {
    */
   auto GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple>;
 
+  /**
+   * Read a tuple from a table without copying it. The view points into this page and is only valid while the page
+   * guard it was read through is held.
+   */
+  auto GetTupleView(const RID &rid) const -> std::pair<TupleMeta, TupleView>;
+
   /**
    * Read a tuple meta from a table.
    */
@@ -21,16 +21,54 @@ namespace bustub {
 class TmpTuplePage : public Page {
  public:
   void Init(page_id_t page_id, uint32_t page_size) {
-    memcpy(GetData(), &page_id, sizeof(page_id_t));
-    memcpy(GetData() + sizeof(page_id_t), &page_size, sizeof(uint32_t));
+    memcpy(GetData() + OFFSET_TMP_PAGE_ID, &page_id, sizeof(page_id_t));
+    SetFreeSpacePointer(page_size);
   }
 
-  auto GetTablePageId() -> page_id_t { return INVALID_PAGE_ID; }
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_TMP_PAGE_ID); }
 
-  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool { return false; }
+  /**
+   * Appends a tuple to the page.
+   * @param tuple the tuple to append
+   * @param[out] out where the tuple was stored
+   * @return false if the page does not have room for the tuple
+   */
+  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool {
+    uint32_t size = sizeof(uint32_t) + tuple.GetLength();
+    uint32_t free_space_pointer = GetFreeSpacePointer();
+    if (free_space_pointer < SIZE_TMP_PAGE_HEADER + size) {
+      return false;
+    }
+    free_space_pointer -= size;
+    tuple.SerializeTo(GetData() + free_space_pointer);
+    SetFreeSpacePointer(free_space_pointer);
+    *out = TmpTuple(GetTablePageId(), free_space_pointer);
+    return true;
+  }
+
+  /** Reads the tuple stored at `offset`, as returned by Insert(). */
+  void Get(size_t offset, Tuple *tuple) { tuple->DeserializeFrom(GetData() + offset); }
+
+  /** @return the offset of the most recently inserted tuple, or the page size if the page is empty */
+  auto GetFreeSpacePointer() -> uint32_t {
+    return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE);
+  }
+
+  /** @return whether a tuple of `tuple_length` bytes fits on an empty page */
+  static auto Fits(uint32_t tuple_length) -> bool {
+    return SIZE_TMP_PAGE_HEADER + sizeof(uint32_t) + tuple_length <= BUSTUB_PAGE_SIZE;
+  }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_TMP_PAGE_ID = 0;
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
+  static constexpr size_t SIZE_TMP_PAGE_HEADER = 12;
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
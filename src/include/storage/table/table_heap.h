@@ -14,6 +14,7 @@
 
 #include <mutex>  // NOLINT
 #include <optional>
+#include <unordered_map>
 #include <utility>
 
 #include "buffer/buffer_pool_manager.h"
@@ -24,6 +25,7 @@
 #include "storage/page/table_page.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
@@ -33,6 +35,7 @@ namespace bustub {
  */
 class TableHeap {
   friend class TableIterator;
+  friend class ParallelTableScan;
 
  public:
   ~TableHeap() = default;
@@ -40,9 +43,9 @@ class TableHeap {
   /**
    * Create a table heap without a transaction. (open table)
    * @param buffer_pool_manager the buffer pool manager
-   * @param first_page_id the id of the first page
+   * @param schema the schema of the tuples, pages get zone maps when it is given
    */
-  explicit TableHeap(BufferPoolManager *bpm);
+  explicit TableHeap(BufferPoolManager *bpm, const Schema *schema = nullptr);
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return std::nullopt.
@@ -92,12 +95,30 @@ class TableHeap {
    */
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
+  /** @return the columns the zone maps of this table track, nullptr if the table keeps no zone maps */
+  auto GetZoneMapLayout() const -> const ZoneMap::Layout * {
+    return zone_map_layout_.has_value() ? &*zone_map_layout_ : nullptr;
+  }
+
+  /**
+   * @return `false` if the zone map of page `page_id` rules out `filter` for every tuple of the page. Zone maps only
+   * widen, so a page skipped by a scan cannot hold a matching tuple that was inserted before the scan looked at it.
+   */
+  auto PageMayMatch(page_id_t page_id, const ZoneMapFilter &filter) -> bool;
+
  private:
+  /** Widens the zone map of `rid`'s page to cover `tuple` */
+  void UpdateZoneMap(RID rid, const Tuple &tuple);
+
   BufferPoolManager *bpm_;
   page_id_t first_page_id_{INVALID_PAGE_ID};
 
   std::mutex latch_;
   page_id_t last_page_id_{INVALID_PAGE_ID}; /* protected by latch_ */
+
+  std::optional<ZoneMap::Layout> zone_map_layout_;
+  std::mutex zone_latch_;
+  std::unordered_map<page_id_t, ZoneMap> zone_maps_; /* protected by zone_latch_ */
 };
 
 }  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cassert>
+#include <functional>
 #include <memory>
 #include <utility>
 
@@ -20,6 +21,7 @@
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
+#include "storage/table/zone_map.h"
 
 namespace bustub {
 
@@ -47,6 +49,15 @@ class TableIterator {
 
   auto operator++() -> TableIterator &;
 
+  /**
+   * Visits the tuples from the current one to the end of its page in place, under a single read latch of the page,
+   * and moves the iterator to the first tuple of the next page. The views passed to `visit` are only valid during the
+   * call, and `visit` must not wait for anything that may need the page latch, such as row locks. When the zone map of
+   * the page rules out `zone_filter`, the page is passed over without visiting any tuple.
+   */
+  void ScanPage(const std::function<void(const TupleMeta &, const TupleView &)> &visit,
+                const ZoneMapFilter *zone_filter = nullptr);
+
  private:
   TableHeap *table_heap_;
   RID rid_;
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_heap.h
+//
+// Identification: src/include/storage/table/tmp_tuple_heap.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TmpTupleHeap is an append-only list of TmpTuplePages holding intermediate results that do not fit in an
+ * executor's memory budget, e.g. the partitions of a hash join that spilled.
+ *
+ * Appended tuples are gathered in a one-page write buffer, so that no page stays pinned between calls. The pages
+ * are read back one at a time, in append order, and deleted from the buffer pool when the heap is destroyed.
+ */
+class TmpTupleHeap {
+ public:
+  explicit TmpTupleHeap(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  ~TmpTupleHeap();
+
+  DISALLOW_COPY_AND_MOVE(TmpTupleHeap);
+
+  /** Appends a tuple. @throw ExecutionException if the tuple does not fit on a page or no frame is free */
+  void Append(const Tuple &tuple);
+
+  /** @return the number of pages, flushing the write buffer first */
+  auto NumPages() -> size_t;
+
+  /** Appends the tuples of the `page_idx`-th page to `tuples`, in the order they were appended. */
+  void ReadPage(size_t page_idx, std::vector<Tuple> *tuples);
+
+  /** @return the number of tuples appended */
+  auto Size() const -> size_t { return num_tuples_; }
+
+ private:
+  void Flush();
+
+  BufferPoolManager *bpm_;
+  std::vector<page_id_t> page_ids_;
+  /** Tuples not written to a page yet, and the page space they take */
+  std::vector<Tuple> buffer_;
+  size_t buffer_bytes_{0};
+  size_t num_tuples_{0};
+};
+
+}  // namespace bustub
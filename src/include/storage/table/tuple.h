@@ -52,6 +52,7 @@ class Tuple {
   friend class TablePage;
   friend class TableHeap;
   friend class TableIterator;
+  friend class TupleView;
 
  public:
   // Default constructor (to create a dummy tuple)
@@ -60,6 +61,9 @@ class Tuple {
   // constructor for table heap tuple
   explicit Tuple(RID rid) : rid_(rid) {}
 
+  // constructor for a tuple from its serialized data (deep copy)
+  Tuple(RID rid, const char *data, uint32_t size) : rid_(rid), data_(data, data + size) {}
+
   // constructor for creating a new tuple based on input value
   Tuple(std::vector<Value> values, const Schema *schema);
 
@@ -112,4 +116,47 @@ class Tuple {
   std::vector<char> data_;
 };
 
+/**
+ * TupleView reads a tuple in place, without owning its bytes.
+ *
+ * A view of a row of a table page (see TablePage::GetTupleView()) is only valid while the page stays pinned and
+ * latched, i.e. while the ReadPageGuard it was read through is held. A view of a Tuple is valid while the Tuple lives
+ * unmodified. Rows that outlive the page guard are materialized into a Tuple with ToTuple().
+ */
+class TupleView {
+ public:
+  TupleView() = default;
+
+  // a view of serialized tuple data
+  TupleView(RID rid, const char *data, uint32_t size) : rid_(rid), data_(data), size_(size) {}
+
+  // a view of an owned tuple
+  explicit TupleView(const Tuple &tuple)
+      : rid_(tuple.GetRid()), data_(tuple.GetData()), size_(tuple.GetLength()), tuple_(&tuple) {}
+
+  inline auto GetRid() const -> RID { return rid_; }
+
+  inline auto GetData() const -> const char * { return data_; }
+
+  inline auto GetLength() const -> uint32_t { return size_; }
+
+  // Get the value of a specified column
+  auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
+
+  // copy the viewed bytes into an owned tuple
+  inline auto ToTuple() const -> Tuple { return {rid_, data_, size_}; }
+
+  // materialize the columns `attrs` of `schema` only, as a tuple of `out_schema` with the same rid
+  auto Project(const Schema &schema, const Schema &out_schema, const std::vector<uint32_t> &attrs) const -> Tuple;
+
+  // the viewed tuple if this is a view of a Tuple, otherwise `scratch` after copying the viewed bytes into it
+  auto AsTuple(Tuple *scratch) const -> const Tuple *;
+
+ private:
+  RID rid_{};
+  const char *data_{nullptr};
+  uint32_t size_{0};
+  const Tuple *tuple_{nullptr};
+};
+
 }  // namespace bustub
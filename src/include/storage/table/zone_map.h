@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.h
+//
+// Identification: src/include/storage/table/zone_map.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "storage/table/tuple.h"
+#include "type/type_id.h"
+#include "type/value.h"
+
+namespace bustub {
+
+class ZoneMap;
+
+/** Tells from a zone map whether any row it summarizes may pass a predicate; `false` lets a scan skip the page */
+using ZoneMapFilter = std::function<bool(const ZoneMap &)>;
+
+/**
+ * ZoneMap summarizes the rows of a table page: the minimum and maximum of each fixed-width numeric column, NULLs
+ * left out. TableHeap widens it on every insert and in-place update. Deletes never narrow it, so a zone map may
+ * be wider than the live rows but never misses one. Scans skip pages whose zone map rules out their filter.
+ */
+class ZoneMap {
+ public:
+  /** The columns of a schema that zone maps track */
+  class Layout {
+   public:
+    explicit Layout(const Schema &schema);
+
+    /** @return whether column `col_idx` is tracked */
+    auto IsTracked(uint32_t col_idx) const -> bool { return types_[col_idx] != TypeId::INVALID; }
+
+    /** @return the type of column `col_idx`, INVALID if it is not tracked */
+    auto GetType(uint32_t col_idx) const -> TypeId { return types_[col_idx]; }
+
+    auto NumColumns() const -> size_t { return types_.size(); }
+
+   private:
+    friend class ZoneMap;
+    std::vector<TypeId> types_;
+    std::vector<uint32_t> offsets_;
+  };
+
+  explicit ZoneMap(const Layout &layout) : ranges_(layout.NumColumns()) {}
+
+  /** Widens the ranges to cover `tuple` */
+  void Add(const Layout &layout, const TupleView &tuple);
+
+  /**
+   * The questions a ZoneMapFilter asks about tracked column `col_idx`, for a non-NULL constant of the column type.
+   * @return whether some row may have a value less than (or equal to) / greater than (or equal to) / equal to /
+   * different from `constant`
+   */
+  auto MayBeLess(uint32_t col_idx, const Value &constant, bool or_equal) const -> bool;
+  auto MayBeGreater(uint32_t col_idx, const Value &constant, bool or_equal) const -> bool;
+  auto MayBeEqual(uint32_t col_idx, const Value &constant) const -> bool;
+  auto MayDiffer(uint32_t col_idx, const Value &constant) const -> bool;
+
+ private:
+  /** Integer columns use the int64 bounds, DECIMAL columns the double ones */
+  struct Range {
+    bool has_values_{false};
+    int64_t min_int_{0};
+    int64_t max_int_{0};
+    double min_dec_{0};
+    double max_dec_{0};
+  };
+
+  std::vector<Range> ranges_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_vector.h
+//
+// Identification: src/include/type/column_vector.h
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "storage/table/tuple.h"
+#include "type/type_id.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** Indexes of the rows of a batch that satisfied a predicate, in ascending order. */
+using SelectionVector = std::vector<uint32_t>;
+
+/**
+ * ColumnVector holds one column of a batch of rows in a flat, typed array.
+ *
+ * Fixed-width types are stored in their native representation (int8_t for BOOLEAN and TINYINT, int16_t, int32_t,
+ * int64_t, double for DECIMAL and uint64_t for TIMESTAMP) back to back, so expression kernels can run over them
+ * without going through Value. VARCHAR values are stored as one character buffer plus Size() + 1 offsets.
+ * Nulls are tracked in a separate byte mask instead of the per-type null sentinels.
+ */
+class ColumnVector {
+ public:
+  ColumnVector() = default;
+
+  /** Clears the vector and makes room for `size` non-null rows of `type`. Row contents are left unspecified. */
+  void Reset(TypeId type, size_t size);
+
+  /** Fills the vector with column `col_idx` of every tuple in `tuples`. */
+  void LoadColumn(const std::vector<Tuple> &tuples, const Schema &schema, uint32_t col_idx);
+
+  /** Fills the vector with `size` copies of `value`. */
+  void Broadcast(const Value &value, size_t size);
+
+  /** Appends `value` at the end of the vector. The value must have the vector's type. */
+  void Append(const Value &value);
+
+  /** @return the value at row `i` */
+  auto GetValue(size_t i) const -> Value;
+
+  /** @return the string at row `i` of a VARCHAR vector, without the trailing '\0' */
+  auto GetString(size_t i) const -> std::string_view;
+
+  auto GetType() const -> TypeId { return type_; }
+  auto Size() const -> size_t { return size_; }
+
+  /** @return the fixed-width values of the vector, T must match the type's storage */
+  template <typename T>
+  auto Data() -> T * {
+    return reinterpret_cast<T *>(data_.data());
+  }
+
+  template <typename T>
+  auto Data() const -> const T * {
+    return reinterpret_cast<const T *>(data_.data());
+  }
+
+  /** @return whether any row of the vector is null */
+  auto HasNulls() const -> bool { return has_nulls_; }
+  auto IsNull(size_t i) const -> bool { return has_nulls_ && nulls_[i] != 0; }
+  /** @return the null mask (one byte per row, non-zero means null), only meaningful when HasNulls() */
+  auto Nulls() const -> const uint8_t * { return nulls_.data(); }
+  auto Nulls() -> uint8_t * { return nulls_.data(); }
+
+  /** Marks row `i` null. */
+  void SetNull(size_t i);
+
+  /** Marks every row null where `lhs` or `rhs` is null, the null rule of binary operators. */
+  void MergeNulls(const ColumnVector &lhs, const ColumnVector &rhs);
+
+  /** Allocates the null mask with every row non-null, so kernels can write it directly. */
+  void InitNulls();
+
+ private:
+  TypeId type_{TypeId::INVALID};
+  size_t size_{0};
+  /** Width in bytes of one fixed-width value, 0 for VARCHAR */
+  size_t width_{0};
+  std::vector<uint8_t> data_;
+  std::vector<uint8_t> nulls_;
+  bool has_nulls_{false};
+  /** VARCHAR storage: the bytes of row i are chars_[offsets_[i], offsets_[i + 1]) including the '\0' */
+  std::vector<char> chars_;
+  std::vector<uint32_t> offsets_;
+};
+
+}  // namespace bustub
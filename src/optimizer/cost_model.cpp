@@ -0,0 +1,417 @@
+#include "optimizer/cost_model.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/util/string_util.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/mock_scan_plan.h"
+#include "execution/plans/nested_index_join_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "execution/plans/values_plan.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the comparison `b op a` means when written as `a op' b` */
+auto FlipComparison(ComparisonType type) -> ComparisonType {
+  switch (type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return type;
+  }
+}
+
+/** @return the statistics of the columns of a table, nullptr for each if it was never analyzed */
+auto TableColumnStats(const TableInfo &info) -> std::vector<const ColumnStats *> {
+  std::vector<const ColumnStats *> columns(info.schema_.GetColumnCount(), nullptr);
+  if (info.stats_ != nullptr) {
+    for (size_t i = 0; i < columns.size() && i < info.stats_->columns_.size(); i++) {
+      columns[i] = &info.stats_->columns_[i];
+    }
+  }
+  return columns;
+}
+
+/** @return the columns of a scan producing `column_ids` out of the table columns, every column if it is empty */
+auto ScanColumnStats(std::vector<const ColumnStats *> table_columns, const std::vector<uint32_t> &column_ids)
+    -> std::vector<const ColumnStats *> {
+  if (column_ids.empty()) {
+    return table_columns;
+  }
+  std::vector<const ColumnStats *> columns;
+  columns.reserve(column_ids.size());
+  for (auto col : column_ids) {
+    columns.push_back(table_columns[col]);
+  }
+  return columns;
+}
+
+}  // namespace
+
+auto CostModel::TableRows(const std::string &table_name) const -> std::optional<double> {
+  if (const auto *info = catalog_.GetTable(table_name); info != nullptr && info->stats_ != nullptr) {
+    return static_cast<double>(info->stats_->row_count_);
+  }
+  if (StringUtil::EndsWith(table_name, "_1m")) {
+    return 1000000;
+  }
+  if (StringUtil::EndsWith(table_name, "_100k")) {
+    return 100000;
+  }
+  if (StringUtil::EndsWith(table_name, "_50k")) {
+    return 50000;
+  }
+  if (StringUtil::EndsWith(table_name, "_10k")) {
+    return 10000;
+  }
+  if (StringUtil::EndsWith(table_name, "_1k")) {
+    return 1000;
+  }
+  if (StringUtil::EndsWith(table_name, "_100")) {
+    return 100;
+  }
+  return std::nullopt;
+}
+
+auto CostModel::ColumnStatsOf(const AbstractPlanNode &plan) const -> std::vector<const ColumnStats *> {
+  std::vector<const ColumnStats *> columns;
+  switch (plan.GetType()) {
+    case PlanType::SeqScan: {
+      const auto &scan = dynamic_cast<const SeqScanPlanNode &>(plan);
+      if (const auto *info = catalog_.GetTable(scan.GetTableOid()); info != nullptr) {
+        columns = ScanColumnStats(TableColumnStats(*info), scan.column_ids_);
+      }
+      break;
+    }
+    case PlanType::IndexScan: {
+      const auto &scan = dynamic_cast<const IndexScanPlanNode &>(plan);
+      if (const auto *index_info = catalog_.GetIndex(scan.GetIndexOid()); index_info != nullptr) {
+        if (const auto *info = catalog_.GetTable(index_info->table_name_); info != nullptr) {
+          columns = ScanColumnStats(TableColumnStats(*info), scan.column_ids_);
+        }
+      }
+      break;
+    }
+    case PlanType::Filter:
+    case PlanType::Sort:
+    case PlanType::Limit:
+    case PlanType::TopN:
+    case PlanType::InitCheck:
+      columns = ColumnStatsOf(*plan.GetChildAt(0));
+      break;
+    case PlanType::Projection: {
+      const auto &projection = dynamic_cast<const ProjectionPlanNode &>(plan);
+      auto child_columns = ColumnStatsOf(*projection.GetChildPlan());
+      for (const auto &expr : projection.GetExpressions()) {
+        const auto *col = dynamic_cast<const ColumnValueExpression *>(expr.get());
+        columns.push_back(col != nullptr && col->GetColIdx() < child_columns.size() ? child_columns[col->GetColIdx()]
+                                                                                    : nullptr);
+      }
+      break;
+    }
+    case PlanType::Aggregation: {
+      const auto &agg = dynamic_cast<const AggregationPlanNode &>(plan);
+      auto child_columns = ColumnStatsOf(*agg.GetChildPlan());
+      for (const auto &expr : agg.GetGroupBys()) {
+        const auto *col = dynamic_cast<const ColumnValueExpression *>(expr.get());
+        columns.push_back(col != nullptr && col->GetColIdx() < child_columns.size() ? child_columns[col->GetColIdx()]
+                                                                                    : nullptr);
+      }
+      break;
+    }
+    case PlanType::NestedLoopJoin:
+    case PlanType::HashJoin: {
+      columns = ColumnStatsOf(*plan.GetChildAt(0));
+      auto right_columns = ColumnStatsOf(*plan.GetChildAt(1));
+      columns.resize(plan.GetChildAt(0)->OutputSchema().GetColumnCount(), nullptr);
+      columns.insert(columns.end(), right_columns.begin(), right_columns.end());
+      break;
+    }
+    case PlanType::NestedIndexJoin: {
+      const auto &join = dynamic_cast<const NestedIndexJoinPlanNode &>(plan);
+      columns = ColumnStatsOf(*join.GetChildPlan());
+      columns.resize(join.GetChildPlan()->OutputSchema().GetColumnCount(), nullptr);
+      if (const auto *info = catalog_.GetTable(join.GetInnerTableOid()); info != nullptr) {
+        auto inner_columns = TableColumnStats(*info);
+        columns.insert(columns.end(), inner_columns.begin(), inner_columns.end());
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  // aggregates, computed expressions and the like have no statistics
+  columns.resize(plan.OutputSchema().GetColumnCount(), nullptr);
+  return columns;
+}
+
+auto CostModel::SelectivityOn(const AbstractExpression &predicate, const std::vector<const ColumnStats *> &columns,
+                              const std::vector<std::optional<double>> &column_rows, size_t right_offset) const
+    -> double {
+  if (const auto *logic = dynamic_cast<const LogicExpression *>(&predicate); logic != nullptr) {
+    auto left = SelectivityOn(*logic->GetChildAt(0), columns, column_rows, right_offset);
+    auto right = SelectivityOn(*logic->GetChildAt(1), columns, column_rows, right_offset);
+    return logic->logic_type_ == LogicType::And ? left * right : left + right - left * right;
+  }
+  if (const auto *constant = dynamic_cast<const ConstantValueExpression *>(&predicate); constant != nullptr) {
+    if (constant->val_.GetTypeId() == TypeId::BOOLEAN && !constant->val_.IsNull()) {
+      return constant->val_.GetAs<bool>() ? 1 : 0;
+    }
+    return DEFAULT_SELECTIVITY;
+  }
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(&predicate);
+  if (comparison == nullptr) {
+    return DEFAULT_SELECTIVITY;
+  }
+
+  auto index_of = [&](const ColumnValueExpression &col) {
+    return (col.GetTupleIdx() == 1 ? right_offset : 0) + col.GetColIdx();
+  };
+  auto stats_of = [&](const ColumnValueExpression &col) -> const ColumnStats * {
+    auto idx = index_of(col);
+    return idx < columns.size() ? columns[idx] : nullptr;
+  };
+  const auto *left_col = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+  const auto *right_col = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+
+  // <column> = <column>: the values of the side with fewer distinct values all find a match
+  if (left_col != nullptr && right_col != nullptr) {
+    if (comparison->comp_type_ != ComparisonType::Equal) {
+      return DEFAULT_RANGE_SELECTIVITY;
+    }
+    auto distinct = [&](const ColumnValueExpression &col) -> std::optional<double> {
+      auto idx = index_of(col);
+      auto rows = idx < column_rows.size() ? column_rows[idx] : std::nullopt;
+      const auto *stats = stats_of(col);
+      if (stats == nullptr) {
+        return rows;
+      }
+      return rows.has_value() ? std::min(stats->ndv_, *rows) : stats->ndv_;
+    };
+    auto left_distinct = distinct(*left_col);
+    auto right_distinct = distinct(*right_col);
+    if (!left_distinct.has_value() && !right_distinct.has_value()) {
+      return DEFAULT_EQUAL_SELECTIVITY;
+    }
+    return 1 / std::max({left_distinct.value_or(1), right_distinct.value_or(1), 1.0});
+  }
+
+  // <column> <op> <constant>, with the constant on either side
+  auto comp_type = comparison->comp_type_;
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1).get());
+  const auto *col = left_col;
+  if (col == nullptr) {
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0).get());
+    col = right_col;
+    comp_type = FlipComparison(comp_type);
+  }
+  const auto *stats = col == nullptr || constant == nullptr ? nullptr : stats_of(*col);
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return stats == nullptr ? DEFAULT_EQUAL_SELECTIVITY : stats->EqualSelectivity(constant->val_);
+    case ComparisonType::NotEqual:
+      return stats == nullptr ? 1 - DEFAULT_EQUAL_SELECTIVITY
+                              : std::max(0.0, 1 - stats->null_fraction_ - stats->EqualSelectivity(constant->val_));
+    case ComparisonType::LessThan:
+    case ComparisonType::LessThanOrEqual:
+      return stats == nullptr ? DEFAULT_RANGE_SELECTIVITY
+                              : stats->LessSelectivity(constant->val_, comp_type == ComparisonType::LessThanOrEqual);
+    case ComparisonType::GreaterThan:
+    case ComparisonType::GreaterThanOrEqual:
+      return stats == nullptr
+                 ? DEFAULT_RANGE_SELECTIVITY
+                 : stats->GreaterSelectivity(constant->val_, comp_type == ComparisonType::GreaterThanOrEqual);
+  }
+  return DEFAULT_SELECTIVITY;
+}
+
+auto CostModel::Selectivity(const AbstractExpression &predicate, const AbstractPlanNode &plan) const -> double {
+  auto columns = ColumnStatsOf(plan);
+  return SelectivityOn(predicate, columns, std::vector(columns.size(), EstimateRows(plan)), 0);
+}
+
+auto CostModel::JoinSelectivity(const AbstractExpression &predicate, const AbstractPlanNode &left,
+                                const AbstractPlanNode &right) const -> double {
+  auto columns = ColumnStatsOf(left);
+  std::vector column_rows(columns.size(), EstimateRows(left));
+  auto right_columns = ColumnStatsOf(right);
+  columns.insert(columns.end(), right_columns.begin(), right_columns.end());
+  column_rows.resize(columns.size(), EstimateRows(right));
+  return SelectivityOn(predicate, columns, column_rows, left.OutputSchema().GetColumnCount());
+}
+
+auto CostModel::JoinSelectivity(const AbstractExpression &predicate,
+                                const std::vector<const AbstractPlanNode *> &inputs) const -> double {
+  std::vector<const ColumnStats *> columns;
+  std::vector<std::optional<double>> column_rows;
+  for (const auto *input : inputs) {
+    auto input_columns = ColumnStatsOf(*input);
+    columns.insert(columns.end(), input_columns.begin(), input_columns.end());
+    column_rows.resize(columns.size(), EstimateRows(*input));
+  }
+  return SelectivityOn(predicate, columns, column_rows, 0);
+}
+
+auto CostModel::DistinctValues(const AbstractPlanNode &plan, uint32_t col_idx) const -> std::optional<double> {
+  auto rows = EstimateRows(plan);
+  auto columns = ColumnStatsOf(plan);
+  if (col_idx >= columns.size() || columns[col_idx] == nullptr) {
+    // without statistics, take the column for a key
+    return rows;
+  }
+  return rows.has_value() ? std::min(columns[col_idx]->ndv_, *rows) : columns[col_idx]->ndv_;
+}
+
+auto CostModel::EstimateRows(const AbstractPlanNode &plan) const -> std::optional<double> {
+  switch (plan.GetType()) {
+    case PlanType::SeqScan: {
+      const auto &scan = dynamic_cast<const SeqScanPlanNode &>(plan);
+      auto rows = TableRows(scan.table_name_);
+      if (rows.has_value() && scan.filter_predicate_ != nullptr) {
+        // the predicate reads the table columns, whatever columns the scan produces
+        const auto *info = catalog_.GetTable(scan.GetTableOid());
+        auto columns = info == nullptr ? std::vector<const ColumnStats *>{} : TableColumnStats(*info);
+        *rows *= SelectivityOn(*scan.filter_predicate_, columns, std::vector(columns.size(), rows), 0);
+      }
+      return rows;
+    }
+    case PlanType::IndexScan: {
+      const auto &scan = dynamic_cast<const IndexScanPlanNode &>(plan);
+      const auto *index_info = catalog_.GetIndex(scan.GetIndexOid());
+      if (index_info == nullptr) {
+        return std::nullopt;
+      }
+      auto rows = TableRows(index_info->table_name_);
+      const auto *constant = dynamic_cast<const ConstantValueExpression *>(scan.pred_key_.get());
+      if (!rows.has_value() || constant == nullptr) {
+        return rows;
+      }
+      const auto *info = catalog_.GetTable(index_info->table_name_);
+      auto key_col = index_info->index_->GetKeyAttrs()[0];
+      if (info->stats_ == nullptr || key_col >= info->stats_->columns_.size()) {
+        return std::min(*rows, 1.0);
+      }
+      return *rows * info->stats_->columns_[key_col].EqualSelectivity(constant->val_);
+    }
+    case PlanType::MockScan:
+      return TableRows(dynamic_cast<const MockScanPlanNode &>(plan).GetTable());
+    case PlanType::Values:
+      return static_cast<double>(dynamic_cast<const ValuesPlanNode &>(plan).GetValues().size());
+    case PlanType::Insert:
+    case PlanType::Update:
+    case PlanType::Delete:
+      return 1;
+    case PlanType::Filter: {
+      const auto &filter = dynamic_cast<const FilterPlanNode &>(plan);
+      auto rows = EstimateRows(*filter.GetChildPlan());
+      if (rows.has_value()) {
+        *rows *= Selectivity(*filter.GetPredicate(), *filter.GetChildPlan());
+      }
+      return rows;
+    }
+    case PlanType::Projection:
+    case PlanType::Sort:
+    case PlanType::InitCheck:
+      return EstimateRows(*plan.GetChildAt(0));
+    case PlanType::Limit:
+    case PlanType::TopN: {
+      auto limit = static_cast<double>(plan.GetType() == PlanType::Limit
+                                           ? dynamic_cast<const LimitPlanNode &>(plan).GetLimit()
+                                           : dynamic_cast<const TopNPlanNode &>(plan).GetN());
+      return std::min(EstimateRows(*plan.GetChildAt(0)).value_or(limit), limit);
+    }
+    case PlanType::Aggregation: {
+      const auto &agg = dynamic_cast<const AggregationPlanNode &>(plan);
+      if (agg.GetGroupBys().empty()) {
+        return 1;
+      }
+      auto rows = EstimateRows(*agg.GetChildPlan());
+      if (!rows.has_value()) {
+        return std::nullopt;
+      }
+      double groups = 1;
+      for (const auto &expr : agg.GetGroupBys()) {
+        const auto *col = dynamic_cast<const ColumnValueExpression *>(expr.get());
+        groups *= col == nullptr ? *rows : DistinctValues(*agg.GetChildPlan(), col->GetColIdx()).value_or(*rows);
+      }
+      return std::min(groups, *rows);
+    }
+    case PlanType::NestedLoopJoin:
+    case PlanType::HashJoin: {
+      const auto &left = *plan.GetChildAt(0);
+      const auto &right = *plan.GetChildAt(1);
+      auto left_rows = EstimateRows(left);
+      auto right_rows = EstimateRows(right);
+      if (!left_rows.has_value() || !right_rows.has_value()) {
+        return std::nullopt;
+      }
+      double selectivity = 1;
+      JoinType join_type;
+      if (plan.GetType() == PlanType::NestedLoopJoin) {
+        const auto &nlj = dynamic_cast<const NestedLoopJoinPlanNode &>(plan);
+        selectivity = JoinSelectivity(*nlj.Predicate(), left, right);
+        join_type = nlj.GetJoinType();
+      } else {
+        const auto &hash_join = dynamic_cast<const HashJoinPlanNode &>(plan);
+        const auto &left_keys = hash_join.LeftJoinKeyExpressions();
+        const auto &right_keys = hash_join.RightJoinKeyExpressions();
+        for (size_t i = 0; i < left_keys.size(); i++) {
+          const auto *left_key = dynamic_cast<const ColumnValueExpression *>(left_keys[i].get());
+          const auto *right_key = dynamic_cast<const ColumnValueExpression *>(right_keys[i].get());
+          if (left_key == nullptr || right_key == nullptr) {
+            selectivity *= DEFAULT_EQUAL_SELECTIVITY;
+            continue;
+          }
+          auto left_distinct = DistinctValues(left, left_key->GetColIdx()).value_or(1);
+          auto right_distinct = DistinctValues(right, right_key->GetColIdx()).value_or(1);
+          selectivity /= std::max({left_distinct, right_distinct, 1.0});
+        }
+        join_type = hash_join.GetJoinType();
+      }
+      auto rows = *left_rows * *right_rows * selectivity;
+      return join_type == JoinType::LEFT ? std::max(rows, *left_rows) : rows;
+    }
+    case PlanType::NestedIndexJoin: {
+      const auto &join = dynamic_cast<const NestedIndexJoinPlanNode &>(plan);
+      const auto *info = catalog_.GetTable(join.GetInnerTableOid());
+      const auto *index_info = catalog_.GetIndex(join.GetIndexOid());
+      auto left_rows = EstimateRows(*join.GetChildPlan());
+      auto inner_rows = info == nullptr ? std::nullopt : TableRows(info->name_);
+      if (!left_rows.has_value() || !inner_rows.has_value() || index_info == nullptr) {
+        return std::nullopt;
+      }
+      const auto *left_key = dynamic_cast<const ColumnValueExpression *>(join.KeyPredicate().get());
+      auto left_distinct =
+          left_key == nullptr ? *left_rows : DistinctValues(*join.GetChildPlan(), left_key->GetColIdx()).value_or(1);
+      auto key_col = index_info->index_->GetKeyAttrs()[0];
+      auto inner_distinct = info->stats_ == nullptr || key_col >= info->stats_->columns_.size()
+                                ? *inner_rows
+                                : std::min(info->stats_->columns_[key_col].ndv_, *inner_rows);
+      auto rows = *left_rows * *inner_rows / std::max({left_distinct, inner_distinct, 1.0});
+      return join.GetJoinType() == JoinType::LEFT ? std::max(rows, *left_rows) : rows;
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace bustub
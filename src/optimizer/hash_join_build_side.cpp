@@ -0,0 +1,54 @@
+#include <memory>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+auto Optimizer::OptimizeHashJoinBuildSide(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeHashJoinBuildSide(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::HashJoin) {
+    return optimized_plan;
+  }
+  const auto &join_plan = dynamic_cast<const HashJoinPlanNode &>(*optimized_plan);
+  // a left join keeps every left row, the sides cannot trade places
+  if (join_plan.GetJoinType() != JoinType::INNER) {
+    return optimized_plan;
+  }
+  auto left_rows = cost_model_.EstimateRows(*join_plan.GetLeftPlan());
+  auto right_rows = cost_model_.EstimateRows(*join_plan.GetRightPlan());
+  if (!left_rows.has_value() || !right_rows.has_value() ||
+      CostModel::HashJoinCost(*right_rows, *left_rows) <= CostModel::HashJoinCost(*left_rows, *right_rows)) {
+    return optimized_plan;
+  }
+
+  auto swapped = std::make_shared<HashJoinPlanNode>(
+      std::make_shared<Schema>(NestedLoopJoinPlanNode::InferJoinSchema(*join_plan.GetRightPlan(),
+                                                                       *join_plan.GetLeftPlan())),
+      join_plan.GetRightPlan(), join_plan.GetLeftPlan(), join_plan.RightJoinKeyExpressions(),
+      join_plan.LeftJoinKeyExpressions(), JoinType::INNER);
+
+  // put the columns of the old left side first again
+  const auto left_column_cnt = join_plan.GetLeftPlan()->OutputSchema().GetColumnCount();
+  const auto right_column_cnt = join_plan.GetRightPlan()->OutputSchema().GetColumnCount();
+  const auto &columns = join_plan.OutputSchema().GetColumns();
+  std::vector<AbstractExpressionRef> exprs;
+  for (uint32_t i = 0; i < left_column_cnt; i++) {
+    exprs.emplace_back(std::make_shared<ColumnValueExpression>(0, right_column_cnt + i, columns[i].GetType()));
+  }
+  for (uint32_t i = 0; i < right_column_cnt; i++) {
+    exprs.emplace_back(std::make_shared<ColumnValueExpression>(0, i, columns[left_column_cnt + i].GetType()));
+  }
+  return std::make_shared<ProjectionPlanNode>(join_plan.output_schema_, std::move(exprs), std::move(swapped));
+}
+
+}  // namespace bustub
@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** A set of join inputs, bit i standing for input i */
+using InputSet = uint64_t;
+
+/** Trees of up to this many inputs are ordered by dynamic programming over their subsets, larger ones greedily */
+constexpr size_t MAX_DP_INPUTS = 10;
+
+/** Trees of more inputs than an InputSet can hold are left as they are */
+constexpr size_t MAX_INPUTS = 64;
+
+/** The inputs of a tree of inner joins and the conjuncts of its predicates */
+struct JoinGraph {
+  std::vector<AbstractPlanNodeRef> inputs_;
+  /** The position of the first column of each input in the rows of the whole tree */
+  std::vector<uint32_t> offsets_;
+  /** The conjuncts, reading the columns of the whole tree as tuple 0 */
+  std::vector<AbstractExpressionRef> conjuncts_;
+  /** The inputs each conjunct reads */
+  std::vector<InputSet> conjunct_inputs_;
+};
+
+/** The cheapest way found to join a set of inputs */
+struct JoinEntry {
+  double rows_;
+  double cost_;
+  /** How the set splits into the left and right side of the join, both empty for a single input */
+  InputSet left_;
+  InputSet right_;
+};
+
+auto IsInnerJoin(const AbstractPlanNode &plan) -> bool {
+  return plan.GetType() == PlanType::NestedLoopJoin &&
+         dynamic_cast<const NestedLoopJoinPlanNode &>(plan).GetJoinType() == JoinType::INNER;
+}
+
+auto Count(InputSet set) -> int { return __builtin_popcountll(set); }
+
+}  // namespace
+
+auto Optimizer::OptimizeJoinOrder(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  // The tree is rooted at an inner join, or at a filter right above one.
+  const AbstractPlanNode *root = plan.get();
+  if (plan->GetType() == PlanType::Filter && IsInnerJoin(*plan->GetChildAt(0))) {
+    root = plan->GetChildAt(0).get();
+  }
+
+  JoinGraph graph;
+  uint32_t column_cnt = 0;
+  std::vector<AbstractExpressionRef> predicates;
+  std::function<void(const AbstractPlanNodeRef &)> flatten = [&](const AbstractPlanNodeRef &node) {
+    if (!IsInnerJoin(*node)) {
+      graph.inputs_.push_back(node);
+      graph.offsets_.push_back(column_cnt);
+      column_cnt += node->OutputSchema().GetColumnCount();
+      return;
+    }
+    const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*node);
+    auto left_offset = column_cnt;
+    flatten(nlj_plan.GetLeftPlan());
+    auto right_offset = column_cnt;
+    flatten(nlj_plan.GetRightPlan());
+    predicates.push_back(RemapColumns(nlj_plan.Predicate(), [&](const ColumnValueExpression &col) {
+      return std::make_shared<ColumnValueExpression>(
+          0, col.GetColIdx() + (col.GetTupleIdx() == 1 ? right_offset : left_offset), col.GetReturnType());
+    }));
+  };
+  if (IsInnerJoin(*root)) {
+    flatten(plan.get() == root ? plan : plan->GetChildAt(0));
+  }
+
+  auto estimable = [&]() {
+    return std::all_of(graph.inputs_.begin(), graph.inputs_.end(),
+                       [&](const auto &input) { return cost_model_.EstimateRows(*input).has_value(); });
+  };
+  if (graph.inputs_.size() < 3 || graph.inputs_.size() > MAX_INPUTS || !estimable()) {
+    std::vector<AbstractPlanNodeRef> children;
+    for (const auto &child : plan->GetChildren()) {
+      children.emplace_back(OptimizeJoinOrder(child));
+    }
+    return plan->CloneWithChildren(std::move(children));
+  }
+
+  // The filter above the joins reads their rows, the same columns in the same order.
+  if (plan.get() != root) {
+    predicates.push_back(dynamic_cast<const FilterPlanNode &>(*plan).GetPredicate());
+  }
+  const auto num_inputs = graph.inputs_.size();
+  const InputSet all_inputs = num_inputs == 64 ? ~InputSet{0} : (InputSet{1} << num_inputs) - 1;
+  auto input_of = [&](uint32_t col) {
+    return std::upper_bound(graph.offsets_.begin(), graph.offsets_.end(), col) - graph.offsets_.begin() - 1;
+  };
+  for (const auto &predicate : predicates) {
+    for (auto &conjunct : SplitConjuncts(predicate)) {
+      std::vector<uint32_t> columns;
+      CollectColumns(*conjunct, &columns);
+      InputSet inputs = 0;
+      for (auto col : columns) {
+        inputs |= InputSet{1} << input_of(col);
+      }
+      // a conjunct without columns is checked once, by the topmost join
+      graph.conjunct_inputs_.push_back(inputs == 0 ? all_inputs : inputs);
+      graph.conjuncts_.push_back(std::move(conjunct));
+    }
+  }
+
+  // Conjuncts on a single input filter it before it is joined.
+  std::vector<AbstractPlanNodeRef> inputs;
+  for (size_t i = 0; i < num_inputs; i++) {
+    std::vector<AbstractExpressionRef> filters;
+    for (size_t c = 0; c < graph.conjuncts_.size(); c++) {
+      if (graph.conjunct_inputs_[c] == InputSet{1} << i) {
+        filters.push_back(RemapColumns(graph.conjuncts_[c], [&](const ColumnValueExpression &col) {
+          return std::make_shared<ColumnValueExpression>(0, col.GetColIdx() - graph.offsets_[i], col.GetReturnType());
+        }));
+      }
+    }
+    auto input = OptimizeJoinOrder(graph.inputs_[i]);
+    if (!filters.empty()) {
+      input = std::make_shared<FilterPlanNode>(input->output_schema_, CombineConjuncts(filters), std::move(input));
+    }
+    inputs.push_back(std::move(input));
+  }
+
+  // The selectivity of every conjunct joining inputs, over the filtered inputs.
+  std::vector<const AbstractPlanNode *> input_plans;
+  for (const auto &input : inputs) {
+    input_plans.push_back(input.get());
+  }
+  std::vector<double> selectivities(graph.conjuncts_.size(), 1);
+  for (size_t c = 0; c < graph.conjuncts_.size(); c++) {
+    if (Count(graph.conjunct_inputs_[c]) > 1) {
+      selectivities[c] = cost_model_.JoinSelectivity(*graph.conjuncts_[c], input_plans);
+    }
+  }
+
+  // The conjuncts a join of `left` and `right` checks: the ones reading both sides and nothing else.
+  auto join_conjuncts = [&](InputSet left, InputSet right) {
+    std::vector<size_t> conjuncts;
+    for (size_t c = 0; c < graph.conjuncts_.size(); c++) {
+      auto reads = graph.conjunct_inputs_[c];
+      if ((reads & ~(left | right)) == 0 && (reads & left) != 0 && (reads & right) != 0) {
+        conjuncts.push_back(c);
+      }
+    }
+    return conjuncts;
+  };
+
+  // An `<column> = <column>` conjunct across the two sides, as (left column, right column).
+  auto equi_columns = [&](size_t c, InputSet right) -> std::optional<std::pair<uint32_t, uint32_t>> {
+    const auto *expr = dynamic_cast<const ComparisonExpression *>(graph.conjuncts_[c].get());
+    if (expr == nullptr || expr->comp_type_ != ComparisonType::Equal) {
+      return std::nullopt;
+    }
+    const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(expr->GetChildAt(0).get());
+    const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(expr->GetChildAt(1).get());
+    if (left_expr == nullptr || right_expr == nullptr) {
+      return std::nullopt;
+    }
+    auto left_col = left_expr->GetColIdx();
+    auto right_col = right_expr->GetColIdx();
+    if ((right & (InputSet{1} << input_of(left_col))) != 0) {
+      std::swap(left_col, right_col);
+    }
+    if ((right & (InputSet{1} << input_of(right_col))) == 0 || (right & (InputSet{1} << input_of(left_col))) != 0) {
+      return std::nullopt;
+    }
+    return std::make_pair(left_col, right_col);
+  };
+
+  std::unordered_map<InputSet, JoinEntry> best;
+  for (size_t i = 0; i < num_inputs; i++) {
+    auto rows = *cost_model_.EstimateRows(*inputs[i]);
+    // a scan reads the whole table, however much of it a filter keeps
+    auto read_rows = cost_model_.EstimateRows(*graph.inputs_[i]).value_or(rows);
+    best[InputSet{1} << i] = JoinEntry{rows, CostModel::SeqScanCost(read_rows), 0, 0};
+  }
+
+  // Joins `left` and `right`, both already planned, in that order.
+  auto plan_join = [&](InputSet left, InputSet right, const std::vector<size_t> &conjuncts) {
+    const auto &left_entry = best.at(left);
+    const auto &right_entry = best.at(right);
+    auto rows = left_entry.rows_ * right_entry.rows_;
+    bool has_equi = false;
+    for (auto c : conjuncts) {
+      rows *= selectivities[c];
+      has_equi = has_equi || equi_columns(c, right).has_value();
+    }
+    // The nested loop join executor runs its right side again for every left row.
+    auto cost = left_entry.cost_ + right_entry.cost_ * std::max(left_entry.rows_, 1.0);
+    if (has_equi) {
+      cost = std::min(cost, left_entry.cost_ + right_entry.cost_ +
+                                CostModel::HashJoinCost(right_entry.rows_, left_entry.rows_));
+    }
+    // A single key into an unfiltered table with an index on it can be looked up instead of reading the table.
+    if (Count(right) == 1 && conjuncts.size() == 1) {
+      auto input = __builtin_ctzll(right);
+      auto key = equi_columns(conjuncts[0], right);
+      if (key.has_value() && inputs[input]->GetType() == PlanType::SeqScan) {
+        const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*inputs[input]);
+        if (seq_scan.filter_predicate_ == nullptr &&
+            MatchIndex(seq_scan.table_name_, key->second - graph.offsets_[input]).has_value()) {
+          cost = std::min(cost, left_entry.cost_ + CostModel::IndexLookupCost(left_entry.rows_, rows));
+        }
+      }
+    }
+    return JoinEntry{rows, cost + rows * CostModel::SEQ_ROW_COST, left, right};
+  };
+
+  if (num_inputs <= MAX_DP_INPUTS) {
+    // Every subset comes after its own subsets in numeric order.
+    for (InputSet set = 1; set <= all_inputs; set++) {
+      if (Count(set) < 2) {
+        continue;
+      }
+      // Join subsets connected by a predicate, and fall back to a cross product only if there are none.
+      for (bool allow_cross : {false, true}) {
+        std::optional<JoinEntry> cheapest;
+        for (InputSet left = (set - 1) & set; left != 0; left = (left - 1) & set) {
+          auto right = set ^ left;
+          if (best.count(left) == 0 || best.count(right) == 0) {
+            continue;
+          }
+          auto conjuncts = join_conjuncts(left, right);
+          if (conjuncts.empty() && !allow_cross) {
+            continue;
+          }
+          auto entry = plan_join(left, right, conjuncts);
+          if (!cheapest.has_value() || entry.cost_ < cheapest->cost_) {
+            cheapest = entry;
+          }
+        }
+        if (cheapest.has_value()) {
+          best[set] = *cheapest;
+          break;
+        }
+      }
+    }
+  } else {
+    // Join the cheapest pair of connected subtrees until one is left, cross products only when nothing is connected.
+    std::vector<InputSet> subtrees;
+    for (size_t i = 0; i < num_inputs; i++) {
+      subtrees.push_back(InputSet{1} << i);
+    }
+    while (subtrees.size() > 1) {
+      std::optional<JoinEntry> cheapest;
+      bool cheapest_connected = false;
+      for (auto left : subtrees) {
+        for (auto right : subtrees) {
+          if (left == right) {
+            continue;
+          }
+          auto conjuncts = join_conjuncts(left, right);
+          bool connected = !conjuncts.empty();
+          if (cheapest_connected && !connected) {
+            continue;
+          }
+          auto entry = plan_join(left, right, conjuncts);
+          if (!cheapest.has_value() || (connected && !cheapest_connected) || entry.cost_ < cheapest->cost_) {
+            cheapest = entry;
+            cheapest_connected = connected;
+          }
+        }
+      }
+      auto joined = cheapest->left_ | cheapest->right_;
+      best[joined] = *cheapest;
+      subtrees.erase(std::remove_if(subtrees.begin(), subtrees.end(),
+                                    [&](InputSet set) { return (set & joined) != 0; }),
+                     subtrees.end());
+      subtrees.push_back(joined);
+    }
+  }
+
+  // Build the joins, keeping track of which column of the whole tree each output column is.
+  std::function<std::pair<AbstractPlanNodeRef, std::vector<uint32_t>>(InputSet)> build = [&](InputSet set) {
+    const auto &entry = best.at(set);
+    if (entry.left_ == 0) {
+      auto input = __builtin_ctzll(set);
+      std::vector<uint32_t> columns(inputs[input]->OutputSchema().GetColumnCount());
+      for (uint32_t i = 0; i < columns.size(); i++) {
+        columns[i] = graph.offsets_[input] + i;
+      }
+      return std::make_pair(inputs[input], std::move(columns));
+    }
+    auto [left_plan, left_columns] = build(entry.left_);
+    auto right = build(entry.right_);
+    const auto &right_columns = right.second;
+    std::vector<AbstractExpressionRef> conjuncts;
+    const auto &left_cols = left_columns;
+    for (auto c : join_conjuncts(entry.left_, entry.right_)) {
+      conjuncts.push_back(RemapColumns(graph.conjuncts_[c], [&](const ColumnValueExpression &col) {
+        auto left_pos = std::find(left_cols.begin(), left_cols.end(), col.GetColIdx());
+        if (left_pos != left_cols.end()) {
+          return std::make_shared<ColumnValueExpression>(0, left_pos - left_cols.begin(), col.GetReturnType());
+        }
+        auto right_pos = std::find(right_columns.begin(), right_columns.end(), col.GetColIdx());
+        return std::make_shared<ColumnValueExpression>(1, right_pos - right_columns.begin(), col.GetReturnType());
+      }));
+    }
+    auto schema = std::make_shared<Schema>(NestedLoopJoinPlanNode::InferJoinSchema(*left_plan, *right.first));
+    AbstractPlanNodeRef join = std::make_shared<NestedLoopJoinPlanNode>(
+        std::move(schema), std::move(left_plan), std::move(right.first), CombineConjuncts(conjuncts), JoinType::INNER);
+    left_columns.insert(left_columns.end(), right_columns.begin(), right_columns.end());
+    return std::make_pair(std::move(join), std::move(left_columns));
+  };
+  auto [joined, columns] = build(all_inputs);
+
+  // Put the columns back in the order of the original tree.
+  std::vector<AbstractExpressionRef> exprs(column_cnt);
+  bool reordered = false;
+  for (uint32_t i = 0; i < column_cnt; i++) {
+    exprs[columns[i]] =
+        std::make_shared<ColumnValueExpression>(0, i, joined->OutputSchema().GetColumn(i).GetType());
+    reordered = reordered || columns[i] != i;
+  }
+  if (!reordered) {
+    const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*joined);
+    return std::make_shared<NestedLoopJoinPlanNode>(plan->output_schema_, nlj_plan.GetLeftPlan(),
+                                                    nlj_plan.GetRightPlan(), nlj_plan.Predicate(), JoinType::INNER);
+  }
+  return std::make_shared<ProjectionPlanNode>(plan->output_schema_, std::move(exprs), std::move(joined));
+}
+
+}  // namespace bustub
@@ -6,12 +6,14 @@
 #include "common/macros.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
 #include "execution/plans/abstract_plan.h"
 #include "execution/plans/filter_plan.h"
 #include "execution/plans/nested_loop_join_plan.h"
 #include "execution/plans/projection_plan.h"
 #include "optimizer/optimizer.h"
 #include "type/type_id.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -36,6 +38,30 @@ auto Optimizer::RewriteExpressionForJoin(const AbstractExpressionRef &expr, size
   return expr->CloneWithChildren(children);
 }
 
+auto Optimizer::RemapColumns(const AbstractExpressionRef &expr,
+                             const std::function<AbstractExpressionRef(const ColumnValueExpression &)> &remap)
+    -> AbstractExpressionRef {
+  if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+      column_value_expr != nullptr) {
+    return remap(*column_value_expr);
+  }
+  std::vector<AbstractExpressionRef> children;
+  for (const auto &child : expr->GetChildren()) {
+    children.emplace_back(RemapColumns(child, remap));
+  }
+  return expr->CloneWithChildren(std::move(children));
+}
+
+void Optimizer::CollectColumns(const AbstractExpression &expr, std::vector<uint32_t> *columns) {
+  if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(&expr);
+      column_value_expr != nullptr) {
+    columns->push_back(column_value_expr->GetColIdx());
+  }
+  for (const auto &child : expr.GetChildren()) {
+    CollectColumns(*child, columns);
+  }
+}
+
 auto Optimizer::IsPredicateTrue(const AbstractExpressionRef &expr) -> bool {
   if (const auto *const_expr = dynamic_cast<const ConstantValueExpression *>(expr.get()); const_expr != nullptr) {
     return const_expr->val_.CastAs(TypeId::BOOLEAN).GetAs<bool>();
@@ -43,6 +69,31 @@ auto Optimizer::IsPredicateTrue(const AbstractExpressionRef &expr) -> bool {
   return false;
 }
 
+auto Optimizer::SplitConjuncts(const AbstractExpressionRef &expr) -> std::vector<AbstractExpressionRef> {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get());
+      logic_expr != nullptr && logic_expr->logic_type_ == LogicType::And) {
+    auto conjuncts = SplitConjuncts(logic_expr->GetChildAt(0));
+    auto right_conjuncts = SplitConjuncts(logic_expr->GetChildAt(1));
+    conjuncts.insert(conjuncts.end(), right_conjuncts.begin(), right_conjuncts.end());
+    return conjuncts;
+  }
+  if (IsPredicateTrue(expr)) {
+    return {};
+  }
+  return {expr};
+}
+
+auto Optimizer::CombineConjuncts(const std::vector<AbstractExpressionRef> &conjuncts) -> AbstractExpressionRef {
+  if (conjuncts.empty()) {
+    return std::make_shared<ConstantValueExpression>(ValueFactory::GetBooleanValue(true));
+  }
+  auto expr = conjuncts[0];
+  for (size_t i = 1; i < conjuncts.size(); i++) {
+    expr = std::make_shared<LogicExpression>(expr, conjuncts[i], LogicType::And);
+  }
+  return expr;
+}
+
 auto Optimizer::OptimizeMergeFilterNLJ(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
   std::vector<AbstractPlanNodeRef> children;
   for (const auto &child : plan->GetChildren()) {
@@ -28,105 +28,51 @@ namespace bustub {
 		if (optimized_plan->GetType() == PlanType::NestedLoopJoin) {
 			const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*optimized_plan);
 			// Has exactly two children
-			std::vector<AbstractExpressionRef> left_key_expr, right_key_expr;
 			BUSTUB_ENSURE(nlj_plan.children_.size() == 2, "NLJ should have exactly 2 children.");
-			auto f = [&](const ComparisonExpression *expr) {
-				if (expr->comp_type_ == ComparisonType::Equal) {
-					if (const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
-						left_expr != nullptr) {
-						if (const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
-							right_expr != nullptr) {
-							// Ensure both exprs have tuple_id == 0
-							auto left_expr_tuple_0 =
-								std::make_shared<ColumnValueExpression>(0, left_expr->GetColIdx(),
-																		left_expr->GetReturnType());
-							auto right_expr_tuple_0 =
-								std::make_shared<ColumnValueExpression>(0, right_expr->GetColIdx(),
-																		right_expr->GetReturnType());
-							// Now it's in form of <column_expr> = <column_expr>. Let's match an index for them.
-							if (left_expr->GetTupleIdx() == 0 && right_expr->GetTupleIdx() == 1) {
-								left_key_expr.push_back(left_expr_tuple_0);
-								right_key_expr.push_back(right_expr_tuple_0);
-							}
-							if (left_expr->GetTupleIdx() == 1 && right_expr->GetTupleIdx() == 0) {
-								left_key_expr.push_back(right_expr_tuple_0);
-								right_key_expr.push_back(left_expr_tuple_0);
-							}
-							// Ensure right child is table scan
+			std::vector<AbstractExpressionRef> left_key_expr, right_key_expr, residual;
+			for (const auto &conjunct: SplitConjuncts(nlj_plan.Predicate())) {
+				// Check if expr is equal condition where one is for the left table, and one is for the right table.
+				const auto *expr = dynamic_cast<const ComparisonExpression *>(conjunct.get());
+				if (expr != nullptr && expr->comp_type_ == ComparisonType::Equal) {
+					const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
+					const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
+					if (left_expr != nullptr && right_expr != nullptr &&
+						left_expr->GetTupleIdx() != right_expr->GetTupleIdx()) {
+						if (left_expr->GetTupleIdx() == 1) {
+							std::swap(left_expr, right_expr);
 						}
+						// Ensure both exprs have tuple_id == 0
+						left_key_expr.push_back(std::make_shared<ColumnValueExpression>(0, left_expr->GetColIdx(),
+																								 left_expr->GetReturnType()));
+						right_key_expr.push_back(std::make_shared<ColumnValueExpression>(0, right_expr->GetColIdx(),
+																								  right_expr->GetReturnType()));
+						continue;
 					}
 				}
-				return plan;
-			};
-
-			// Check if expr is equal condition where one is for the left table, and one is for the right table.
-			if (const auto *expr = dynamic_cast<const LogicExpression *>(nlj_plan.Predicate().get()); expr !=
-																									  nullptr) {
-				if (expr->logic_type_ == LogicType::And) {
-					if (const auto *left_expr = dynamic_cast<const ComparisonExpression *>(expr->children_[0].get());
-						left_expr != nullptr) {
-						f(left_expr);
-
-						if (const auto *right_expr = dynamic_cast<const ComparisonExpression *>(expr->children_[1].get());
-							right_expr != nullptr) {
-							f(right_expr);
-						}
-					}
-
-					return std::make_shared<HashJoinPlanNode>(
-						nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
-						nlj_plan.GetRightPlan(),
-						std::vector<AbstractExpressionRef>{std::move(left_key_expr)},
-						std::vector<AbstractExpressionRef>{std::move(right_key_expr)},
-						nlj_plan.GetJoinType());
-
-				}
+				residual.push_back(conjunct);
 			}
 
-			if (const auto *expr = dynamic_cast<const ComparisonExpression *>(nlj_plan.Predicate().get()); expr !=
-																										   nullptr) {
-				if (expr->comp_type_ == ComparisonType::Equal) {
-					if (const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
-						left_expr != nullptr) {
-						if (const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
-							right_expr != nullptr) {
-							// Ensure both exprs have tuple_id == 0
-							auto left_expr_tuple_0 =
-								std::make_shared<ColumnValueExpression>(0, left_expr->GetColIdx(),
-																		left_expr->GetReturnType());
-							auto right_expr_tuple_0 =
-								std::make_shared<ColumnValueExpression>(0, right_expr->GetColIdx(),
-																		right_expr->GetReturnType());
-							// Now it's in form of <column_expr> = <column_expr>. Let's match an index for them.
-							if (left_expr->GetTupleIdx() == 0 && right_expr->GetTupleIdx() == 1) {
-								return std::make_shared<HashJoinPlanNode>(
-									nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
-									nlj_plan.GetRightPlan(),
-									std::vector<AbstractExpressionRef>{std::move(left_expr_tuple_0)},
-									std::vector<AbstractExpressionRef>{std::move(right_expr_tuple_0)},
-									nlj_plan.GetJoinType());
-							}
-							if (left_expr->GetTupleIdx() == 1 && right_expr->GetTupleIdx() == 0) {
-								return std::make_shared<HashJoinPlanNode>(
-									nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
-									nlj_plan.GetRightPlan(),
-									std::vector<AbstractExpressionRef>{std::move(right_expr_tuple_0)},
-									std::vector<AbstractExpressionRef>{std::move(left_expr_tuple_0)},
-									nlj_plan.GetJoinType());
-							}
-							// Ensure right child is table scan
-
-						}
-					}
-				}
+			// A left join pads the left rows failing the other conjuncts with NULLs, which a filter above cannot do.
+			if (left_key_expr.empty() || (!residual.empty() && nlj_plan.GetJoinType() != JoinType::INNER)) {
+				return optimized_plan;
+			}
+			auto hash_join = std::make_shared<HashJoinPlanNode>(
+				nlj_plan.output_schema_, nlj_plan.GetLeftPlan(), nlj_plan.GetRightPlan(), std::move(left_key_expr),
+				std::move(right_key_expr), nlj_plan.GetJoinType());
+			if (residual.empty()) {
+				return hash_join;
 			}
+			// The filter reads the joined rows, where the columns of the right side follow the ones of the left side.
+			auto left_column_cnt = nlj_plan.GetLeftPlan()->OutputSchema().GetColumnCount();
+			auto residual_expr = RemapColumns(CombineConjuncts(residual), [&](const ColumnValueExpression &col) {
+				return std::make_shared<ColumnValueExpression>(
+					0, col.GetColIdx() + (col.GetTupleIdx() == 1 ? left_column_cnt : 0), col.GetReturnType());
+			});
+			return std::make_shared<FilterPlanNode>(nlj_plan.output_schema_, std::move(residual_expr),
+												std::move(hash_join));
 		}
 
-		// TODO(student): implement NestedLoopJoin -> HashJoin optimizer rule
-		// Note for 2023 Spring: You should at least support join keys of the form:
-		// 1. <column expr> = <column expr>
-		// 2. <column expr> = <column expr> AND <column expr> = <column expr>
-		return plan;
+		return optimized_plan;
 	}
 
 
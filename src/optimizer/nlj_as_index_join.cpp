@@ -24,12 +24,19 @@ namespace bustub {
 auto Optimizer::MatchIndex(const std::string &table_name, uint32_t index_key_idx)
     -> std::optional<std::tuple<index_oid_t, std::string>> {
   const auto key_attrs = std::vector{index_key_idx};
+  std::optional<std::tuple<index_oid_t, std::string>> matched = std::nullopt;
   for (const auto *index_info : catalog_.GetTableIndexes(table_name)) {
     if (key_attrs == index_info->index_->GetKeyAttrs()) {
-      return std::make_optional(std::make_tuple(index_info->index_oid_, index_info->name_));
+      // an equality probe is O(1) on a hash index, so prefer it over a B+ tree on the same column
+      if (index_info->index_type_ == IndexType::HashTableIndex) {
+        return std::make_optional(std::make_tuple(index_info->index_oid_, index_info->name_));
+      }
+      if (matched == std::nullopt) {
+        matched = std::make_optional(std::make_tuple(index_info->index_oid_, index_info->name_));
+      }
     }
   }
-  return std::nullopt;
+  return matched;
 }
 
 auto Optimizer::OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
@@ -57,10 +64,27 @@ auto Optimizer::OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> Abstr
                 std::make_shared<ColumnValueExpression>(0, right_expr->GetColIdx(), right_expr->GetReturnType());
             // Now it's in form of <column_expr> = <column_expr>. Let's match an index for them.
 
-            // Ensure right child is table scan
-            if (nlj_plan.GetRightPlan()->GetType() == PlanType::SeqScan) {
+            // Ensure right child is table scan, one without a filter: the index join would drop it
+            if (nlj_plan.GetRightPlan()->GetType() == PlanType::SeqScan &&
+                dynamic_cast<const SeqScanPlanNode &>(*nlj_plan.GetRightPlan()).filter_predicate_ == nullptr) {
               const auto &right_seq_scan = dynamic_cast<const SeqScanPlanNode &>(*nlj_plan.GetRightPlan());
-              if (left_expr->GetTupleIdx() == 0 && right_expr->GetTupleIdx() == 1) {
+              // Probing the index for every left row loses to hashing the right table when the left side is large
+              // compared to it, or when every probe finds many rows. Without an estimate the index is taken.
+              auto prefer_hash_join = [&](uint32_t right_key) {
+                auto left_rows = cost_model_.EstimateRows(*nlj_plan.GetLeftPlan());
+                auto right_rows = cost_model_.TableRows(right_seq_scan.table_name_);
+                if (!left_rows.has_value() || !right_rows.has_value()) {
+                  return false;
+                }
+                auto matches_per_probe =
+                    *right_rows / std::max(cost_model_.DistinctValues(right_seq_scan, right_key).value_or(1), 1.0);
+                auto index_join_cost = CostModel::IndexLookupCost(*left_rows, *left_rows * matches_per_probe);
+                auto hash_join_cost =
+                    CostModel::SeqScanCost(*right_rows) + CostModel::HashJoinCost(*right_rows, *left_rows);
+                return hash_join_cost < index_join_cost;
+              };
+              if (left_expr->GetTupleIdx() == 0 && right_expr->GetTupleIdx() == 1 &&
+                  !prefer_hash_join(right_expr->GetColIdx())) {
                 if (auto index = MatchIndex(right_seq_scan.table_name_, right_expr->GetColIdx());
                     index != std::nullopt) {
                   auto [index_oid, index_name] = *index;
@@ -70,7 +94,8 @@ auto Optimizer::OptimizeNLJAsIndexJoin(const AbstractPlanNodeRef &plan) -> Abstr
                       right_seq_scan.output_schema_, nlj_plan.GetJoinType());
                 }
               }
-              if (left_expr->GetTupleIdx() == 1 && right_expr->GetTupleIdx() == 0) {
+              if (left_expr->GetTupleIdx() == 1 && right_expr->GetTupleIdx() == 0 &&
+                  !prefer_hash_join(left_expr->GetColIdx())) {
                 if (auto index = MatchIndex(right_seq_scan.table_name_, left_expr->GetColIdx());
                     index != std::nullopt) {
                   auto [index_oid, index_name] = *index;
@@ -1,6 +1,5 @@
 #include "optimizer/optimizer.h"
 #include <optional>
-#include "common/util/string_util.h"
 #include "execution/plans/abstract_plan.h"
 
 namespace bustub {
@@ -21,23 +20,9 @@ namespace bustub {
     }
 
     auto Optimizer::EstimatedCardinality(const std::string &table_name) -> std::optional<size_t> {
-        if (StringUtil::EndsWith(table_name, "_1m")) {
-            return std::make_optional(1000000);
-        }
-        if (StringUtil::EndsWith(table_name, "_100k")) {
-            return std::make_optional(100000);
-        }
-        if (StringUtil::EndsWith(table_name, "_50k")) {
-            return std::make_optional(50000);
-        }
-        if (StringUtil::EndsWith(table_name, "_10k")) {
-            return std::make_optional(10000);
-        }
-        if (StringUtil::EndsWith(table_name, "_1k")) {
-            return std::make_optional(1000);
-        }
-        if (StringUtil::EndsWith(table_name, "_100")) {
-            return std::make_optional(100);
+        auto rows = cost_model_.TableRows(table_name);
+        if (rows.has_value()) {
+            return std::make_optional(static_cast<size_t>(*rows));
         }
         return std::nullopt;
     }
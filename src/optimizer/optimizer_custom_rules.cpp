@@ -10,10 +10,17 @@ namespace bustub {
     auto Optimizer::OptimizeCustom(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
         auto p = plan;
         p = OptimizeMergeProjection(p);
+        p = OptimizePushDownPredicates(p);
         p = OptimizeMergeFilterNLJ(p);
+        p = OptimizeJoinOrder(p);
+        p = OptimizeMergeFilterScan(p);
+        p = OptimizeSeqScanAsIndexScan(p);
+        p = OptimizeNLJAsIndexJoin(p);
         p = OptimizeNLJAsHashJoin(p);
+        p = OptimizeHashJoinBuildSide(p);
         p = OptimizeOrderByAsIndexScan(p);
         p = OptimizeSortLimitAsTopN(p);
+        p = OptimizePruneColumns(p);
         return p;
     }
 
@@ -58,6 +58,10 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
       const auto indices = catalog_.GetTableIndexes(table_info->name_);
 
       for (const auto *index : indices) {
+        // only a B+ tree returns its keys in order
+        if (index->index_type_ != IndexType::BPlusTreeIndex) {
+          continue;
+        }
         const auto &columns = index->key_schema_.GetColumns();
         // check index key schema == order by columns
         bool valid = true;
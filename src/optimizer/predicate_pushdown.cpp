@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the column of a `<column> <op> <constant>` conjunct, in either order, nullptr for other conjuncts */
+auto ColumnComparedToConstant(const AbstractExpression &expr) -> const ColumnValueExpression * {
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (comparison == nullptr) {
+    return nullptr;
+  }
+  for (size_t i = 0; i < 2; i++) {
+    const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(i).get());
+    const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1 - i).get());
+    if (column != nullptr && constant != nullptr) {
+      return column;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Derives the conjuncts implied by `<column> = <column>` ones: `a = b AND a < 5` implies `b < 5`, which can then be
+ * pushed to the side of a join that `b` comes from.
+ */
+void AddTransitiveConjuncts(std::vector<AbstractExpressionRef> *conjuncts) {
+  // union-find over the columns compared for equality
+  std::unordered_map<uint32_t, uint32_t> parent;
+  std::unordered_map<uint32_t, TypeId> types;
+  std::function<uint32_t(uint32_t)> find = [&](uint32_t col) {
+    auto iter = parent.find(col);
+    if (iter == parent.end() || iter->second == col) {
+      return col;
+    }
+    return iter->second = find(iter->second);
+  };
+  for (const auto &conjunct : *conjuncts) {
+    const auto *comparison = dynamic_cast<const ComparisonExpression *>(conjunct.get());
+    if (comparison == nullptr || comparison->comp_type_ != ComparisonType::Equal) {
+      continue;
+    }
+    const auto *left = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0).get());
+    const auto *right = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1).get());
+    if (left != nullptr && right != nullptr) {
+      types[left->GetColIdx()] = left->GetReturnType();
+      types[right->GetColIdx()] = right->GetReturnType();
+      parent[find(left->GetColIdx())] = find(right->GetColIdx());
+    }
+  }
+  if (parent.empty()) {
+    return;
+  }
+
+  std::unordered_set<std::string> known;
+  for (const auto &conjunct : *conjuncts) {
+    known.insert(conjunct->ToString());
+  }
+  const auto num_conjuncts = conjuncts->size();
+  for (size_t i = 0; i < num_conjuncts; i++) {
+    const auto *column = ColumnComparedToConstant(*(*conjuncts)[i]);
+    if (column == nullptr || types.count(column->GetColIdx()) == 0) {
+      continue;
+    }
+    for (const auto &[other, type] : types) {
+      if (other == column->GetColIdx() || find(other) != find(column->GetColIdx())) {
+        continue;
+      }
+      AbstractExpressionRef other_column = std::make_shared<ColumnValueExpression>(0, other, type);
+      const auto &conjunct = (*conjuncts)[i];
+      auto derived = conjunct->CloneWithChildren(
+          {conjunct->GetChildAt(0).get() == column ? other_column : conjunct->GetChildAt(0),
+           conjunct->GetChildAt(1).get() == column ? other_column : conjunct->GetChildAt(1)});
+      if (known.insert(derived->ToString()).second) {
+        conjuncts->push_back(std::move(derived));
+      }
+    }
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizePushDownPredicates(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  return PushDownPredicates(plan, {});
+}
+
+auto Optimizer::PushDownPredicates(const AbstractPlanNodeRef &plan, std::vector<AbstractExpressionRef> conjuncts)
+    -> AbstractPlanNodeRef {
+  // The conjuncts that go no further are checked by a filter right above the node.
+  auto filtered = [&](AbstractPlanNodeRef node, const std::vector<AbstractExpressionRef> &kept) -> AbstractPlanNodeRef {
+    if (kept.empty()) {
+      return node;
+    }
+    return std::make_shared<FilterPlanNode>(node->output_schema_, CombineConjuncts(kept), std::move(node));
+  };
+
+  switch (plan->GetType()) {
+    case PlanType::Filter: {
+      const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*plan);
+      for (auto &conjunct : SplitConjuncts(filter_plan.GetPredicate())) {
+        conjuncts.push_back(std::move(conjunct));
+      }
+      return PushDownPredicates(filter_plan.GetChildPlan(), std::move(conjuncts));
+    }
+    case PlanType::Sort:
+      // sorting keeps every row, filtering them first leaves fewer to sort
+      return plan->CloneWithChildren({PushDownPredicates(plan->GetChildAt(0), std::move(conjuncts))});
+    case PlanType::Projection: {
+      // the projection computes every row from one row of its child, the expressions can be checked on that row
+      const auto &projection_plan = dynamic_cast<const ProjectionPlanNode &>(*plan);
+      std::vector<AbstractExpressionRef> pushed;
+      for (const auto &conjunct : conjuncts) {
+        pushed.push_back(RemapColumns(conjunct, [&](const ColumnValueExpression &col) {
+          return projection_plan.GetExpressions()[col.GetColIdx()];
+        }));
+      }
+      return plan->CloneWithChildren({PushDownPredicates(projection_plan.GetChildPlan(), std::move(pushed))});
+    }
+    case PlanType::Aggregation: {
+      // a conjunct on the group-by keys keeps or drops whole groups, it can drop their rows instead
+      const auto &agg_plan = dynamic_cast<const AggregationPlanNode &>(*plan);
+      const auto &group_bys = agg_plan.GetGroupBys();
+      std::vector<AbstractExpressionRef> pushed;
+      std::vector<AbstractExpressionRef> kept;
+      for (auto &conjunct : conjuncts) {
+        std::vector<uint32_t> columns;
+        CollectColumns(*conjunct, &columns);
+        // without columns, the conjunct might drop the single row an aggregation without groups produces
+        if (columns.empty() ||
+            std::any_of(columns.begin(), columns.end(), [&](uint32_t col) { return col >= group_bys.size(); })) {
+          kept.push_back(std::move(conjunct));
+          continue;
+        }
+        pushed.push_back(
+            RemapColumns(conjunct, [&](const ColumnValueExpression &col) { return group_bys[col.GetColIdx()]; }));
+      }
+      return filtered(plan->CloneWithChildren({PushDownPredicates(agg_plan.GetChildPlan(), std::move(pushed))}), kept);
+    }
+    case PlanType::NestedLoopJoin: {
+      const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*plan);
+      const auto left_column_cnt = nlj_plan.GetLeftPlan()->OutputSchema().GetColumnCount();
+      const auto right_column_cnt = nlj_plan.GetRightPlan()->OutputSchema().GetColumnCount();
+      const bool inner = nlj_plan.GetJoinType() == JoinType::INNER;
+      // the join predicate, reading the joined rows like the conjuncts from above
+      auto join_predicate = SplitConjuncts(RemapColumns(nlj_plan.Predicate(), [&](const ColumnValueExpression &col) {
+        return std::make_shared<ColumnValueExpression>(
+            0, col.GetColIdx() + (col.GetTupleIdx() == 1 ? left_column_cnt : 0), col.GetReturnType());
+      }));
+      if (inner) {
+        // an inner join is a filter over the cross product, its predicate and the filters above are alike
+        conjuncts.insert(conjuncts.end(), join_predicate.begin(), join_predicate.end());
+        join_predicate.clear();
+        AddTransitiveConjuncts(&conjuncts);
+      }
+
+      std::vector<AbstractExpressionRef> left_conjuncts;
+      std::vector<AbstractExpressionRef> right_conjuncts;
+      std::vector<AbstractExpressionRef> join_conjuncts;
+      std::vector<AbstractExpressionRef> kept;
+      auto to_right = [&](const AbstractExpressionRef &conjunct) {
+        return RemapColumns(conjunct, [&](const ColumnValueExpression &col) {
+          return std::make_shared<ColumnValueExpression>(0, col.GetColIdx() - left_column_cnt, col.GetReturnType());
+        });
+      };
+      auto reads_only = [&](const AbstractExpression &conjunct, bool left) {
+        std::vector<uint32_t> columns;
+        CollectColumns(conjunct, &columns);
+        return !columns.empty() && std::all_of(columns.begin(), columns.end(), [&](uint32_t col) {
+          return (col < left_column_cnt) == left;
+        });
+      };
+      for (auto &conjunct : conjuncts) {
+        if (reads_only(*conjunct, true)) {
+          left_conjuncts.push_back(std::move(conjunct));
+        } else if (inner && reads_only(*conjunct, false)) {
+          right_conjuncts.push_back(to_right(conjunct));
+        } else if (inner) {
+          join_conjuncts.push_back(std::move(conjunct));
+        } else {
+          // a left join pads the left rows without a match with NULLs, a filter on them has to stay above
+          kept.push_back(std::move(conjunct));
+        }
+      }
+      // a conjunct of a left join reading only the right side decides which right rows can match
+      for (auto &conjunct : join_predicate) {
+        if (reads_only(*conjunct, false)) {
+          right_conjuncts.push_back(to_right(conjunct));
+        } else {
+          join_conjuncts.push_back(std::move(conjunct));
+        }
+      }
+
+      auto join = std::make_shared<NestedLoopJoinPlanNode>(
+          nlj_plan.output_schema_, PushDownPredicates(nlj_plan.GetLeftPlan(), std::move(left_conjuncts)),
+          PushDownPredicates(nlj_plan.GetRightPlan(), std::move(right_conjuncts)),
+          RewriteExpressionForJoin(CombineConjuncts(join_conjuncts), left_column_cnt, right_column_cnt),
+          nlj_plan.GetJoinType());
+      return filtered(std::move(join), kept);
+    }
+    default: {
+      std::vector<AbstractPlanNodeRef> children;
+      for (const auto &child : plan->GetChildren()) {
+        children.emplace_back(PushDownPredicates(child, {}));
+      }
+      return filtered(plan->CloneWithChildren(std::move(children)), conjuncts);
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,274 @@
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/limit_plan.h"
+#include "execution/plans/nested_loop_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** Maps each output column of a plan before pruning to its position after pruning, or nullopt if it was dropped */
+using ColumnMap = std::vector<std::optional<uint32_t>>;
+
+auto IdentityMap(size_t num_columns) -> ColumnMap {
+  ColumnMap map(num_columns);
+  for (size_t i = 0; i < num_columns; i++) {
+    map[i] = i;
+  }
+  return map;
+}
+
+/** Marks the columns `expr` reads, of the left (tuple_idx 0) or the right tuple */
+void CollectColumns(const AbstractExpressionRef &expr, std::vector<bool> *left, std::vector<bool> *right) {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+    (column->GetTupleIdx() == 0 ? left : right)->at(column->GetColIdx()) = true;
+    return;
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, left, right);
+  }
+}
+
+void CollectColumns(const AbstractExpressionRef &expr, std::vector<bool> *used) { CollectColumns(expr, used, used); }
+
+/** Points the columns `expr` reads to their positions after pruning */
+auto RewriteColumns(const AbstractExpressionRef &expr, const ColumnMap &left, const ColumnMap &right)
+    -> AbstractExpressionRef {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr.get()); column != nullptr) {
+    const auto &map = column->GetTupleIdx() == 0 ? left : right;
+    BUSTUB_ASSERT(map[column->GetColIdx()].has_value(), "a column in use was pruned");
+    return std::make_shared<ColumnValueExpression>(column->GetTupleIdx(), *map[column->GetColIdx()],
+                                                   column->GetReturnType());
+  }
+  std::vector<AbstractExpressionRef> children;
+  for (const auto &child : expr->GetChildren()) {
+    children.emplace_back(RewriteColumns(child, left, right));
+  }
+  return expr->CloneWithChildren(std::move(children));
+}
+
+auto RewriteColumns(const AbstractExpressionRef &expr, const ColumnMap &map) -> AbstractExpressionRef {
+  return RewriteColumns(expr, map, map);
+}
+
+/** The columns marked in `required`, at least one so that rows still have a column to carry them */
+auto KeptColumns(const std::vector<bool> &required) -> std::vector<uint32_t> {
+  std::vector<uint32_t> kept;
+  for (uint32_t i = 0; i < required.size(); i++) {
+    if (required[i]) {
+      kept.push_back(i);
+    }
+  }
+  if (kept.empty() && !required.empty()) {
+    kept.push_back(0);
+  }
+  return kept;
+}
+
+auto MapOf(size_t num_columns, const std::vector<uint32_t> &kept) -> ColumnMap {
+  ColumnMap map(num_columns);
+  for (uint32_t i = 0; i < kept.size(); i++) {
+    map[kept[i]] = i;
+  }
+  return map;
+}
+
+/** Narrows a scan to the required columns of its output, which may already be a subset of the table columns */
+template <typename ScanPlanNode>
+auto PruneScan(const ScanPlanNode &scan, const std::vector<bool> &required, ColumnMap *map) -> AbstractPlanNodeRef {
+  auto kept = KeptColumns(required);
+  if (kept.size() == required.size()) {
+    *map = IdentityMap(required.size());
+    return scan.CloneWithChildren({});
+  }
+  auto pruned = std::make_shared<ScanPlanNode>(scan);
+  pruned->column_ids_.clear();
+  for (auto idx : kept) {
+    pruned->column_ids_.push_back(scan.column_ids_.empty() ? idx : scan.column_ids_[idx]);
+  }
+  pruned->output_schema_ = std::make_shared<Schema>(Schema::CopySchema(&scan.OutputSchema(), kept));
+  *map = MapOf(required.size(), kept);
+  return pruned;
+}
+
+/**
+ * Rewrites `plan` to produce at least the columns marked in `required` of its output, dropping columns nobody reads
+ * where it can.
+ * @param[out] map where the output columns of `plan` went
+ */
+auto PruneColumns(const AbstractPlanNodeRef &plan, const std::vector<bool> &required, ColumnMap *map)
+    -> AbstractPlanNodeRef {
+  switch (plan->GetType()) {
+    case PlanType::SeqScan:
+      return PruneScan(dynamic_cast<const SeqScanPlanNode &>(*plan), required, map);
+    case PlanType::IndexScan:
+      return PruneScan(dynamic_cast<const IndexScanPlanNode &>(*plan), required, map);
+    case PlanType::Projection: {
+      const auto &projection = dynamic_cast<const ProjectionPlanNode &>(*plan);
+      auto kept = KeptColumns(required);
+      std::vector<bool> child_required(projection.GetChildPlan()->OutputSchema().GetColumnCount());
+      for (auto idx : kept) {
+        CollectColumns(projection.GetExpressions()[idx], &child_required);
+      }
+      ColumnMap child_map;
+      auto child = PruneColumns(projection.GetChildPlan(), child_required, &child_map);
+      std::vector<AbstractExpressionRef> expressions;
+      for (auto idx : kept) {
+        expressions.push_back(RewriteColumns(projection.GetExpressions()[idx], child_map));
+      }
+      *map = MapOf(required.size(), kept);
+      return std::make_shared<ProjectionPlanNode>(
+          std::make_shared<Schema>(Schema::CopySchema(&projection.OutputSchema(), kept)), std::move(expressions),
+          std::move(child));
+    }
+    case PlanType::Filter: {
+      const auto &filter = dynamic_cast<const FilterPlanNode &>(*plan);
+      auto child_required = required;
+      CollectColumns(filter.GetPredicate(), &child_required);
+      auto child = PruneColumns(filter.GetChildPlan(), child_required, map);
+      return std::make_shared<FilterPlanNode>(std::make_shared<Schema>(child->OutputSchema()),
+                                              RewriteColumns(filter.GetPredicate(), *map), std::move(child));
+    }
+    case PlanType::Aggregation: {
+      const auto &agg = dynamic_cast<const AggregationPlanNode &>(*plan);
+      std::vector<bool> child_required(agg.GetChildPlan()->OutputSchema().GetColumnCount());
+      for (const auto &expr : agg.GetGroupBys()) {
+        CollectColumns(expr, &child_required);
+      }
+      for (const auto &expr : agg.GetAggregates()) {
+        CollectColumns(expr, &child_required);
+      }
+      ColumnMap child_map;
+      auto child = PruneColumns(agg.GetChildPlan(), child_required, &child_map);
+      std::vector<AbstractExpressionRef> group_bys;
+      for (const auto &expr : agg.GetGroupBys()) {
+        group_bys.push_back(RewriteColumns(expr, child_map));
+      }
+      std::vector<AbstractExpressionRef> aggregates;
+      for (const auto &expr : agg.GetAggregates()) {
+        aggregates.push_back(RewriteColumns(expr, child_map));
+      }
+      *map = IdentityMap(required.size());
+      return std::make_shared<AggregationPlanNode>(agg.output_schema_, std::move(child), std::move(group_bys),
+                                                   std::move(aggregates), agg.GetAggregateTypes());
+    }
+    case PlanType::Sort:
+    case PlanType::TopN: {
+      const auto &order_bys = plan->GetType() == PlanType::Sort
+                                  ? dynamic_cast<const SortPlanNode &>(*plan).GetOrderBy()
+                                  : dynamic_cast<const TopNPlanNode &>(*plan).GetOrderBy();
+      auto child_required = required;
+      for (const auto &[type, expr] : order_bys) {
+        CollectColumns(expr, &child_required);
+      }
+      auto child = PruneColumns(plan->GetChildAt(0), child_required, map);
+      std::vector<std::pair<OrderByType, AbstractExpressionRef>> new_order_bys;
+      for (const auto &[type, expr] : order_bys) {
+        new_order_bys.emplace_back(type, RewriteColumns(expr, *map));
+      }
+      auto schema = std::make_shared<Schema>(child->OutputSchema());
+      if (plan->GetType() == PlanType::Sort) {
+        return std::make_shared<SortPlanNode>(std::move(schema), std::move(child), std::move(new_order_bys));
+      }
+      return std::make_shared<TopNPlanNode>(std::move(schema), std::move(child), std::move(new_order_bys),
+                                            dynamic_cast<const TopNPlanNode &>(*plan).GetN());
+    }
+    case PlanType::Limit: {
+      const auto &limit = dynamic_cast<const LimitPlanNode &>(*plan);
+      auto child = PruneColumns(limit.GetChildPlan(), required, map);
+      return std::make_shared<LimitPlanNode>(std::make_shared<Schema>(child->OutputSchema()), std::move(child),
+                                             limit.GetLimit());
+    }
+    case PlanType::NestedLoopJoin:
+    case PlanType::HashJoin: {
+      const auto &left_plan = plan->GetChildAt(0);
+      const auto &right_plan = plan->GetChildAt(1);
+      const size_t num_left = left_plan->OutputSchema().GetColumnCount();
+      std::vector<bool> left_required(required.begin(), required.begin() + num_left);
+      std::vector<bool> right_required(required.begin() + num_left, required.end());
+      if (plan->GetType() == PlanType::NestedLoopJoin) {
+        CollectColumns(dynamic_cast<const NestedLoopJoinPlanNode &>(*plan).Predicate(), &left_required,
+                       &right_required);
+      } else {
+        const auto &hash_join = dynamic_cast<const HashJoinPlanNode &>(*plan);
+        for (const auto &expr : hash_join.LeftJoinKeyExpressions()) {
+          CollectColumns(expr, &left_required);
+        }
+        for (const auto &expr : hash_join.RightJoinKeyExpressions()) {
+          CollectColumns(expr, &right_required);
+        }
+      }
+      ColumnMap left_map;
+      ColumnMap right_map;
+      auto left = PruneColumns(left_plan, left_required, &left_map);
+      auto right = PruneColumns(right_plan, right_required, &right_map);
+
+      // both sides keep their column order, so the join output keeps the left columns, then the right ones
+      const size_t num_new_left = left->OutputSchema().GetColumnCount();
+      std::vector<uint32_t> kept;
+      map->assign(required.size(), std::nullopt);
+      for (uint32_t i = 0; i < required.size(); i++) {
+        auto new_idx = i < num_left ? left_map[i] : right_map[i - num_left];
+        if (new_idx.has_value()) {
+          (*map)[i] = i < num_left ? *new_idx : num_new_left + *new_idx;
+          kept.push_back(i);
+        }
+      }
+      auto schema = std::make_shared<Schema>(Schema::CopySchema(&plan->OutputSchema(), kept));
+
+      if (plan->GetType() == PlanType::NestedLoopJoin) {
+        const auto &nlj = dynamic_cast<const NestedLoopJoinPlanNode &>(*plan);
+        return std::make_shared<NestedLoopJoinPlanNode>(std::move(schema), std::move(left), std::move(right),
+                                                        RewriteColumns(nlj.Predicate(), left_map, right_map),
+                                                        nlj.GetJoinType());
+      }
+      const auto &hash_join = dynamic_cast<const HashJoinPlanNode &>(*plan);
+      std::vector<AbstractExpressionRef> left_keys;
+      for (const auto &expr : hash_join.LeftJoinKeyExpressions()) {
+        left_keys.push_back(RewriteColumns(expr, left_map));
+      }
+      std::vector<AbstractExpressionRef> right_keys;
+      for (const auto &expr : hash_join.RightJoinKeyExpressions()) {
+        right_keys.push_back(RewriteColumns(expr, right_map));
+      }
+      return std::make_shared<HashJoinPlanNode>(std::move(schema), std::move(left), std::move(right),
+                                                std::move(left_keys), std::move(right_keys),
+                                                hash_join.GetJoinType());
+    }
+    default: {
+      // other plans read whole rows of their children and keep their own output
+      std::vector<AbstractPlanNodeRef> children;
+      for (const auto &child : plan->GetChildren()) {
+        ColumnMap child_map;
+        std::vector<bool> child_required(child->OutputSchema().GetColumnCount(), true);
+        children.emplace_back(PruneColumns(child, child_required, &child_map));
+      }
+      *map = IdentityMap(required.size());
+      return plan->CloneWithChildren(std::move(children));
+    }
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizePruneColumns(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  // the result keeps every column of the query output
+  ColumnMap map;
+  return PruneColumns(plan, std::vector<bool>(plan->OutputSchema().GetColumnCount(), true), &map);
+}
+
+}  // namespace bustub
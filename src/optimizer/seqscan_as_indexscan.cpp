@@ -0,0 +1,73 @@
+#include <memory>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+auto Optimizer::OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSeqScanAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // The predicate is either still in a filter right above the scan, or already merged into the scan.
+  const SeqScanPlanNode *seq_scan = nullptr;
+  AbstractExpressionRef predicate;
+  if (optimized_plan->GetType() == PlanType::Filter) {
+    const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+    BUSTUB_ASSERT(optimized_plan->children_.size() == 1, "must have exactly one children");
+    if (filter_plan.GetChildPlan()->GetType() == PlanType::SeqScan) {
+      seq_scan = dynamic_cast<const SeqScanPlanNode *>(filter_plan.GetChildPlan().get());
+      if (seq_scan->filter_predicate_ != nullptr) {
+        return optimized_plan;
+      }
+      predicate = filter_plan.GetPredicate();
+    }
+  } else if (optimized_plan->GetType() == PlanType::SeqScan) {
+    seq_scan = dynamic_cast<const SeqScanPlanNode *>(optimized_plan.get());
+    predicate = seq_scan->filter_predicate_;
+  }
+  if (seq_scan == nullptr || predicate == nullptr) {
+    return optimized_plan;
+  }
+
+  // Only `<column> = <constant>` (in either order) can be answered by a single index probe.
+  const auto *expr = dynamic_cast<const ComparisonExpression *>(predicate.get());
+  if (expr == nullptr || expr->comp_type_ != ComparisonType::Equal) {
+    return optimized_plan;
+  }
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
+  auto constant_expr = expr->children_[1];
+  if (column_expr == nullptr) {
+    column_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
+    constant_expr = expr->children_[0];
+  }
+  if (column_expr == nullptr || dynamic_cast<const ConstantValueExpression *>(constant_expr.get()) == nullptr) {
+    return optimized_plan;
+  }
+
+  if (auto index = MatchIndex(seq_scan->table_name_, column_expr->GetColIdx()); index != std::nullopt) {
+    // A lookup finding many rows, or one into a small table, is slower than reading the table in order. Without an
+    // estimate the index is taken.
+    if (auto rows = cost_model_.TableRows(seq_scan->table_name_); rows.has_value()) {
+      auto matched = *rows * cost_model_.Selectivity(*predicate, *seq_scan);
+      if (CostModel::SeqScanCost(*rows) < CostModel::IndexLookupCost(1, matched)) {
+        return optimized_plan;
+      }
+    }
+    auto [index_oid, index_name] = *index;
+    return std::make_shared<IndexScanPlanNode>(seq_scan->output_schema_, index_oid, std::move(constant_expr));
+  }
+  return optimized_plan;
+}
+
+}  // namespace bustub
@@ -91,13 +91,13 @@ auto Planner::PlanSelectAgg(const SelectStatement &statement, AbstractPlanNodeRe
     output_col_names.emplace_back(std::move(col_name));
   }
 
-  // Rewrite all agg call inside having.
+  // Collect all agg call inside having.
   if (!statement.having_->IsInvalid()) {
     AddAggCallToContext(*statement.having_);
   }
 
-  // Rewrite all agg call inside expression to a pseudo one.
-  for (auto &item : statement.select_list_) {
+  // Collect all agg call inside expression.
+  for (const auto &item : statement.select_list_) {
     AddAggCallToContext(*item);
   }
 
@@ -8,6 +8,7 @@
 #include "binder/expressions/bound_column_ref.h"
 #include "binder/expressions/bound_constant.h"
 #include "binder/expressions/bound_func_call.h"
+#include "binder/expressions/bound_parameter.h"
 #include "binder/expressions/bound_unary_op.h"
 #include "binder/statement/select_statement.h"
 #include "common/exception.h"
@@ -100,34 +101,39 @@ auto Planner::PlanConstant(const BoundConstant &expr, const std::vector<Abstract
   return std::make_shared<ConstantValueExpression>(expr.val_);
 }
 
-void Planner::AddAggCallToContext(BoundExpression &expr) {
+auto Planner::PlanParameter(const BoundParameter &expr, const std::vector<AbstractPlanNodeRef> &children)
+    -> AbstractExpressionRef {
+  if (expr.index_ >= parameters_.size()) {
+    throw Exception(fmt::format("no value for parameter {}", expr.ToString()));
+  }
+  return std::make_shared<ConstantValueExpression>(parameters_[expr.index_]);
+}
+
+void Planner::AddAggCallToContext(const BoundExpression &expr) {
   switch (expr.type_) {
     case ExpressionType::AGG_CALL: {
-      auto &agg_call_expr = dynamic_cast<BoundAggCall &>(expr);
-      auto agg_name = fmt::format("__pseudo_agg#{}", ctx_.aggregations_.size());
-      auto agg_call =
-          BoundAggCall(agg_name, agg_call_expr.is_distinct_, std::vector<std::unique_ptr<BoundExpression>>{});
-      // Replace the agg call in the original bound expression with a pseudo one, add agg call to the context.
-      ctx_.AddAggregation(std::make_unique<BoundAggCall>(std::exchange(agg_call_expr, std::move(agg_call))));
+      // Add the agg call to the context, `PlanExpression` later takes the agg calls in the same order.
+      ctx_.AddAggregation(&expr);
       return;
     }
     case ExpressionType::COLUMN_REF: {
       return;
     }
     case ExpressionType::BINARY_OP: {
-      auto &binary_op_expr = dynamic_cast<BoundBinaryOp &>(expr);
+      const auto &binary_op_expr = dynamic_cast<const BoundBinaryOp &>(expr);
       AddAggCallToContext(*binary_op_expr.larg_);
       AddAggCallToContext(*binary_op_expr.rarg_);
       return;
     }
     case ExpressionType::FUNC_CALL: {
-      auto &func_call_expr = dynamic_cast<BoundFuncCall &>(expr);
+      const auto &func_call_expr = dynamic_cast<const BoundFuncCall &>(expr);
       for (const auto &child : func_call_expr.args_) {
         AddAggCallToContext(*child);
       }
       return;
     }
-    case ExpressionType::CONSTANT: {
+    case ExpressionType::CONSTANT:
+    case ExpressionType::PARAMETER: {
       return;
     }
     case ExpressionType::ALIAS: {
@@ -166,6 +172,10 @@ auto Planner::PlanExpression(const BoundExpression &expr, const std::vector<Abst
       const auto &constant_expr = dynamic_cast<const BoundConstant &>(expr);
       return std::make_tuple(UNNAMED_COLUMN, PlanConstant(constant_expr, children));
     }
+    case ExpressionType::PARAMETER: {
+      const auto &parameter_expr = dynamic_cast<const BoundParameter &>(expr);
+      return std::make_tuple(UNNAMED_COLUMN, PlanParameter(parameter_expr, children));
+    }
     case ExpressionType::ALIAS: {
       const auto &alias_expr = dynamic_cast<const BoundAlias &>(expr);
       auto [_1, expr] = PlanExpression(*alias_expr.child_, children);
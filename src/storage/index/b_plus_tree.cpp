@@ -1,6 +1,7 @@
 #include <sstream>
 #include <string>
 
+#include "common/config.h"
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/rid.h"
@@ -17,12 +18,16 @@ namespace bustub {
           comparator_(std::move(comparator)),
           leaf_max_size_(leaf_max_size),
           internal_max_size_(internal_max_size),
-          header_page_id_(header_page_id) {
+          header_page_id_(header_page_id),
+          leaf_low_water_mark_(std::max(1, leaf_max_size / 4)) {
         //  WritePageGuard guard = bpm_->FetchPageWrite(header_page_id_);
         //  auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
         root_page_id_ = INVALID_PAGE_ID;
     }
 
+    INDEX_TEMPLATE_ARGUMENTS
+    BPLUSTREE_TYPE::~BPlusTree() { StopBackgroundCompaction(); }
+
 /*
  * Helper function to decide whether current b+tree is empty
  */
@@ -139,7 +144,9 @@ namespace bustub {
                 ReleaseLatchFromQueue(txn);
 //				bpm_->UnpinPage(page->GetPageId(), false);
             }
-            if (operation_type == Operation::DELETE && child_node->GetSize() > child_node->GetMinSize()) {
+            // Leaves are allowed to drain down to the low-water mark before Remove() rebalances them.
+            auto delete_safe_size = child_node->IsLeafPage() ? leaf_low_water_mark_ : child_node->GetMinSize();
+            if (operation_type == Operation::DELETE && child_node->GetSize() > delete_safe_size) {
                 ReleaseLatchFromQueue(txn);
 //				bpm_->UnpinPage(page->GetPageId(), false);
             }
@@ -248,7 +255,8 @@ namespace bustub {
             bpm_->UnpinPage(cur_node->GetPage(), false);
             return;
         }
-        if (cur_node->GetSize() >= std::ceil(cur_node->GetMaxSize() / 2) || cur_node->IsRootPage()) {
+        // Lazy deletion: a leaf above the low-water mark is left sparse and picked up later by Compact().
+        if (cur_node->GetSize() >= leaf_low_water_mark_ || cur_node->IsRootPage()) {
             ReleaseLatchFromQueue(txn);
             cur_page->WUnlatch();
             bpm_->UnpinPage(cur_node->GetPage(), true);
@@ -431,6 +439,133 @@ namespace bustub {
         bpm_->UnpinPage(node1->GetPage(), true);
     }
 
+/*****************************************************************************
+ * COMPACTION
+ *****************************************************************************/
+/*
+ * Merge adjacent sparse leaves left behind by lazy deletion. The tree is
+ * walked top-down holding the parent latch while its children are latched
+ * left to right, which is the same order Insert/Remove acquire latches in.
+ * @return : number of leaf pages handed back to the buffer pool
+ */
+    INDEX_TEMPLATE_ARGUMENTS
+    auto BPLUSTREE_TYPE::Compact() -> size_t {
+        root_page_id_latch_.WLock();
+        size_t reclaimed = 0;
+        if (!IsEmpty()) {
+            reclaimed = CompactNode(root_page_id_);
+        }
+        root_page_id_latch_.WUnlock();
+        return reclaimed;
+    }
+
+    INDEX_TEMPLATE_ARGUMENTS
+    auto BPLUSTREE_TYPE::CompactNode(page_id_t page_id) -> size_t {
+        auto page = bpm_->FetchPage(page_id);
+        page->WLatch();
+        auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+        if (node->IsLeafPage()) {
+            page->WUnlatch();
+            bpm_->UnpinPage(page_id, false);
+            return 0;
+        }
+        auto parent = reinterpret_cast<InternalPage *>(node);
+        size_t reclaimed = 0;
+        bool dirty = false;
+
+        auto first_page = bpm_->FetchPage(parent->ValueAt(0));
+        bool children_are_leaves = reinterpret_cast<BPlusTreePage *>(first_page->GetData())->IsLeafPage();
+        bpm_->UnpinPage(first_page->GetPageId(), false);
+
+        if (!children_are_leaves) {
+            for (int i = 0; i < parent->GetSize(); ++i) {
+                reclaimed += CompactNode(parent->ValueAt(i));
+            }
+            page->WUnlatch();
+            bpm_->UnpinPage(page_id, false);
+            return reclaimed;
+        }
+
+        int i = 1;
+        while (i < parent->GetSize()) {
+            // A non-root internal page must keep at least two children.
+            if (!parent->IsRootPage() && parent->GetSize() <= 2) {
+                break;
+            }
+            auto left_page = bpm_->FetchPage(parent->ValueAt(i - 1));
+            left_page->WLatch();
+            auto right_page = bpm_->FetchPage(parent->ValueAt(i));
+            right_page->WLatch();
+            auto left = reinterpret_cast<LeafPage *>(left_page->GetData());
+            auto right = reinterpret_cast<LeafPage *>(right_page->GetData());
+            bool sparse = left->GetSize() < left->GetMinSize() || right->GetSize() < right->GetMinSize();
+            if (sparse && left->GetSize() + right->GetSize() < leaf_max_size_) {
+                left->MergeRightNode(right);
+                parent->DeleteKeyIndex(i);
+                dirty = true;
+                auto right_page_id = right_page->GetPageId();
+                right_page->WUnlatch();
+                bpm_->UnpinPage(right_page_id, false);
+                bpm_->DeletePage(right_page_id);
+                left_page->WUnlatch();
+                bpm_->UnpinPage(left_page->GetPageId(), true);
+                ++reclaimed;
+                // stay on the same left leaf, it may absorb the next neighbour as well
+                continue;
+            }
+            right_page->WUnlatch();
+            bpm_->UnpinPage(right_page->GetPageId(), false);
+            left_page->WUnlatch();
+            bpm_->UnpinPage(left_page->GetPageId(), false);
+            ++i;
+        }
+
+        // The root lost all but one child: promote that leaf to be the new root.
+        if (parent->IsRootPage() && parent->GetSize() == 1) {
+            auto child_page = bpm_->FetchPage(parent->ValueAt(0));
+            child_page->WLatch();
+            reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPage(INVALID_PAGE_ID);
+            root_page_id_ = child_page->GetPageId();
+            child_page->WUnlatch();
+            bpm_->UnpinPage(child_page->GetPageId(), true);
+            page->WUnlatch();
+            bpm_->UnpinPage(page_id, true);
+            bpm_->DeletePage(page_id);
+            return reclaimed + 1;
+        }
+
+        page->WUnlatch();
+        bpm_->UnpinPage(page_id, dirty);
+        return reclaimed;
+    }
+
+    INDEX_TEMPLATE_ARGUMENTS
+    void BPLUSTREE_TYPE::StartBackgroundCompaction() {
+        if (enable_compaction_.exchange(true)) {
+            return;
+        }
+        compaction_thread_ = std::make_unique<std::thread>(&BPlusTree::RunBackgroundCompaction, this);
+    }
+
+    INDEX_TEMPLATE_ARGUMENTS
+    void BPLUSTREE_TYPE::StopBackgroundCompaction() {
+        enable_compaction_ = false;
+        if (compaction_thread_ != nullptr && compaction_thread_->joinable()) {
+            compaction_thread_->join();
+        }
+        compaction_thread_ = nullptr;
+    }
+
+    INDEX_TEMPLATE_ARGUMENTS
+    void BPLUSTREE_TYPE::RunBackgroundCompaction() {
+        while (enable_compaction_) {
+            std::this_thread::sleep_for(btree_compaction_interval);
+            if (!enable_compaction_) {
+                break;
+            }
+            Compact();
+        }
+    }
 
 /*****************************************************************************
  * INDEX ITERATOR
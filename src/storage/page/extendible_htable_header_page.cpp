@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_htable_header_page.cpp
+//
+// Identification: src/storage/page/extendible_htable_header_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/extendible_htable_header_page.h"
+
+#include "common/logger.h"
+
+namespace bustub {
+
+void ExtendibleHTableHeaderPage::Init(uint32_t max_depth) {
+  BUSTUB_ASSERT(max_depth <= HTABLE_HEADER_MAX_DEPTH, "header max depth out of range");
+  max_depth_ = max_depth;
+  for (auto &directory_page_id : directory_page_ids_) {
+    directory_page_id = INVALID_PAGE_ID;
+  }
+}
+
+auto ExtendibleHTableHeaderPage::HashToDirectoryIndex(uint32_t hash) const -> uint32_t {
+  if (max_depth_ == 0) {
+    return 0;
+  }
+  return hash >> (sizeof(uint32_t) * 8 - max_depth_);
+}
+
+auto ExtendibleHTableHeaderPage::GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t {
+  return directory_page_ids_[directory_idx];
+}
+
+void ExtendibleHTableHeaderPage::SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id) {
+  directory_page_ids_[directory_idx] = directory_page_id;
+}
+
+auto ExtendibleHTableHeaderPage::MaxSize() const -> uint32_t { return 1U << max_depth_; }
+
+void ExtendibleHTableHeaderPage::PrintHeader() const {
+  LOG_DEBUG("======== HEADER (max_depth_: %u) ========", max_depth_);
+  LOG_DEBUG("| directory_idx | page_id |");
+  for (uint32_t idx = 0; idx < MaxSize(); idx++) {
+    LOG_DEBUG("|    %u    |    %d    |", idx, directory_page_ids_[idx]);
+  }
+  LOG_DEBUG("======== END HEADER ========");
+}
+
+}  // namespace bustub
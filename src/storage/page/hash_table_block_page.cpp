@@ -10,39 +10,163 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "storage/page/hash_table_block_page.h"
+#include "common/logger.h"
 #include "storage/index/generic_key.h"
 
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const -> KeyType {
-  return {};
+  return array_[bucket_ind].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const -> ValueType {
-  return {};
+  return array_[bucket_ind].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  // Claim the slot by flipping its readable bit; tombstones (occupied but not readable) can be claimed again.
+  auto mask = static_cast<char>(1 << (bucket_ind % 8));
+  char expected = readable_[bucket_ind / 8].load();
+  do {
+    if ((expected & mask) != 0) {
+      return false;
+    }
+  } while (!readable_[bucket_ind / 8].compare_exchange_weak(expected, static_cast<char>(expected | mask)));
+  array_[bucket_ind] = MappingType(key, value);
+  occupied_[bucket_ind / 8] |= mask;
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {}
+void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
+  // Leave the occupied bit set as a tombstone so probes keep walking past this slot.
+  readable_[bucket_ind / 8] &= static_cast<char>(~(1 << (bucket_ind % 8)));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const -> bool {
-  return false;
+  return (occupied_[bucket_ind / 8] & (1 << (bucket_ind % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const -> bool {
+  return (readable_[bucket_ind / 8] & (1 << (bucket_ind % 8))) != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BLOCK_TYPE::FindUnoccupied(slot_offset_t start) const -> slot_offset_t {
+  slot_offset_t slot = start;
+  while (slot < BLOCK_ARRAY_SIZE) {
+    // bits of the current byte at or after slot that are still free
+    auto free_bits = static_cast<unsigned char>(~occupied_[slot / 8] & (0xFF << (slot % 8)));
+    if (free_bits != 0) {
+      slot = slot / 8 * 8 + __builtin_ctz(free_bits);
+      return std::min<slot_offset_t>(slot, BLOCK_ARRAY_SIZE);
+    }
+    slot = slot / 8 * 8 + 8;
+  }
+  return BLOCK_ARRAY_SIZE;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BLOCK_TYPE::NextReadable(slot_offset_t start, slot_offset_t end) const -> slot_offset_t {
+  slot_offset_t slot = start;
+  while (slot < end) {
+    auto live_bits = static_cast<unsigned char>(readable_[slot / 8] & (0xFF << (slot % 8)));
+    if (live_bits != 0) {
+      return std::min(slot / 8 * 8 + __builtin_ctz(live_bits), end);
+    }
+    slot = slot / 8 * 8 + 8;
+  }
+  return end;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BLOCK_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
+  bool found = false;
+  for (slot_offset_t slot = NextReadable(0, BLOCK_ARRAY_SIZE); slot < BLOCK_ARRAY_SIZE;
+       slot = NextReadable(slot + 1, BLOCK_ARRAY_SIZE)) {
+    if (cmp(key, array_[slot].first) == 0) {
+      result->push_back(array_[slot].second);
+      found = true;
+    }
+  }
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BLOCK_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+  slot_offset_t free_slot = BLOCK_ARRAY_SIZE;
+  for (slot_offset_t slot = 0; slot < BLOCK_ARRAY_SIZE; slot++) {
+    if (IsReadable(slot)) {
+      if (cmp(key, array_[slot].first) == 0 && value == array_[slot].second) {
+        return false;
+      }
+    } else if (free_slot == BLOCK_ARRAY_SIZE) {
+      free_slot = slot;
+    }
+  }
+  return free_slot != BLOCK_ARRAY_SIZE && Insert(free_slot, key, value);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BLOCK_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+  for (slot_offset_t slot = NextReadable(0, BLOCK_ARRAY_SIZE); slot < BLOCK_ARRAY_SIZE;
+       slot = NextReadable(slot + 1, BLOCK_ARRAY_SIZE)) {
+    if (cmp(key, array_[slot].first) == 0 && value == array_[slot].second) {
+      Remove(slot);
+      return true;
+    }
+  }
   return false;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BLOCK_TYPE::NumReadable() -> uint32_t {
+  uint32_t num = 0;
+  for (const auto &byte : readable_) {
+    num += __builtin_popcount(static_cast<unsigned char>(byte.load()));
+  }
+  return num;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BLOCK_TYPE::IsFull() -> bool {
+  return NumReadable() == BLOCK_ARRAY_SIZE;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BLOCK_TYPE::IsEmpty() -> bool {
+  return NumReadable() == 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::PrintBucket() {
+  uint32_t occupied = 0;
+  for (const auto &byte : occupied_) {
+    occupied += __builtin_popcount(static_cast<unsigned char>(byte.load()));
+  }
+  uint32_t taken = NumReadable();
+  LOG_INFO("Block Capacity: %lu, Occupied: %u, Taken: %u, Tombstones: %u", BLOCK_ARRAY_SIZE, occupied, taken,
+           occupied - taken);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::Init() {
+  for (auto &byte : occupied_) {
+    byte = 0;
+  }
+  for (auto &byte : readable_) {
+    byte = 0;
+  }
+}
+
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
 template class HashTableBlockPage<int, int, IntComparator>;
 template class HashTableBlockPage<GenericKey<4>, RID, GenericComparator<4>>;
@@ -69,16 +69,17 @@ void TablePage::UpdateTupleMeta(const TupleMeta &meta, const RID &rid) {
 }
 
 auto TablePage::GetTuple(const RID &rid) const -> std::pair<TupleMeta, Tuple> {
+  auto [meta, view] = GetTupleView(rid);
+  return std::make_pair(meta, view.ToTuple());
+}
+
+auto TablePage::GetTupleView(const RID &rid) const -> std::pair<TupleMeta, TupleView> {
   auto tuple_id = rid.GetSlotNum();
   if (tuple_id >= num_tuples_) {
     throw bustub::Exception("Tuple ID out of range");
   }
   auto &[offset, size, meta] = tuple_info_[tuple_id];
-  Tuple tuple;
-  tuple.data_.resize(size);
-  memmove(tuple.data_.data(), page_start_ + offset, size);
-  tuple.rid_ = rid;
-  return std::make_pair(meta, std::move(tuple));
+  return std::make_pair(meta, TupleView(rid, page_start_ + offset, size));
 }
 
 auto TablePage::GetTupleMeta(const RID &rid) const -> TupleMeta {
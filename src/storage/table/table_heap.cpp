@@ -26,7 +26,10 @@
 
 namespace bustub {
 
-    TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
+    TableHeap::TableHeap(BufferPoolManager *bpm, const Schema *schema) : bpm_(bpm) {
+        if (schema != nullptr) {
+            zone_map_layout_.emplace(*schema);
+        }
         // Initialize the first table page.
         auto guard = bpm->NewPageGuarded(&first_page_id_);
         last_page_id_ = first_page_id_;
@@ -71,6 +74,8 @@ namespace bustub {
 
         auto page = page_guard.AsMut<TablePage>();
         auto slot_id = *page->InsertTuple(meta, tuple);
+        // widen the zone map while the page is still latched, so a scan never sees the tuple without it
+        UpdateZoneMap(RID{last_page_id, slot_id}, tuple);
 
         // only allow one insertion at a time, otherwise it will deadlock.
         guard.unlock();
@@ -122,6 +127,25 @@ namespace bustub {
         auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
         auto page = page_guard.AsMut<TablePage>();
         page->UpdateTupleInPlaceUnsafe(meta, tuple, rid);
+        UpdateZoneMap(rid, tuple);
+    }
+
+    void TableHeap::UpdateZoneMap(RID rid, const Tuple &tuple) {
+        if (!zone_map_layout_.has_value()) {
+            return;
+        }
+        std::scoped_lock<std::mutex> guard(zone_latch_);
+        auto it = zone_maps_.try_emplace(rid.GetPageId(), *zone_map_layout_).first;
+        it->second.Add(*zone_map_layout_, TupleView(tuple));
+    }
+
+    auto TableHeap::PageMayMatch(page_id_t page_id, const ZoneMapFilter &filter) -> bool {
+        if (!zone_map_layout_.has_value()) {
+            return true;
+        }
+        std::scoped_lock<std::mutex> guard(zone_latch_);
+        auto it = zone_maps_.find(page_id);
+        return it == zone_maps_.end() || filter(it->second);
     }
 
 }  // namespace bustub
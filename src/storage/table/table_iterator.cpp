@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 #include <optional>
 
@@ -71,4 +72,27 @@ namespace bustub {
         return *this;
     }
 
+    void TableIterator::ScanPage(const std::function<void(const TupleMeta &, const TupleView &)> &visit,
+                                 const ZoneMapFilter *zone_filter) {
+        auto page_guard = table_heap_->bpm_->FetchPageRead(rid_.GetPageId());
+        auto page = page_guard.As<TablePage>();
+        auto page_id = rid_.GetPageId();
+        bool is_stop_page = stop_at_rid_.GetPageId() == page_id;
+        uint32_t end = page->GetNumTuples();
+        if (is_stop_page) {
+            end = std::min(end, stop_at_rid_.GetSlotNum());
+        }
+        // inserts widen the zone map under the page write latch, so it covers every tuple visible here
+        if (zone_filter != nullptr && *zone_filter && !table_heap_->PageMayMatch(page_id, *zone_filter)) {
+            end = 0;
+        }
+
+        for (uint32_t slot_num = rid_.GetSlotNum(); slot_num < end; slot_num++) {
+            auto [meta, view] = page->GetTupleView(RID{page_id, slot_num});
+            visit(meta, view);
+        }
+
+        rid_ = is_stop_page ? RID{INVALID_PAGE_ID, 0} : RID{page->GetNextPageId(), 0};
+    }
+
 }  // namespace bustub
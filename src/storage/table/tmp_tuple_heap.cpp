@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_heap.cpp
+//
+// Identification: src/storage/table/tmp_tuple_heap.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_heap.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "fmt/format.h"
+#include "storage/page/tmp_tuple_page.h"
+
+namespace bustub {
+
+TmpTupleHeap::~TmpTupleHeap() {
+  for (auto page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+}
+
+void TmpTupleHeap::Append(const Tuple &tuple) {
+  if (!TmpTuplePage::Fits(tuple.GetLength())) {
+    throw ExecutionException(fmt::format("tuple of {} bytes is too large to spill", tuple.GetLength()));
+  }
+  if (!TmpTuplePage::Fits(buffer_bytes_ + tuple.GetLength())) {
+    Flush();
+  }
+  // every tuple takes its size prefix as well
+  buffer_bytes_ += tuple.GetLength() + sizeof(uint32_t);
+  buffer_.push_back(tuple);
+  num_tuples_++;
+}
+
+void TmpTupleHeap::Flush() {
+  if (buffer_.empty()) {
+    return;
+  }
+  page_id_t page_id;
+  auto *page = reinterpret_cast<TmpTuplePage *>(bpm_->NewPage(&page_id));
+  if (page == nullptr) {
+    throw ExecutionException("no free frame in the buffer pool to spill to");
+  }
+  page->Init(page_id, BUSTUB_PAGE_SIZE);
+  TmpTuple out(INVALID_PAGE_ID, 0);
+  for (const auto &tuple : buffer_) {
+    bool inserted = page->Insert(tuple, &out);
+    BUSTUB_ENSURE(inserted, "write buffer larger than a page");
+  }
+  bpm_->UnpinPage(page_id, true);
+  page_ids_.push_back(page_id);
+  buffer_.clear();
+  buffer_bytes_ = 0;
+}
+
+auto TmpTupleHeap::NumPages() -> size_t {
+  Flush();
+  return page_ids_.size();
+}
+
+void TmpTupleHeap::ReadPage(size_t page_idx, std::vector<Tuple> *tuples) {
+  Flush();
+  auto page_id = page_ids_[page_idx];
+  auto *page = reinterpret_cast<TmpTuplePage *>(bpm_->FetchPage(page_id));
+  if (page == nullptr) {
+    throw ExecutionException("no free frame in the buffer pool to read spilled tuples");
+  }
+  // tuples grow from the end of the page towards its header, so the newest one comes first
+  size_t begin = tuples->size();
+  for (uint32_t offset = page->GetFreeSpacePointer(); offset < BUSTUB_PAGE_SIZE;) {
+    Tuple tuple;
+    page->Get(offset, &tuple);
+    offset += sizeof(uint32_t) + tuple.GetLength();
+    tuples->push_back(std::move(tuple));
+  }
+  bpm_->UnpinPage(page_id, false);
+  std::reverse(tuples->begin() + begin, tuples->end());
+}
+
+}  // namespace bustub
@@ -14,12 +14,32 @@
 #include <cstdlib>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+namespace {
+
+// Get the starting address of a column within serialized tuple data
+auto ColumnDataPtr(const char *data, const Schema *schema, const uint32_t column_idx) -> const char * {
+  assert(schema);
+  const auto &col = schema->GetColumn(column_idx);
+  bool is_inlined = col.IsInlined();
+  // For inline type, data is stored where it is.
+  if (is_inlined) {
+    return (data + col.GetOffset());
+  }
+  // We read the relative offset from the tuple data.
+  int32_t offset = *reinterpret_cast<const int32_t *>(data + col.GetOffset());
+  // And return the beginning address of the real data for the VARCHAR type.
+  return (data + offset);
+}
+
+}  // namespace
+
 // TODO(Amadou): It does not look like nulls are supported. Add a null bitmap?
 Tuple::Tuple(std::vector<Value> values, const Schema *schema) {
   assert(values.size() == schema->GetColumnCount());
@@ -79,17 +99,7 @@ auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const s
 }
 
 auto Tuple::GetDataPtr(const Schema *schema, const uint32_t column_idx) const -> const char * {
-  assert(schema);
-  const auto &col = schema->GetColumn(column_idx);
-  bool is_inlined = col.IsInlined();
-  // For inline type, data is stored where it is.
-  if (is_inlined) {
-    return (data_.data() + col.GetOffset());
-  }
-  // We read the relative offset from the tuple data.
-  int32_t offset = *reinterpret_cast<const int32_t *>(data_.data() + col.GetOffset());
-  // And return the beginning address of the real data for the VARCHAR type.
-  return (data_.data() + offset);
+  return ColumnDataPtr(data_.data(), schema, column_idx);
 }
 
 auto Tuple::ToString(const Schema *schema) const -> std::string {
@@ -129,4 +139,30 @@ void Tuple::DeserializeFrom(const char *storage) {
   memcpy(this->data_.data(), storage + sizeof(int32_t), size);
 }
 
+auto TupleView::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
+  assert(schema);
+  const TypeId column_type = schema->GetColumn(column_idx).GetType();
+  return Value::DeserializeFrom(ColumnDataPtr(data_, schema, column_idx), column_type);
+}
+
+auto TupleView::Project(const Schema &schema, const Schema &out_schema, const std::vector<uint32_t> &attrs) const
+    -> Tuple {
+  std::vector<Value> values;
+  values.reserve(attrs.size());
+  for (auto idx : attrs) {
+    values.emplace_back(GetValue(&schema, idx));
+  }
+  Tuple tuple(std::move(values), &out_schema);
+  tuple.rid_ = rid_;
+  return tuple;
+}
+
+auto TupleView::AsTuple(Tuple *scratch) const -> const Tuple * {
+  if (tuple_ != nullptr) {
+    return tuple_;
+  }
+  *scratch = ToTuple();
+  return scratch;
+}
+
 }  // namespace bustub
@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map.cpp
+//
+// Identification: src/storage/table/zone_map.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/zone_map.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+#include "common/macros.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+namespace {
+
+template <typename T>
+auto ReadColumn(const TupleView &tuple, uint32_t offset) -> T {
+  T val;
+  memcpy(&val, tuple.GetData() + offset, sizeof(T));
+  return val;
+}
+
+/** @return the value of an integer column widened to int64, or nullopt for NULL */
+auto ReadInteger(const TupleView &tuple, TypeId type, uint32_t offset) -> std::optional<int64_t> {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT: {
+      auto val = ReadColumn<int8_t>(tuple, offset);
+      return val == BUSTUB_INT8_NULL ? std::nullopt : std::optional<int64_t>(val);
+    }
+    case TypeId::SMALLINT: {
+      auto val = ReadColumn<int16_t>(tuple, offset);
+      return val == BUSTUB_INT16_NULL ? std::nullopt : std::optional<int64_t>(val);
+    }
+    case TypeId::INTEGER: {
+      auto val = ReadColumn<int32_t>(tuple, offset);
+      return val == BUSTUB_INT32_NULL ? std::nullopt : std::optional<int64_t>(val);
+    }
+    case TypeId::BIGINT: {
+      auto val = ReadColumn<int64_t>(tuple, offset);
+      return val == BUSTUB_INT64_NULL ? std::nullopt : std::optional<int64_t>(val);
+    }
+    default:
+      UNREACHABLE("not an integer column");
+  }
+}
+
+auto IntegerOf(const Value &constant) -> int64_t {
+  switch (constant.GetTypeId()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return constant.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return constant.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return constant.GetAs<int32_t>();
+    case TypeId::BIGINT:
+      return constant.GetAs<int64_t>();
+    default:
+      UNREACHABLE("not an integer constant");
+  }
+}
+
+}  // namespace
+
+ZoneMap::Layout::Layout(const Schema &schema) {
+  for (const auto &col : schema.GetColumns()) {
+    switch (col.GetType()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT:
+      case TypeId::DECIMAL:
+        types_.push_back(col.GetType());
+        break;
+      default:
+        types_.push_back(TypeId::INVALID);
+    }
+    offsets_.push_back(col.GetOffset());
+  }
+}
+
+void ZoneMap::Add(const Layout &layout, const TupleView &tuple) {
+  for (uint32_t i = 0; i < ranges_.size(); i++) {
+    auto &range = ranges_[i];
+    auto type = layout.types_[i];
+    if (type == TypeId::INVALID) {
+      continue;
+    }
+    if (type == TypeId::DECIMAL) {
+      auto val = ReadColumn<double>(tuple, layout.offsets_[i]);
+      if (val == BUSTUB_DECIMAL_NULL) {
+        continue;
+      }
+      range.min_dec_ = range.has_values_ ? std::min(range.min_dec_, val) : val;
+      range.max_dec_ = range.has_values_ ? std::max(range.max_dec_, val) : val;
+    } else {
+      auto val = ReadInteger(tuple, type, layout.offsets_[i]);
+      if (!val.has_value()) {
+        continue;
+      }
+      range.min_int_ = range.has_values_ ? std::min(range.min_int_, *val) : *val;
+      range.max_int_ = range.has_values_ ? std::max(range.max_int_, *val) : *val;
+    }
+    range.has_values_ = true;
+  }
+}
+
+auto ZoneMap::MayBeLess(uint32_t col_idx, const Value &constant, bool or_equal) const -> bool {
+  const auto &range = ranges_[col_idx];
+  if (!range.has_values_) {
+    return false;
+  }
+  if (constant.GetTypeId() == TypeId::DECIMAL) {
+    auto val = constant.GetAs<double>();
+    return or_equal ? range.min_dec_ <= val : range.min_dec_ < val;
+  }
+  auto val = IntegerOf(constant);
+  return or_equal ? range.min_int_ <= val : range.min_int_ < val;
+}
+
+auto ZoneMap::MayBeGreater(uint32_t col_idx, const Value &constant, bool or_equal) const -> bool {
+  const auto &range = ranges_[col_idx];
+  if (!range.has_values_) {
+    return false;
+  }
+  if (constant.GetTypeId() == TypeId::DECIMAL) {
+    auto val = constant.GetAs<double>();
+    return or_equal ? range.max_dec_ >= val : range.max_dec_ > val;
+  }
+  auto val = IntegerOf(constant);
+  return or_equal ? range.max_int_ >= val : range.max_int_ > val;
+}
+
+auto ZoneMap::MayBeEqual(uint32_t col_idx, const Value &constant) const -> bool {
+  return MayBeLess(col_idx, constant, true) && MayBeGreater(col_idx, constant, true);
+}
+
+auto ZoneMap::MayDiffer(uint32_t col_idx, const Value &constant) const -> bool {
+  return MayBeLess(col_idx, constant, false) || MayBeGreater(col_idx, constant, false);
+}
+
+}  // namespace bustub
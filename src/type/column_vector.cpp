@@ -0,0 +1,209 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_vector.cpp
+//
+// Identification: src/type/column_vector.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/column_vector.h"
+
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "type/limits.h"
+#include "type/type.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return whether `storage` holds the null sentinel of the fixed-width `type` */
+auto IsNullSentinel(TypeId type, const uint8_t *storage) -> bool {
+  switch (type) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return *reinterpret_cast<const int8_t *>(storage) == BUSTUB_INT8_NULL;
+    case TypeId::SMALLINT:
+      return *reinterpret_cast<const int16_t *>(storage) == BUSTUB_INT16_NULL;
+    case TypeId::INTEGER:
+      return *reinterpret_cast<const int32_t *>(storage) == BUSTUB_INT32_NULL;
+    case TypeId::BIGINT:
+      return *reinterpret_cast<const int64_t *>(storage) == BUSTUB_INT64_NULL;
+    case TypeId::DECIMAL:
+      return *reinterpret_cast<const double *>(storage) == BUSTUB_DECIMAL_NULL;
+    case TypeId::TIMESTAMP:
+      return *reinterpret_cast<const uint64_t *>(storage) == BUSTUB_TIMESTAMP_NULL;
+    default:
+      throw Exception(ExceptionType::UNKNOWN_TYPE, "Unsupported column vector type.");
+  }
+}
+
+}  // namespace
+
+void ColumnVector::Reset(TypeId type, size_t size) {
+  type_ = type;
+  size_ = size;
+  has_nulls_ = false;
+  nulls_.clear();
+  if (type == TypeId::VARCHAR) {
+    width_ = 0;
+    data_.clear();
+    chars_.clear();
+    // rows that are never filled in read as empty ranges
+    offsets_.assign(size + 1, 0);
+    return;
+  }
+  width_ = Type::GetTypeSize(type);
+  data_.resize(size * width_);
+}
+
+void ColumnVector::InitNulls() {
+  has_nulls_ = true;
+  nulls_.assign(size_, 0);
+}
+
+void ColumnVector::SetNull(size_t i) {
+  if (!has_nulls_) {
+    InitNulls();
+  }
+  nulls_[i] = 1;
+}
+
+void ColumnVector::MergeNulls(const ColumnVector &lhs, const ColumnVector &rhs) {
+  if (!lhs.HasNulls() && !rhs.HasNulls()) {
+    return;
+  }
+  InitNulls();
+  for (size_t i = 0; i < size_; i++) {
+    nulls_[i] = static_cast<uint8_t>(lhs.IsNull(i) || rhs.IsNull(i));
+  }
+}
+
+void ColumnVector::LoadColumn(const std::vector<Tuple> &tuples, const Schema &schema, uint32_t col_idx) {
+  const Column &col = schema.GetColumn(col_idx);
+  const uint32_t offset = col.GetOffset();
+  Reset(col.GetType(), 0);
+  size_ = tuples.size();
+  if (type_ == TypeId::VARCHAR) {
+    offsets_.clear();
+    offsets_.reserve(size_ + 1);
+    offsets_.push_back(0);
+    for (size_t i = 0; i < size_; i++) {
+      const char *data = tuples[i].GetData();
+      // the inlined slot of a VARCHAR column holds the offset of its length-prefixed bytes
+      int32_t var_offset = *reinterpret_cast<const int32_t *>(data + offset);
+      uint32_t len = *reinterpret_cast<const uint32_t *>(data + var_offset);
+      if (len == BUSTUB_VALUE_NULL) {
+        SetNull(i);
+      } else {
+        chars_.insert(chars_.end(), data + var_offset + sizeof(uint32_t), data + var_offset + sizeof(uint32_t) + len);
+      }
+      offsets_.push_back(static_cast<uint32_t>(chars_.size()));
+    }
+    return;
+  }
+  data_.resize(size_ * width_);
+  uint8_t *dst = data_.data();
+  for (size_t i = 0; i < size_; i++, dst += width_) {
+    memcpy(dst, tuples[i].GetData() + offset, width_);
+  }
+  // a second pass over the now contiguous column is cheaper than branching inside the copy loop
+  dst = data_.data();
+  for (size_t i = 0; i < size_; i++, dst += width_) {
+    if (IsNullSentinel(type_, dst)) {
+      SetNull(i);
+    }
+  }
+}
+
+void ColumnVector::Broadcast(const Value &value, size_t size) {
+  if (value.GetTypeId() == TypeId::VARCHAR || size == 0) {
+    Reset(value.GetTypeId(), 0);
+    for (size_t i = 0; i < size; i++) {
+      Append(value);
+    }
+    return;
+  }
+  Reset(value.GetTypeId(), size);
+  Type::GetInstance(type_)->SerializeTo(value, reinterpret_cast<char *>(data_.data()));
+  for (size_t i = 1; i < size; i++) {
+    memcpy(data_.data() + i * width_, data_.data(), width_);
+  }
+  if (value.IsNull()) {
+    InitNulls();
+    nulls_.assign(size, 1);
+  }
+}
+
+void ColumnVector::Append(const Value &value) {
+  BUSTUB_ASSERT(value.GetTypeId() == type_, "Appending a value of a different type.");
+  if (type_ == TypeId::VARCHAR) {
+    if (value.IsNull()) {
+      offsets_.push_back(offsets_.back());
+      size_++;
+      if (has_nulls_) {
+        nulls_.push_back(0);
+      }
+      SetNull(size_ - 1);
+      return;
+    }
+    chars_.insert(chars_.end(), value.GetData(), value.GetData() + value.GetLength());
+    offsets_.push_back(static_cast<uint32_t>(chars_.size()));
+    size_++;
+    if (has_nulls_) {
+      nulls_.push_back(0);
+    }
+    return;
+  }
+  data_.resize((size_ + 1) * width_);
+  // every fixed-width type serializes to its native representation, null sentinel included
+  Type::GetInstance(type_)->SerializeTo(value, reinterpret_cast<char *>(data_.data() + size_ * width_));
+  size_++;
+  if (has_nulls_) {
+    nulls_.push_back(0);
+  }
+  if (value.IsNull()) {
+    SetNull(size_ - 1);
+  }
+}
+
+auto ColumnVector::GetString(size_t i) const -> std::string_view {
+  size_t len = offsets_[i + 1] - offsets_[i];
+  return {chars_.data() + offsets_[i], len == 0 ? 0 : len - 1};
+}
+
+auto ColumnVector::GetValue(size_t i) const -> Value {
+  if (type_ == TypeId::VARCHAR) {
+    if (IsNull(i)) {
+      return {TypeId::VARCHAR, nullptr, BUSTUB_VALUE_NULL, false};
+    }
+    return {TypeId::VARCHAR, chars_.data() + offsets_[i], offsets_[i + 1] - offsets_[i], true};
+  }
+  if (IsNull(i)) {
+    // kernels leave arbitrary values behind null rows, so rebuild the sentinel
+    switch (type_) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return {type_, BUSTUB_INT8_NULL};
+      case TypeId::SMALLINT:
+        return {type_, BUSTUB_INT16_NULL};
+      case TypeId::INTEGER:
+        return {type_, BUSTUB_INT32_NULL};
+      case TypeId::BIGINT:
+        return {type_, BUSTUB_INT64_NULL};
+      case TypeId::DECIMAL:
+        return {type_, BUSTUB_DECIMAL_NULL};
+      default:
+        return {type_, BUSTUB_TIMESTAMP_NULL};
+    }
+  }
+  return Type::GetInstance(type_)->DeserializeFrom(reinterpret_cast<const char *>(data_.data() + i * width_));
+}
+
+}  // namespace bustub
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_stats_test.cpp
+//
+// Identification: test/catalog/table_stats_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/table_stats.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TableStatsTest, HyperLogLogTest) {
+  HyperLogLog small;
+  for (int round = 0; round < 3; round++) {
+    for (uint64_t i = 0; i < 100; i++) {
+      small.Add(HashUtil::MixHash(i));
+    }
+  }
+  // few values are counted almost exactly, duplicates are not counted
+  ASSERT_NEAR(100, small.Estimate(), 2);
+
+  HyperLogLog large;
+  for (uint64_t i = 0; i < 200000; i++) {
+    large.Add(HashUtil::MixHash(i));
+  }
+  ASSERT_NEAR(200000, large.Estimate(), 200000 * 0.05);
+}
+
+// NOLINTNEXTLINE
+TEST(TableStatsTest, CollectTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(1024, disk_manager.get());
+  Schema schema({Column("id", TypeId::INTEGER), Column("skewed", TypeId::BIGINT), Column("name", TypeId::VARCHAR, 16)});
+  TableHeap table(bpm.get(), &schema);
+
+  // id is unique, skewed is 0 for 90% of the rows and NULL for 5%, name has 10 values
+  const int num_rows = 4000;
+  for (int i = 0; i < num_rows; i++) {
+    auto skewed = i % 20 == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                              : ValueFactory::GetBigIntValue(i % 10 == 5 ? i : 0);
+    Tuple tuple({ValueFactory::GetIntegerValue(i), skewed, ValueFactory::GetVarcharValue("n" + std::to_string(i % 10))},
+                &schema);
+    auto rid = table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple);
+    ASSERT_TRUE(rid.has_value());
+    // deleted rows are left out
+    if (i == num_rows - 1) {
+      table.UpdateTupleMeta(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, true}, *rid);
+    }
+  }
+
+  auto stats = TableStats::Collect(&table, schema);
+  ASSERT_EQ(num_rows - 1, stats.row_count_);
+  ASSERT_EQ(3, stats.columns_.size());
+
+  const auto &id = stats.columns_[0];
+  ASSERT_NEAR(num_rows, id.ndv_, num_rows * 0.03);
+  ASSERT_EQ(0, id.null_fraction_);
+  ASSERT_EQ(0, id.bounds_.front());
+  ASSERT_EQ(num_rows - 2, id.bounds_.back());
+  ASSERT_NEAR(1.0 / num_rows, id.EqualSelectivity(ValueFactory::GetIntegerValue(42)), 0.0001);
+  ASSERT_EQ(0, id.EqualSelectivity(ValueFactory::GetIntegerValue(-1)));
+  ASSERT_NEAR(0.25, id.LessSelectivity(ValueFactory::GetIntegerValue(num_rows / 4), false), 0.03);
+  ASSERT_NEAR(0.75, id.GreaterSelectivity(ValueFactory::GetBigIntValue(num_rows / 4), true), 0.03);
+  ASSERT_EQ(1, id.LessSelectivity(ValueFactory::GetIntegerValue(num_rows), true));
+  ASSERT_EQ(0, id.GreaterSelectivity(ValueFactory::GetIntegerValue(num_rows), false));
+
+  const auto &skewed = stats.columns_[1];
+  ASSERT_NEAR(0.05, skewed.null_fraction_, 0.001);
+  ASSERT_NEAR(num_rows / 10 + 1, skewed.ndv_, 10);
+  // the histogram sees that most rows are 0 and few are above it
+  ASSERT_GT(skewed.EqualSelectivity(ValueFactory::GetBigIntValue(0)), 0.75);
+  ASSERT_LT(skewed.EqualSelectivity(ValueFactory::GetBigIntValue(5)), 0.01);
+  ASSERT_LT(skewed.GreaterSelectivity(ValueFactory::GetBigIntValue(0), false), 0.2);
+
+  const auto &name = stats.columns_[2];
+  ASSERT_NEAR(10, name.ndv_, 0.5);
+  ASSERT_TRUE(name.bounds_.empty());
+  ASSERT_NEAR(0.1, name.EqualSelectivity(ValueFactory::GetVarcharValue("n3")), 0.01);
+
+  // an empty table
+  TableHeap empty(bpm.get(), &schema);
+  auto empty_stats = TableStats::Collect(&empty, schema);
+  ASSERT_EQ(0, empty_stats.row_count_);
+  ASSERT_EQ(0, empty_stats.columns_[0].ndv_);
+  ASSERT_EQ(0, empty_stats.columns_[0].EqualSelectivity(ValueFactory::GetIntegerValue(0)));
+}
+
+}  // namespace bustub
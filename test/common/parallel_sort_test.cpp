@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_sort_test.cpp
+//
+// Identification: test/common/parallel_sort_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/util/parallel_sort.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelSortTest, StableSortTest) {
+  std::mt19937 gen(15445);
+  auto less = [](const std::pair<int, int> &a, const std::pair<int, int> &b) { return a.first < b.first; };
+  for (size_t size : {0, 1, 100, 10000, 100003}) {
+    // few distinct keys, so that stability matters; the second member records the input position
+    std::uniform_int_distribution<int> key(0, 50);
+    std::vector<std::pair<int, int>> input;
+    for (size_t i = 0; i < size; i++) {
+      input.emplace_back(key(gen), static_cast<int>(i));
+    }
+    auto expected = input;
+    std::stable_sort(expected.begin(), expected.end(), less);
+    for (size_t threads : {1, 2, 3, 4, 7}) {
+      auto items = input;
+      ParallelSort::Sort(&items, less, threads);
+      ASSERT_EQ(expected, items) << "size=" << size << " threads=" << threads;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelSortTest, StringSortTest) {
+  // non-trivial items are moved between the runs and the merge buffer
+  std::mt19937 gen(445);
+  std::vector<std::string> items;
+  for (int i = 0; i < 50000; i++) {
+    items.push_back(std::to_string(gen()));
+  }
+  auto expected = items;
+  std::sort(expected.begin(), expected.end());
+  ParallelSort::Sort(&items, std::less<>(), 4);
+  EXPECT_EQ(expected, items);
+}
+
+}  // namespace bustub
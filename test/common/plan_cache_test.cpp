@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// plan_cache_test.cpp
+//
+// Identification: test/common/plan_cache_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+
+#include "common/plan_cache.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+auto MakeEntry(uint64_t catalog_version) -> std::shared_ptr<const PlanCache::Entry> {
+  return std::make_shared<const PlanCache::Entry>(PlanCache::Entry{nullptr, nullptr, false, catalog_version});
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(PlanCacheTest, NormalizeSqlTest) {
+  ASSERT_EQ("select * from t where a = 1", PlanCache::NormalizeSql("  SELECT  *\n\tFROM T WHERE a = 1 ;; "));
+  ASSERT_EQ("select 1 + 2", PlanCache::NormalizeSql("select 1 -- One\n + 2 /* Two */;"));
+  // quoted text keeps its case and spaces
+  ASSERT_EQ("select 'A  b', 'It''s  X' from t", PlanCache::NormalizeSql("SELECT 'A  b', 'It''s  X' FROM t"));
+  ASSERT_EQ("select \"Col  1\" from t", PlanCache::NormalizeSql("SELECT \"Col  1\" FROM T"));
+  ASSERT_EQ("select e'a\\'  B'", PlanCache::NormalizeSql("SELECT E'a\\'  B'"));
+  ASSERT_EQ("select $$A  -- b$$, $tag$C$$ d$tag$ where a = $1",
+            PlanCache::NormalizeSql("SELECT $$A  -- b$$, $tag$C$$ d$tag$ WHERE A = $1"));
+  ASSERT_NE(PlanCache::NormalizeSql("select 'a'"), PlanCache::NormalizeSql("select 'A'"));
+  ASSERT_NE(PlanCache::NormalizeSql("select ';'"), PlanCache::NormalizeSql("select ''"));
+}
+
+// NOLINTNEXTLINE
+TEST(PlanCacheTest, EvictionTest) {
+  PlanCache cache(2);
+  cache.Put("a", MakeEntry(0));
+  cache.Put("b", MakeEntry(0));
+  ASSERT_NE(nullptr, cache.Get("a", 0));
+  // "b" is the least recently used one now
+  cache.Put("c", MakeEntry(0));
+  ASSERT_EQ(2U, cache.Size());
+  ASSERT_EQ(nullptr, cache.Get("b", 0));
+  ASSERT_NE(nullptr, cache.Get("a", 0));
+  ASSERT_NE(nullptr, cache.Get("c", 0));
+
+  // putting a key again replaces its plan
+  auto entry = MakeEntry(0);
+  cache.Put("a", entry);
+  ASSERT_EQ(2U, cache.Size());
+  ASSERT_EQ(entry, cache.Get("a", 0));
+
+  cache.Clear();
+  ASSERT_EQ(0U, cache.Size());
+  ASSERT_EQ(nullptr, cache.Get("a", 0));
+}
+
+// NOLINTNEXTLINE
+TEST(PlanCacheTest, CatalogVersionTest) {
+  PlanCache cache(4);
+  cache.Put("a", MakeEntry(1));
+  ASSERT_NE(nullptr, cache.Get("a", 1));
+  // the catalog changed since the plan was made, it is dropped
+  ASSERT_EQ(nullptr, cache.Get("a", 2));
+  ASSERT_EQ(0U, cache.Size());
+  ASSERT_EQ(nullptr, cache.Get("a", 1));
+}
+
+}  // namespace bustub
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// task_scheduler_test.cpp
+//
+// Identification: test/common/task_scheduler_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <stdexcept>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/task_scheduler.h"
+#include "common/util/parallel_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TaskSchedulerTest, SubmitTest) {
+  std::atomic<int> sum{0};
+  {
+    TaskScheduler scheduler(3);
+    ASSERT_EQ(3, scheduler.NumWorkers());
+    for (int i = 1; i <= 1000; i++) {
+      scheduler.Submit([&sum, i] { sum += i; });
+    }
+    // the destructor runs the queued tasks first
+  }
+  ASSERT_EQ(500500, sum);
+}
+
+// NOLINTNEXTLINE
+TEST(TaskSchedulerTest, NestedParallelForTest) {
+  TaskScheduler scheduler(2);
+  TaskScheduler::Scope scope(&scheduler);
+  ASSERT_EQ(&scheduler, TaskScheduler::Current());
+
+  // more nested loops than workers: the waiting callers run the queued tasks themselves
+  std::vector<std::atomic<int>> counts(64);
+  ParallelUtil::ParallelFor(8, 8, [&](size_t outer) {
+    ASSERT_NE(nullptr, TaskScheduler::Current());
+    ParallelUtil::ParallelFor(4, 8, [&](size_t inner) { counts[outer * 8 + inner]++; });
+  });
+  for (const auto &count : counts) {
+    ASSERT_EQ(1, count);
+  }
+
+  // exceptions still reach the caller
+  ASSERT_THROW(ParallelUtil::ParallelFor(4, 100,
+                                         [](size_t i) {
+                                           if (i == 42) {
+                                             throw std::runtime_error("task failed");
+                                           }
+                                         }),
+               std::runtime_error);
+}
+
+// NOLINTNEXTLINE
+TEST(TaskSchedulerTest, BlockingRegionTest) {
+  TaskScheduler scheduler(1);
+  ASSERT_EQ(1, scheduler.NumThreads());
+
+  // the only worker blocks until the second task ran, which needs a spare thread
+  std::atomic<bool> started{false};
+  std::atomic<bool> released{false};
+  std::atomic<bool> done{false};
+  scheduler.Submit([&] {
+    TaskScheduler::BlockingRegion blocking;
+    started = true;
+    while (!released) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    done = true;
+  });
+  while (!started) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  scheduler.Submit([&] { released = true; });
+  while (!done) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(2, scheduler.NumThreads());
+
+  // outside of a worker a blocking region does nothing
+  { TaskScheduler::BlockingRegion blocking; }
+  ASSERT_EQ(2, scheduler.NumThreads());
+}
+
+}  // namespace bustub
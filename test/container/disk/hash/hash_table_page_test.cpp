@@ -17,13 +17,16 @@
 #include "common/logger.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/page/extendible_htable_header_page.h"
+#include "storage/page/hash_table_block_page.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_header_page.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
+TEST(HashTablePageTest, DirectoryPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -56,7 +59,116 @@ TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
+TEST(HashTablePageTest, HeaderPageSampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  page_id_t header_page_id = INVALID_PAGE_ID;
+  auto header_page = reinterpret_cast<ExtendibleHTableHeaderPage *>(bpm->NewPage(&header_page_id)->GetData());
+  header_page->Init(2);
+  EXPECT_EQ(4, header_page->MaxSize());
+
+  // directories are picked by the most significant bits of the hash
+  EXPECT_EQ(0, header_page->HashToDirectoryIndex(0x00000001));
+  EXPECT_EQ(1, header_page->HashToDirectoryIndex(0x40000000));
+  EXPECT_EQ(2, header_page->HashToDirectoryIndex(0x80000000));
+  EXPECT_EQ(3, header_page->HashToDirectoryIndex(0xFFFFFFFF));
+
+  for (uint32_t i = 0; i < header_page->MaxSize(); i++) {
+    EXPECT_EQ(INVALID_PAGE_ID, header_page->GetDirectoryPageId(i));
+    header_page->SetDirectoryPageId(i, static_cast<page_id_t>(i + 10));
+  }
+  for (uint32_t i = 0; i < header_page->MaxSize(); i++) {
+    EXPECT_EQ(i + 10, header_page->GetDirectoryPageId(i));
+  }
+
+  header_page->Init(0);
+  EXPECT_EQ(0, header_page->HashToDirectoryIndex(0xFFFFFFFF));
+
+  bpm->UnpinPage(header_page_id, true);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, LinearProbeHeaderPageSampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  page_id_t header_page_id = INVALID_PAGE_ID;
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(bpm->NewPage(&header_page_id)->GetData());
+  header_page->Init(header_page_id, 1000);
+  EXPECT_EQ(header_page_id, header_page->GetPageId());
+  EXPECT_EQ(1000, header_page->GetSize());
+  EXPECT_EQ(0, header_page->NumBlocks());
+
+  for (page_id_t i = 0; i < 10; i++) {
+    header_page->AddBlockPageId(i + 100);
+  }
+  EXPECT_EQ(10, header_page->NumBlocks());
+  for (size_t i = 0; i < 10; i++) {
+    EXPECT_EQ(i + 100, header_page->GetBlockPageId(i));
+  }
+
+  bpm->UnpinPage(header_page_id, true);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BlockPageSampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  page_id_t block_page_id = INVALID_PAGE_ID;
+  auto block_page =
+      reinterpret_cast<HashTableBlockPage<int, int, IntComparator> *>(bpm->NewPage(&block_page_id)->GetData());
+  block_page->Init();
+
+  for (slot_offset_t i = 0; i < 20; i++) {
+    EXPECT_TRUE(block_page->Insert(i, static_cast<int>(i), static_cast<int>(i)));
+  }
+  // a readable slot cannot be claimed twice
+  EXPECT_FALSE(block_page->Insert(3, 3, 3));
+  EXPECT_EQ(20, block_page->NumReadable());
+  EXPECT_EQ(20, block_page->FindUnoccupied(0));
+
+  // removed slots become tombstones: still occupied, no longer readable
+  for (slot_offset_t i = 0; i < 20; i += 2) {
+    block_page->Remove(i);
+  }
+  EXPECT_EQ(10, block_page->NumReadable());
+  EXPECT_TRUE(block_page->IsOccupied(0));
+  EXPECT_FALSE(block_page->IsReadable(0));
+  EXPECT_EQ(20, block_page->FindUnoccupied(0));
+  EXPECT_EQ(1, block_page->NextReadable(0, 20));
+  EXPECT_EQ(9, block_page->NextReadable(9, 20));
+  EXPECT_EQ(15, block_page->NextReadable(14, 15));
+
+  // tombstones can be reused
+  EXPECT_TRUE(block_page->Insert(4, 40, 40));
+  EXPECT_EQ(40, block_page->KeyAt(4));
+  EXPECT_EQ(40, block_page->ValueAt(4));
+
+  std::vector<int> result;
+  EXPECT_TRUE(block_page->GetValue(40, IntComparator(), &result));
+  EXPECT_EQ(std::vector<int>{40}, result);
+  EXPECT_TRUE(block_page->Remove(40, 40, IntComparator()));
+  EXPECT_FALSE(block_page->Remove(40, 40, IntComparator()));
+
+  bpm->UnpinPage(block_page_id, true);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// linear_probe_hash_table_test.cpp
+//
+// Identification: test/container/disk/hash/linear_probe_hash_table_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/logger.h"
+#include "container/disk/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, SampleTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), 1000, HashFunction<int>());
+
+  // insert a few values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << "Failed to insert " << i << std::endl;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // insert one more value for each key, duplicate pairs are rejected
+  for (int i = 0; i < 5; i++) {
+    if (i == 0) {
+      EXPECT_FALSE(ht.Insert(nullptr, i, 2 * i));
+    } else {
+      EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i));
+    }
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i == 0 ? 1 : 2, res.size());
+  }
+
+  // look for a key that does not exist
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+  EXPECT_EQ(0, res.size());
+
+  // remove one value per key; the tombstones must not cut off the other value
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    res.clear();
+    ht.GetValue(nullptr, i, &res);
+    if (i == 0) {
+      EXPECT_EQ(0, res.size());
+    } else {
+      EXPECT_EQ(1, res.size());
+      EXPECT_EQ(2 * i, res[0]);
+    }
+  }
+  EXPECT_FALSE(ht.Remove(nullptr, 0, 0));
+
+  // re-inserting reuses tombstones
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 1; i < 5; i++) {
+    res.clear();
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(2, res.size());
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, ResizeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), 10, HashFunction<int>());
+  size_t initial_size = ht.GetSize();
+
+  const int num_keys = 5000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_GE(ht.GetSize(), num_keys);
+  EXPECT_GT(ht.GetSize(), initial_size);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size()) << "Failed to keep " << i << std::endl;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // churn with a stable cardinality, the table should not keep growing
+  size_t size = ht.GetSize();
+  for (int round = 0; round < 5; round++) {
+    for (int i = 0; i < num_keys; i += 2) {
+      EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    }
+    for (int i = 0; i < num_keys; i += 2) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    }
+  }
+  EXPECT_EQ(size, ht.GetSize());
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << "Failed to keep " << i << std::endl;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, ConcurrentInsertTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(50, disk_manager.get());
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), 100, HashFunction<int>());
+
+  const int num_threads = 4;
+  const int keys_per_thread = 2000;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&ht, tid] {
+      for (int i = tid * keys_per_thread; i < (tid + 1) * keys_per_thread; i++) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        std::vector<int> res;
+        ht.GetValue(nullptr, i, &res);
+        EXPECT_EQ(1, res.size()) << "Failed to insert " << i << std::endl;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << "Failed to keep " << i << std::endl;
+  }
+}
+
+}  // namespace bustub
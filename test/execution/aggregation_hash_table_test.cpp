@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_hash_table_test.cpp
+//
+// Identification: test/execution/aggregation_hash_table_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "execution/aggregation_hash_table.h"
+#include "execution/expressions/column_value_expression.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto Col(uint32_t col_idx, TypeId type) -> AbstractExpressionRef {
+  return std::make_shared<ColumnValueExpression>(0, col_idx, type);
+}
+
+auto MakeRows(const Schema &schema, size_t num_rows, int num_keys, uint32_t seed) -> std::vector<Tuple> {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> key(0, num_keys - 1);
+  std::uniform_int_distribution<int> val(-1000, 1000);
+  std::uniform_int_distribution<int> percent(0, 99);
+  std::vector<Tuple> rows;
+  for (size_t i = 0; i < num_rows; i++) {
+    int k = key(gen);
+    std::vector<Value> values{
+        percent(gen) < 3 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(k),
+        percent(gen) < 3 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                         : ValueFactory::GetVarcharValue("s" + std::to_string(k % 3)),
+        percent(gen) < 10 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(val(gen)),
+        ValueFactory::GetDecimalValue(val(gen) / 4.0),
+    };
+    rows.emplace_back(values, &schema);
+  }
+  return rows;
+}
+
+/** count(*), count(v), sum(v), min(v), max(v), max(d) grouped by (g, s), computed on Values */
+auto ReferenceAggregate(const std::vector<Tuple> &rows, const Schema &schema) -> std::map<std::string, std::string> {
+  std::map<std::string, std::vector<Value>> groups;
+  for (const auto &row : rows) {
+    auto key = row.GetValue(&schema, 0).ToString() + "|" + row.GetValue(&schema, 1).ToString();
+    auto v = row.GetValue(&schema, 2);
+    auto d = row.GetValue(&schema, 3);
+    auto [it, inserted] = groups.try_emplace(key);
+    auto &aggs = it->second;
+    if (inserted) {
+      aggs = {ValueFactory::GetIntegerValue(0), ValueFactory::GetIntegerValue(0), v, v, v, d};
+    } else if (!v.IsNull()) {
+      aggs[2] = aggs[2].IsNull() ? v : aggs[2].Add(v);
+      aggs[3] = aggs[3].IsNull() ? v : aggs[3].Min(v);
+      aggs[4] = aggs[4].IsNull() ? v : aggs[4].Max(v);
+    }
+    aggs[0] = aggs[0].Add(ValueFactory::GetIntegerValue(1));
+    if (!v.IsNull()) {
+      aggs[1] = aggs[1].Add(ValueFactory::GetIntegerValue(1));
+    }
+    if (!inserted) {
+      aggs[5] = aggs[5].Max(d);
+    }
+  }
+  std::map<std::string, std::string> result;
+  for (const auto &[key, aggs] : groups) {
+    std::string row;
+    for (const auto &agg : aggs) {
+      row += agg.ToString() + " ";
+    }
+    result[key] = row;
+  }
+  return result;
+}
+
+/** Aggregates random rows with and without a buffer pool to spill to; @return the partitions spilled */
+auto CheckAggregate(int num_keys, size_t num_rows, size_t memory_limit) -> size_t {
+  Schema schema({Column("g", TypeId::INTEGER), Column("s", TypeId::VARCHAR, 8), Column("v", TypeId::INTEGER),
+                 Column("d", TypeId::DECIMAL)});
+  std::vector<AbstractExpressionRef> group_bys{Col(0, TypeId::INTEGER), Col(1, TypeId::VARCHAR)};
+  auto v = Col(2, TypeId::INTEGER);
+  std::vector<AbstractExpressionRef> aggregates{Col(0, TypeId::INTEGER), v, v, v, v, Col(3, TypeId::DECIMAL)};
+  std::vector<AggregationType> agg_types{AggregationType::CountStarAggregate, AggregationType::CountAggregate,
+                                         AggregationType::SumAggregate,       AggregationType::MinAggregate,
+                                         AggregationType::MaxAggregate,       AggregationType::MaxAggregate};
+  auto output = std::make_shared<Schema>(AggregationPlanNode::InferAggSchema(group_bys, aggregates, agg_types));
+  AggregationPlanNode plan(output, nullptr, group_bys, aggregates, agg_types);
+
+  auto rows = MakeRows(schema, num_rows, num_keys, 15445);
+  auto expected = ReferenceAggregate(rows, schema);
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(32, disk_manager.get());
+  size_t num_spilled = 0;
+  for (size_t threads : {1, 4}) {
+    AggregationHashTable aht(&plan, &schema, threads, bpm.get(), memory_limit);
+    // several chunks, so that the tables carry groups over from one chunk to the next
+    const size_t chunk = num_rows / 3 + 1;
+    for (size_t begin = 0; begin < rows.size(); begin += chunk) {
+      aht.Add(std::vector<Tuple>(rows.begin() + begin, rows.begin() + std::min(rows.size(), begin + chunk)));
+    }
+    aht.Finish();
+
+    std::map<std::string, std::string> result;
+    std::vector<Value> values;
+    while (aht.NextGroup(&values)) {
+      EXPECT_EQ(output->GetColumnCount(), values.size());
+      std::string row;
+      for (size_t a = 2; a < values.size(); a++) {
+        row += values[a].ToString() + " ";
+      }
+      EXPECT_TRUE(result.emplace(values[0].ToString() + "|" + values[1].ToString(), row).second);
+      values.clear();
+    }
+    EXPECT_EQ(expected, result) << "threads=" << threads;
+    num_spilled += aht.NumSpilledPartitions();
+  }
+  return num_spilled;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(AggregationHashTableTest, FewGroupsTest) {
+  // few groups stay in the local tables, even with a tiny memory limit
+  ASSERT_EQ(0, CheckAggregate(10, 50000, 1024));
+}
+
+// NOLINTNEXTLINE
+TEST(AggregationHashTableTest, ManyGroupsTest) {
+  // more groups than a local table holds, so the local tables are flushed into the partitions
+  ASSERT_EQ(0, CheckAggregate(20000, 150000, BUSTUB_EXECUTION_MEMORY_LIMIT));
+}
+
+// NOLINTNEXTLINE
+TEST(AggregationHashTableTest, SpillTest) {
+  // the flushed groups exceed the limit, and the spilled partitions are split further to fit in it
+  ASSERT_GT(CheckAggregate(40000, 150000, 64 << 10), 2 * 32);
+}
+
+}  // namespace bustub
@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression_test.cpp
+//
+// Identification: test/execution/compiled_expression_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/compiled_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto MakeSchema() -> Schema {
+  return Schema({Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT), Column("c", TypeId::DECIMAL),
+                 Column("d", TypeId::BOOLEAN), Column("s", TypeId::VARCHAR, 8), Column("e", TypeId::INTEGER)});
+}
+
+auto MakeTuples(const Schema &schema, uint32_t seed) -> std::vector<Tuple> {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> small(-5, 5);
+  std::uniform_int_distribution<int> percent(0, 99);
+  auto maybe_null = [&](Value val) {
+    return percent(gen) < 15 ? ValueFactory::GetNullValueByType(val.GetTypeId()) : val;
+  };
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 200; i++) {
+    std::vector<Value> values{
+        maybe_null(ValueFactory::GetIntegerValue(small(gen))),
+        maybe_null(ValueFactory::GetBigIntValue(small(gen))),
+        maybe_null(ValueFactory::GetDecimalValue(small(gen) / 2.0)),
+        maybe_null(ValueFactory::GetBooleanValue(small(gen) > 0)),
+        maybe_null(ValueFactory::GetVarcharValue(std::string(static_cast<size_t>(small(gen) + 5) % 3, 'y'))),
+        maybe_null(ValueFactory::GetIntegerValue(small(gen))),
+    };
+    tuples.emplace_back(values, &schema);
+  }
+  return tuples;
+}
+
+auto ToCmpBool(const Value &val) -> CmpBool {
+  if (val.IsNull()) {
+    return CmpBool::CmpNull;
+  }
+  return val.GetAs<bool>() ? CmpBool::CmpTrue : CmpBool::CmpFalse;
+}
+
+auto Col(uint32_t tuple_idx, uint32_t col_idx, TypeId type) -> AbstractExpressionRef {
+  return std::make_shared<ColumnValueExpression>(tuple_idx, col_idx, type);
+}
+
+auto Const(const Value &val) -> AbstractExpressionRef { return std::make_shared<ConstantValueExpression>(val); }
+
+auto Cmp(AbstractExpressionRef lhs, AbstractExpressionRef rhs, ComparisonType type) -> AbstractExpressionRef {
+  return std::make_shared<ComparisonExpression>(std::move(lhs), std::move(rhs), type);
+}
+
+auto Logic(AbstractExpressionRef lhs, AbstractExpressionRef rhs, LogicType type) -> AbstractExpressionRef {
+  return std::make_shared<LogicExpression>(std::move(lhs), std::move(rhs), type);
+}
+
+const std::vector<ComparisonType> COMPARISONS = {ComparisonType::Equal,       ComparisonType::NotEqual,
+                                                 ComparisonType::LessThan,    ComparisonType::LessThanOrEqual,
+                                                 ComparisonType::GreaterThan, ComparisonType::GreaterThanOrEqual};
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(CompiledExpressionTest, PredicateTest) {
+  auto schema = MakeSchema();
+  auto tuples = MakeTuples(schema, 15445);
+
+  for (auto type : COMPARISONS) {
+    // specialized comparisons
+    std::vector<AbstractExpressionRef> specialized{
+        Cmp(Col(0, 0, TypeId::INTEGER), Const(ValueFactory::GetIntegerValue(1)), type),
+        Cmp(Const(ValueFactory::GetIntegerValue(1)), Col(0, 0, TypeId::INTEGER), type),
+        Cmp(Col(0, 1, TypeId::BIGINT), Const(ValueFactory::GetBigIntValue(-2)), type),
+        Cmp(Col(0, 2, TypeId::DECIMAL), Const(ValueFactory::GetDecimalValue(0.5)), type),
+        Cmp(Col(0, 3, TypeId::BOOLEAN), Const(ValueFactory::GetBooleanValue(true)), type),
+        Cmp(Col(0, 0, TypeId::INTEGER), Col(0, 5, TypeId::INTEGER), type),
+        Cmp(Col(0, 0, TypeId::INTEGER), Const(ValueFactory::GetNullValueByType(TypeId::INTEGER)), type),
+    };
+    for (const auto &expr : specialized) {
+      auto compiled = CompiledPredicate::Compile(expr, schema);
+      EXPECT_EQ(1, compiled.NumSpecialized()) << expr->ToString();
+      for (const auto &tuple : tuples) {
+        ASSERT_EQ(ToCmpBool(expr->Evaluate(&tuple, schema)), compiled.Evaluate(&tuple)) << expr->ToString();
+        TupleView view(tuple.GetRid(), tuple.GetData(), tuple.GetLength());
+        ASSERT_EQ(ToCmpBool(expr->Evaluate(&tuple, schema)), compiled.Evaluate(&view)) << expr->ToString();
+      }
+    }
+
+    // no specialization for strings or mixed types, those go through Evaluate()
+    std::vector<AbstractExpressionRef> fallback{
+        Cmp(Col(0, 4, TypeId::VARCHAR), Const(ValueFactory::GetVarcharValue("y")), type),
+        Cmp(Col(0, 0, TypeId::INTEGER), Col(0, 1, TypeId::BIGINT), type),
+    };
+    for (const auto &expr : fallback) {
+      auto compiled = CompiledPredicate::Compile(expr, schema);
+      EXPECT_EQ(0, compiled.NumSpecialized()) << expr->ToString();
+      for (const auto &tuple : tuples) {
+        ASSERT_EQ(ToCmpBool(expr->Evaluate(&tuple, schema)), compiled.Evaluate(&tuple)) << expr->ToString();
+        // a view that does not own a Tuple is materialized for Evaluate()
+        TupleView view(tuple.GetRid(), tuple.GetData(), tuple.GetLength());
+        ASSERT_EQ(ToCmpBool(expr->Evaluate(&tuple, schema)), compiled.Evaluate(&view)) << expr->ToString();
+      }
+    }
+  }
+
+  // three-valued AND / OR mixing specialized and fallback children
+  auto lt = Cmp(Col(0, 0, TypeId::INTEGER), Const(ValueFactory::GetIntegerValue(2)), ComparisonType::LessThan);
+  auto str = Cmp(Col(0, 4, TypeId::VARCHAR), Const(ValueFactory::GetVarcharValue("yy")), ComparisonType::Equal);
+  for (auto logic : {LogicType::And, LogicType::Or}) {
+    auto expr = Logic(Logic(lt, str, logic), Col(0, 3, TypeId::BOOLEAN), logic);
+    auto compiled = CompiledPredicate::Compile(expr, schema);
+    EXPECT_EQ(1, compiled.NumSpecialized());
+    for (const auto &tuple : tuples) {
+      ASSERT_EQ(ToCmpBool(expr->Evaluate(&tuple, schema)), compiled.Evaluate(&tuple));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(CompiledExpressionTest, JoinPredicateTest) {
+  auto schema = MakeSchema();
+  auto left = MakeTuples(schema, 1);
+  auto right = MakeTuples(schema, 2);
+  right.resize(50);
+
+  for (auto type : COMPARISONS) {
+    auto expr = Logic(Cmp(Col(0, 0, TypeId::INTEGER), Col(1, 5, TypeId::INTEGER), type),
+                      Cmp(Col(1, 2, TypeId::DECIMAL), Col(0, 2, TypeId::DECIMAL), type), LogicType::Or);
+    auto compiled = CompiledPredicate::CompileJoin(expr, schema, schema);
+    EXPECT_EQ(2, compiled.NumSpecialized());
+    for (const auto &l : left) {
+      for (const auto &r : right) {
+        ASSERT_EQ(ToCmpBool(expr->EvaluateJoin(&l, schema, &r, schema)), compiled.EvaluateJoin(&l, &r));
+      }
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,164 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sort_test.cpp
+//
+// Identification: test/execution/external_sort_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/external_sorter.h"
+#include "execution/sort_key.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** Reference order: NULL first, then the order of the Values */
+auto CompareValues(const Value &a, const Value &b) -> int {
+  if (a.IsNull() || b.IsNull()) {
+    return static_cast<int>(!a.IsNull()) - static_cast<int>(!b.IsNull());
+  }
+  if (a.CompareLessThan(b) == CmpBool::CmpTrue) {
+    return -1;
+  }
+  return a.CompareEquals(b) == CmpBool::CmpTrue ? 0 : 1;
+}
+
+auto Sign(int cmp) -> int { return (cmp > 0) - (cmp < 0); }
+
+auto RandomValue(TypeId type, std::mt19937 *gen) -> Value {
+  std::uniform_int_distribution<int> small(-3, 3);
+  std::uniform_int_distribution<int64_t> wide(-(1LL << 40), 1LL << 40);
+  std::uniform_int_distribution<int> percent(0, 99);
+  if (percent(*gen) < 10) {
+    return ValueFactory::GetNullValueByType(type);
+  }
+  switch (type) {
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(percent(*gen) < 50 ? small(*gen) : static_cast<int32_t>(wide(*gen)));
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(percent(*gen) < 50 ? small(*gen) : wide(*gen));
+    case TypeId::DECIMAL:
+      return ValueFactory::GetDecimalValue(percent(*gen) < 50 ? small(*gen) / 2.0 : wide(*gen) / 7.0);
+    case TypeId::VARCHAR: {
+      std::string str;
+      for (int i = small(*gen) + 3; i > 0; i--) {
+        str.push_back(static_cast<char>('a' + small(*gen) + 3));
+      }
+      return ValueFactory::GetVarcharValue(str);
+    }
+    default:
+      return ValueFactory::GetBooleanValue(small(*gen) > 0);
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(ExternalSortTest, SortKeyOrderTest) {
+  std::mt19937 gen(15445);
+  for (auto type : {TypeId::BOOLEAN, TypeId::INTEGER, TypeId::BIGINT, TypeId::DECIMAL, TypeId::VARCHAR}) {
+    std::vector<Value> values;
+    for (int i = 0; i < 300; i++) {
+      values.push_back(RandomValue(type, &gen));
+    }
+    for (bool descending : {false, true}) {
+      std::vector<std::string> keys(values.size());
+      for (size_t i = 0; i < values.size(); i++) {
+        SortKeyEncoder::EncodeValue(values[i], descending, &keys[i]);
+      }
+      for (size_t i = 0; i < values.size() && !descending; i++) {
+        const char *pos = keys[i].data();
+        auto decoded = SortKeyEncoder::DecodeValue(type, &pos);
+        ASSERT_EQ(keys[i].data() + keys[i].size(), pos);
+        ASSERT_EQ(0, CompareValues(values[i], decoded)) << values[i].ToString() << " vs " << decoded.ToString();
+      }
+      for (size_t i = 0; i < values.size(); i++) {
+        for (size_t j = 0; j < values.size(); j++) {
+          int expected = CompareValues(values[i], values[j]) * (descending ? -1 : 1);
+          ASSERT_EQ(expected, Sign(keys[i].compare(keys[j])))
+              << values[i].ToString() << " vs " << values[j].ToString() << " descending=" << descending;
+        }
+      }
+    }
+  }
+
+  // a string must sort before its extensions, even when followed by another key
+  std::string a;
+  std::string b;
+  SortKeyEncoder::EncodeValue(ValueFactory::GetVarcharValue("ab"), false, &a);
+  SortKeyEncoder::EncodeValue(ValueFactory::GetIntegerValue(9), false, &a);
+  SortKeyEncoder::EncodeValue(ValueFactory::GetVarcharValue("abc"), false, &b);
+  SortKeyEncoder::EncodeValue(ValueFactory::GetIntegerValue(0), false, &b);
+  EXPECT_LT(a, b);
+}
+
+// NOLINTNEXTLINE
+TEST(ExternalSortTest, SpillMergeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(32, disk_manager.get());
+  Schema schema({Column("k", TypeId::INTEGER), Column("seq", TypeId::INTEGER), Column("s", TypeId::VARCHAR, 32)});
+  SortKeyEncoder encoder({{OrderByType::DESC, std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER)}},
+                         &schema);
+
+  std::mt19937 gen(445);
+  std::uniform_int_distribution<int> key(0, 99);
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 20000; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(key(gen)), ValueFactory::GetIntegerValue(i),
+                              ValueFactory::GetVarcharValue(std::string(i % 20, 'x'))};
+    tuples.emplace_back(values, &schema);
+  }
+
+  // a budget of four pages: far more runs than can be merged at once, so the merge takes several passes
+  for (auto *pool : {static_cast<BufferPoolManager *>(nullptr), bpm.get()}) {
+    ExternalSorter sorter(pool, 4 * BUSTUB_PAGE_SIZE, 2);
+    for (const auto &tuple : tuples) {
+      std::string k;
+      encoder.Encode(tuple, &k);
+      sorter.Add(std::move(k), tuple);
+    }
+    sorter.Finish();
+    if (pool == nullptr) {
+      EXPECT_EQ(0, sorter.NumSpilledRuns());
+    } else {
+      EXPECT_LT(16, sorter.NumSpilledRuns());
+    }
+
+    // descending on k, ties in the order they were added
+    size_t count = 0;
+    Tuple prev;
+    Tuple tuple;
+    while (sorter.Next(&tuple)) {
+      if (count > 0) {
+        int prev_k = prev.GetValue(&schema, 0).GetAs<int32_t>();
+        int k = tuple.GetValue(&schema, 0).GetAs<int32_t>();
+        ASSERT_GE(prev_k, k);
+        if (prev_k == k) {
+          ASSERT_LT(prev.GetValue(&schema, 1).GetAs<int32_t>(), tuple.GetValue(&schema, 1).GetAs<int32_t>());
+        }
+      }
+      int seq = tuple.GetValue(&schema, 1).GetAs<int32_t>();
+      ASSERT_EQ(std::string(seq % 20, 'x'), tuple.GetValue(&schema, 2).ToString());
+      prev = tuple;
+      count++;
+    }
+    EXPECT_EQ(tuples.size(), count);
+  }
+}
+
+}  // namespace bustub
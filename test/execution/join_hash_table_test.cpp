@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table_test.cpp
+//
+// Identification: test/execution/join_hash_table_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/join_hash_table.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+// enough build rows for several radix partitions and several key chunks
+constexpr size_t NUM_BUILD_ROWS = 70000;
+constexpr size_t NUM_PROBE_ROWS = 20000;
+
+using Matches = std::vector<std::pair<uint32_t, uint32_t>>;
+
+auto MakeRows(const Schema &schema, size_t num_rows, int key_range, uint32_t seed) -> std::vector<Tuple> {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> key(0, key_range);
+  std::uniform_int_distribution<int> percent(0, 99);
+  std::vector<Tuple> rows;
+  rows.reserve(num_rows);
+  for (size_t i = 0; i < num_rows; i++) {
+    std::vector<Value> values;
+    for (const auto &col : schema.GetColumns()) {
+      int k = key(gen);
+      if (percent(gen) < 2) {
+        values.push_back(ValueFactory::GetNullValueByType(col.GetType()));
+      } else if (col.GetType() == TypeId::VARCHAR) {
+        values.push_back(ValueFactory::GetVarcharValue("k" + std::to_string(k % 7)));
+      } else if (col.GetType() == TypeId::BIGINT) {
+        values.push_back(ValueFactory::GetBigIntValue(k));
+      } else {
+        values.push_back(ValueFactory::GetIntegerValue(k));
+      }
+    }
+    rows.emplace_back(values, &schema);
+  }
+  return rows;
+}
+
+/** The same join, computed with an ordered map keyed on the printed key values */
+auto ReferenceJoin(const std::vector<Tuple> &build, const Schema &build_schema, const std::vector<Tuple> &probe,
+                   const Schema &probe_schema, bool keep_unmatched) -> Matches {
+  auto key_of = [](const Tuple &tuple, const Schema &schema, std::string *key) {
+    key->clear();
+    for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+      auto val = tuple.GetValue(&schema, i);
+      if (val.IsNull()) {
+        return false;
+      }
+      *key += val.ToString() + "|";
+    }
+    return true;
+  };
+  std::map<std::string, std::vector<uint32_t>> table;
+  std::string key;
+  for (uint32_t i = 0; i < build.size(); i++) {
+    if (key_of(build[i], build_schema, &key)) {
+      table[key].push_back(i);
+    }
+  }
+  Matches matches;
+  for (uint32_t i = 0; i < probe.size(); i++) {
+    auto it = key_of(probe[i], probe_schema, &key) ? table.find(key) : table.end();
+    if (it == table.end()) {
+      if (keep_unmatched) {
+        matches.emplace_back(i, RadixJoinHashTable::NO_MATCH);
+      }
+      continue;
+    }
+    for (auto row : it->second) {
+      matches.emplace_back(i, row);
+    }
+  }
+  return matches;
+}
+
+auto KeyExprs(const Schema &schema) -> std::vector<AbstractExpressionRef> {
+  std::vector<AbstractExpressionRef> exprs;
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    exprs.push_back(std::make_shared<ColumnValueExpression>(0, i, schema.GetColumn(i).GetType()));
+  }
+  return exprs;
+}
+
+void CheckJoin(const Schema &build_schema, const Schema &probe_schema, int key_range) {
+  auto build = MakeRows(build_schema, NUM_BUILD_ROWS, key_range, 15445);
+  auto probe = MakeRows(probe_schema, NUM_PROBE_ROWS, key_range, 445);
+  for (bool keep_unmatched : {false, true}) {
+    auto expected = ReferenceJoin(build, build_schema, probe, probe_schema, keep_unmatched);
+    for (size_t threads : {1, 4}) {
+      RadixJoinHashTable ht(KeyExprs(build_schema), &build_schema, KeyExprs(probe_schema), &probe_schema, threads);
+      ht.Build(std::vector<Tuple>(build));
+      EXPECT_EQ(NUM_BUILD_ROWS, ht.Size());
+      EXPECT_LT(1, ht.NumPartitions());
+      Matches matches;
+      ht.Probe(probe, keep_unmatched, &matches);
+      ASSERT_EQ(expected, matches) << "threads=" << threads << " keep_unmatched=" << keep_unmatched;
+    }
+  }
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(JoinHashTableTest, IntegralKeyTest) {
+  // INTEGER keys probed with BIGINT keys take the integral path
+  Schema build_schema({Column("a", TypeId::INTEGER)});
+  Schema probe_schema({Column("b", TypeId::BIGINT)});
+  CheckJoin(build_schema, probe_schema, 100000);
+}
+
+// NOLINTNEXTLINE
+TEST(JoinHashTableTest, CompositeKeyTest) {
+  Schema build_schema({Column("a", TypeId::INTEGER), Column("s", TypeId::VARCHAR, 8)});
+  Schema probe_schema({Column("b", TypeId::INTEGER), Column("t", TypeId::VARCHAR, 8)});
+  CheckJoin(build_schema, probe_schema, 20000);
+}
+
+// NOLINTNEXTLINE
+TEST(JoinHashTableTest, EmptyTest) {
+  Schema schema({Column("a", TypeId::INTEGER)});
+  auto probe = MakeRows(schema, 10, 5, 1);
+  RadixJoinHashTable ht(KeyExprs(schema), &schema, KeyExprs(schema), &schema, 4);
+  ht.Build({});
+  Matches matches;
+  ht.Probe(probe, false, &matches);
+  EXPECT_TRUE(matches.empty());
+  ht.Probe(probe, true, &matches);
+  EXPECT_EQ(10, matches.size());
+}
+
+}  // namespace bustub
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_table_scan_test.cpp
+//
+// Identification: test/execution/parallel_table_scan_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/schema.h"
+#include "common/task_scheduler.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/parallel_table_scan.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelTableScanTest, GatherInTableOrderTest) {
+  TaskScheduler scheduler(4);
+  TaskScheduler::Scope scope(&scheduler);
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(1024, disk_manager.get());
+  TableHeap table(bpm.get());
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 32)});
+
+  // enough rows for a few dozen morsels; every 7th row is deleted
+  const int num_rows = 40000;
+  std::vector<RID> expected_rids;
+  for (int i = 0; i < num_rows; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue("row" + std::to_string(i))}, &schema);
+    bool deleted = i % 7 == 0;
+    auto rid = table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, deleted}, tuple);
+    ASSERT_TRUE(rid.has_value());
+    if (!deleted) {
+      expected_rids.push_back(*rid);
+    }
+  }
+
+  CompiledPredicate no_filter;
+  for (size_t threads : {1, 3, 8}) {
+    ParallelTableScan scan(&table, &no_filter, threads);
+    ASSERT_GT(scan.NumMorsels(), 8);
+    std::vector<RID> rids;
+    std::vector<Tuple> morsel_tuples;
+    std::vector<RID> morsel_rids;
+    while (scan.Next(&morsel_tuples, &morsel_rids)) {
+      ASSERT_EQ(morsel_tuples.size(), morsel_rids.size());
+      for (size_t i = 0; i < morsel_rids.size(); i++) {
+        ASSERT_EQ(morsel_rids[i], morsel_tuples[i].GetRid());
+        rids.push_back(morsel_rids[i]);
+      }
+    }
+    ASSERT_EQ(expected_rids, rids) << "threads=" << threads;
+  }
+
+  // the filter runs on the workers: keep the rows with a < 3000
+  auto pred = std::make_shared<ComparisonExpression>(
+      std::make_shared<ColumnValueExpression>(0, 0, TypeId::INTEGER),
+      std::make_shared<ConstantValueExpression>(ValueFactory::GetIntegerValue(3000)), ComparisonType::LessThan);
+  auto filter = CompiledPredicate::Compile(pred, schema);
+  ParallelTableScan scan(&table, &filter, 4);
+  std::vector<Tuple> tuples;
+  std::vector<RID> rids;
+  std::vector<int> values;
+  while (scan.Next(&tuples, &rids)) {
+    for (const auto &tuple : tuples) {
+      values.push_back(tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    }
+  }
+  std::vector<int> expected;
+  for (int i = 0; i < 3000; i++) {
+    if (i % 7 != 0) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_EQ(expected, values);
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelTableScanTest, StopEarlyTest) {
+  TaskScheduler scheduler(4);
+  TaskScheduler::Scope scope(&scheduler);
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(1024, disk_manager.get());
+  TableHeap table(bpm.get());
+  Schema schema({Column("a", TypeId::INTEGER)});
+  for (int i = 0; i < 50000; i++) {
+    table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false},
+                      Tuple({ValueFactory::GetIntegerValue(i)}, &schema));
+  }
+
+  // rows inserted after the scan was created are not scanned
+  CompiledPredicate no_filter;
+  std::vector<Tuple> tuples;
+  std::vector<RID> rids;
+  {
+    ParallelTableScan scan(&table, &no_filter, 4);
+    table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false},
+                      Tuple({ValueFactory::GetIntegerValue(-1)}, &schema));
+    size_t num_rows = 0;
+    while (scan.Next(&tuples, &rids)) {
+      num_rows += tuples.size();
+    }
+    ASSERT_EQ(50000, num_rows);
+  }
+
+  // the destructor stops the workers that are still ahead of the gatherer
+  ParallelTableScan scan(&table, &no_filter, 4);
+  for (size_t morsel = 0; morsel < 3; morsel++) {
+    ASSERT_TRUE(scan.Next(&tuples, &rids));
+  }
+}
+
+}  // namespace bustub
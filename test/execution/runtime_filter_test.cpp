@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter_test.cpp
+//
+// Identification: test/execution/runtime_filter_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/runtime_filter.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(RuntimeFilterTest, BloomFilterTest) {
+  RuntimeFilter filter;
+  for (int i = 0; i < 10000; i += 2) {
+    filter.Insert({ValueFactory::GetIntegerValue(i)});
+  }
+  filter.Insert({ValueFactory::GetNullValueByType(TypeId::INTEGER)});
+  filter.Seal();
+  ASSERT_EQ(5000, filter.NumKeys());
+
+  // no false negatives, whatever the width of the probe keys
+  for (int i = 0; i < 10000; i += 2) {
+    ASSERT_TRUE(filter.MayContain({ValueFactory::GetIntegerValue(i)}));
+    ASSERT_TRUE(filter.MayContain({ValueFactory::GetBigIntValue(i)}));
+  }
+  // few false positives inside the range, none outside of it or for NULL
+  size_t false_positives = 0;
+  for (int i = 1; i < 10000; i += 2) {
+    false_positives += filter.MayContain({ValueFactory::GetIntegerValue(i)}) ? 1 : 0;
+  }
+  ASSERT_LT(false_positives, 250);
+  ASSERT_FALSE(filter.MayContain({ValueFactory::GetIntegerValue(-1)}));
+  ASSERT_FALSE(filter.MayContain({ValueFactory::GetIntegerValue(10000)}));
+  ASSERT_FALSE(filter.MayContain({ValueFactory::GetNullValueByType(TypeId::INTEGER)}));
+
+  auto range = filter.GetRange();
+  ASSERT_TRUE(range.has_value());
+  ASSERT_EQ(0, range->first);
+  ASSERT_EQ(9998, range->second);
+
+  // an empty build side matches nothing
+  RuntimeFilter empty;
+  empty.Seal();
+  ASSERT_FALSE(empty.MayContain({ValueFactory::GetIntegerValue(0)}));
+  ASSERT_FALSE(empty.GetRange().has_value());
+}
+
+// NOLINTNEXTLINE
+TEST(RuntimeFilterTest, CompositeKeyTest) {
+  auto filter = std::make_shared<RuntimeFilter>();
+  for (int i = 0; i < 100; i++) {
+    filter->Insert({ValueFactory::GetVarcharValue("k" + std::to_string(i)), ValueFactory::GetIntegerValue(i)});
+  }
+  filter->Seal();
+  ASSERT_FALSE(filter->GetRange().has_value());
+
+  // probes read the key columns out of the scanned rows, in key order
+  Schema schema({Column("id", TypeId::INTEGER), Column("pad", TypeId::INTEGER), Column("name", TypeId::VARCHAR, 8)});
+  RuntimeFilterProbe probe{filter, {2, 0}};
+  Tuple hit({ValueFactory::GetIntegerValue(42), ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue("k42")},
+            &schema);
+  ASSERT_TRUE(probe.MayMatch(TupleView(hit), schema));
+  size_t passed = 0;
+  for (int i = 0; i < 100; i++) {
+    Tuple miss({ValueFactory::GetIntegerValue(i + 1), ValueFactory::GetIntegerValue(0),
+                ValueFactory::GetVarcharValue("k" + std::to_string(i))},
+               &schema);
+    passed += probe.MayMatch(TupleView(miss), schema) ? 1 : 0;
+  }
+  ASSERT_LT(passed, 10);
+
+  // through a scan producing only some of the table columns
+  auto on_table = RuntimeFilterProbe{filter, {1, 0}}.OnTableColumns({0, 2});
+  ASSERT_EQ((std::vector<uint32_t>{2, 0}), on_table.columns_);
+
+  ASSERT_TRUE(RuntimeFilter::SupportsTypes(TypeId::INTEGER, TypeId::BIGINT));
+  ASSERT_TRUE(RuntimeFilter::SupportsTypes(TypeId::VARCHAR, TypeId::VARCHAR));
+  ASSERT_FALSE(RuntimeFilter::SupportsTypes(TypeId::DECIMAL, TypeId::DECIMAL));
+  ASSERT_FALSE(RuntimeFilter::SupportsTypes(TypeId::VARCHAR, TypeId::INTEGER));
+}
+
+// NOLINTNEXTLINE
+TEST(RuntimeFilterTest, ZoneMapFilterTest) {
+  auto filter = std::make_shared<RuntimeFilter>();
+  for (int i = 100; i <= 200; i++) {
+    filter->Insert({ValueFactory::GetIntegerValue(i)});
+  }
+  filter->Seal();
+
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 8)});
+  ZoneMap::Layout layout(schema);
+  auto make_zone_map = [&](int lo, int hi) {
+    ZoneMap zone_map(layout);
+    for (int i = lo; i <= hi; i++) {
+      Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue("x")}, &schema);
+      zone_map.Add(layout, TupleView(tuple));
+    }
+    return zone_map;
+  };
+
+  auto pages = RuntimeFilterProbe{filter, {0}}.MakeZoneMapFilter(layout);
+  ASSERT_TRUE(pages);
+  ASSERT_FALSE(pages(make_zone_map(0, 99)));
+  ASSERT_TRUE(pages(make_zone_map(50, 100)));
+  ASSERT_TRUE(pages(make_zone_map(150, 160)));
+  ASSERT_FALSE(pages(make_zone_map(201, 300)));
+
+  // untracked columns cannot rule out pages
+  auto text = std::make_shared<RuntimeFilter>();
+  text->Insert({ValueFactory::GetVarcharValue("x")});
+  text->Seal();
+  RuntimeFilterProbe on_text{text, {1}};
+  ASSERT_FALSE(on_text.MakeZoneMapFilter(layout));
+}
+
+}  // namespace bustub
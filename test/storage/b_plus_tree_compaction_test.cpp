@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_compaction_test.cpp
+//
+// Identification: test/storage/b_plus_tree_compaction_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+    using bustub::DiskManagerUnlimitedMemory;
+
+    TEST(BPlusTreeTests, CompactionTest) {
+        auto key_schema = ParseCreateStatement("a bigint");
+        GenericComparator<8> comparator(key_schema.get());
+
+        auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+        auto *bpm = new BufferPoolManager(50, disk_manager.get());
+        page_id_t page_id;
+        auto header_page = bpm->NewPage(&page_id);
+        BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 16,
+                                                                 16);
+        GenericKey<8> index_key;
+        RID rid;
+        auto *transaction = new Transaction(0);
+
+        const int64_t n = 200;
+        for (int64_t key = 1; key <= n; key++) {
+            rid.Set(0, key);
+            index_key.SetFromInteger(key);
+            tree.Insert(index_key, rid, transaction);
+        }
+
+        // Keep every other key: leaves drain to the low-water mark without being rebalanced.
+        for (int64_t key = 1; key <= n; key++) {
+            if (key % 2 != 0) {
+                index_key.SetFromInteger(key);
+                tree.Remove(index_key, transaction);
+            }
+        }
+
+        EXPECT_GT(tree.Compact(), 0);
+        EXPECT_EQ(tree.Compact(), 0);
+
+        std::vector<RID> rids;
+        for (int64_t key = 1; key <= n; key++) {
+            rids.clear();
+            index_key.SetFromInteger(key);
+            tree.GetValue(index_key, &rids);
+            if (key % 2 == 0) {
+                EXPECT_EQ(rids.size(), 1);
+                EXPECT_EQ(rids[0].GetSlotNum(), key);
+            } else {
+                EXPECT_EQ(rids.size(), 0);
+            }
+        }
+
+        int64_t expected = 2;
+        for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+            EXPECT_EQ((*iter).second.GetSlotNum(), expected);
+            expected += 2;
+        }
+        EXPECT_EQ(expected, n + 2);
+
+        bpm->UnpinPage(HEADER_PAGE_ID, true);
+        delete transaction;
+        delete bpm;
+    }
+
+    TEST(BPlusTreeTests, BackgroundCompactionTest) {
+        auto key_schema = ParseCreateStatement("a bigint");
+        GenericComparator<8> comparator(key_schema.get());
+
+        auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+        auto *bpm = new BufferPoolManager(50, disk_manager.get());
+        page_id_t page_id;
+        auto header_page = bpm->NewPage(&page_id);
+        BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 16,
+                                                                 16);
+        GenericKey<8> index_key;
+        RID rid;
+        auto *transaction = new Transaction(0);
+
+        btree_compaction_interval = std::chrono::milliseconds(10);
+        tree.StartBackgroundCompaction();
+        for (int64_t key = 1; key <= 100; key++) {
+            rid.Set(0, key);
+            index_key.SetFromInteger(key);
+            tree.Insert(index_key, rid, transaction);
+        }
+        for (int64_t key = 1; key <= 100; key += 2) {
+            index_key.SetFromInteger(key);
+            tree.Remove(index_key, transaction);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        tree.StopBackgroundCompaction();
+        EXPECT_EQ(tree.Compact(), 0);
+
+        std::vector<RID> rids;
+        for (int64_t key = 2; key <= 100; key += 2) {
+            rids.clear();
+            index_key.SetFromInteger(key);
+            tree.GetValue(index_key, &rids);
+            EXPECT_EQ(rids.size(), 1);
+        }
+
+        bpm->UnpinPage(HEADER_PAGE_ID, true);
+        delete transaction;
+        delete bpm;
+    }
+}  // namespace bustub
@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_heap_test.cpp
+//
+// Identification: test/storage/tmp_tuple_heap_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/tmp_tuple_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TmpTupleHeapTest, AppendReadTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  // far fewer frames than pages written, so pages get evicted and read back from disk
+  auto bpm = std::make_unique<BufferPoolManager>(4, disk_manager.get());
+  Schema schema({Column("a", TypeId::INTEGER), Column("s", TypeId::VARCHAR, 64)});
+
+  std::vector<Tuple> expected;
+  {
+    TmpTupleHeap heap(bpm.get());
+    for (int i = 0; i < 5000; i++) {
+      std::vector<Value> values{ValueFactory::GetIntegerValue(i),
+                                i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                                           : ValueFactory::GetVarcharValue(std::string(i % 50, 'x'))};
+      expected.emplace_back(values, &schema);
+      heap.Append(expected.back());
+    }
+    ASSERT_EQ(5000, heap.Size());
+    ASSERT_LT(10, heap.NumPages());
+
+    std::vector<Tuple> tuples;
+    for (size_t page = 0; page < heap.NumPages(); page++) {
+      heap.ReadPage(page, &tuples);
+    }
+    ASSERT_EQ(expected.size(), tuples.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+      for (uint32_t col = 0; col < schema.GetColumnCount(); col++) {
+        auto want = expected[i].GetValue(&schema, col);
+        auto got = tuples[i].GetValue(&schema, col);
+        ASSERT_EQ(want.IsNull(), got.IsNull());
+        ASSERT_TRUE(want.IsNull() || want.CompareEquals(got) == CmpBool::CmpTrue);
+      }
+    }
+
+    // appending after reading keeps going on a new page
+    heap.Append(expected.front());
+    std::vector<Tuple> last;
+    heap.ReadPage(heap.NumPages() - 1, &last);
+    ASSERT_EQ(1, last.size());
+  }
+
+  // the heap unpinned and deleted all of its pages, every frame is free again
+  std::vector<page_id_t> page_ids(4);
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTupleHeapTest, TooLargeTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(4, disk_manager.get());
+  Schema schema({Column("s", TypeId::VARCHAR, BUSTUB_PAGE_SIZE)});
+  Tuple tuple({ValueFactory::GetVarcharValue(std::string(BUSTUB_PAGE_SIZE, 'x'))}, &schema);
+  TmpTupleHeap heap(bpm.get());
+  ASSERT_THROW(heap.Append(tuple), ExecutionException);
+}
+
+}  // namespace bustub
@@ -12,15 +12,19 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -61,4 +65,52 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, TupleViewTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(1024, disk_manager.get());
+  TableHeap table(bpm.get());
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 32)});
+
+  const int num_rows = 5000;
+  for (int i = 0; i < num_rows; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue("row" + std::to_string(i))}, &schema);
+    ASSERT_TRUE(table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, i % 5 == 0}, tuple).has_value());
+  }
+
+  // the iterator stops at the rows that existed when it was created
+  auto iter = table.MakeIterator();
+  Tuple extra({ValueFactory::GetIntegerValue(num_rows), ValueFactory::GetVarcharValue("extra")}, &schema);
+  ASSERT_TRUE(table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, extra).has_value());
+
+  // views read the rows in place, page by page
+  int next = 0;
+  size_t num_pages = 0;
+  while (!iter.IsEnd()) {
+    iter.ScanPage([&](const TupleMeta &meta, const TupleView &view) {
+      ASSERT_EQ(next % 5 == 0, meta.is_deleted_);
+      ASSERT_EQ(next, view.GetValue(&schema, 0).GetAs<int32_t>());
+      ASSERT_EQ("row" + std::to_string(next), view.GetValue(&schema, 1).ToString());
+
+      auto [stored_meta, stored] = table.GetTuple(view.GetRid());
+      Tuple copy = view.ToTuple();
+      ASSERT_EQ(view.GetRid(), copy.GetRid());
+      ASSERT_EQ(stored.GetLength(), copy.GetLength());
+      ASSERT_EQ(0, memcmp(stored.GetData(), copy.GetData(), copy.GetLength()));
+      next++;
+    });
+    num_pages++;
+  }
+  ASSERT_EQ(num_rows, next);
+  ASSERT_GT(num_pages, 1);
+
+  // a view of an owned tuple hands out the tuple itself, other views a copy
+  Tuple scratch;
+  TupleView owned(extra);
+  ASSERT_EQ(&extra, owned.AsTuple(&scratch));
+  TupleView unowned(extra.GetRid(), extra.GetData(), extra.GetLength());
+  ASSERT_EQ(&scratch, unowned.AsTuple(&scratch));
+  ASSERT_EQ("extra", scratch.GetValue(&schema, 1).ToString());
+}
+
 }  // namespace bustub
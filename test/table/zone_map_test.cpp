@@ -0,0 +1,205 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// zone_map_test.cpp
+//
+// Identification: test/table/zone_map_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/compiled_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/table_heap.h"
+#include "storage/table/zone_map.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto ColumnRef(uint32_t col_idx, TypeId type) -> AbstractExpressionRef {
+  return std::make_shared<ColumnValueExpression>(0, col_idx, type);
+}
+
+auto Constant(const Value &val) -> AbstractExpressionRef { return std::make_shared<ConstantValueExpression>(val); }
+
+auto Compare(const AbstractExpressionRef &lhs, ComparisonType op, const AbstractExpressionRef &rhs)
+    -> AbstractExpressionRef {
+  return std::make_shared<ComparisonExpression>(lhs, rhs, op);
+}
+
+auto Logic(const AbstractExpressionRef &lhs, LogicType op, const AbstractExpressionRef &rhs) -> AbstractExpressionRef {
+  return std::make_shared<LogicExpression>(lhs, rhs, op);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(ZoneMapTest, RangeTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 16),
+                 Column("c", TypeId::DECIMAL), Column("d", TypeId::BIGINT)});
+  ZoneMap::Layout layout(schema);
+  ASSERT_TRUE(layout.IsTracked(0));
+  ASSERT_FALSE(layout.IsTracked(1));
+  ASSERT_TRUE(layout.IsTracked(2));
+
+  ZoneMap zone_map(layout);
+  // an empty zone map rules out every comparison
+  ASSERT_FALSE(zone_map.MayBeEqual(0, ValueFactory::GetIntegerValue(0)));
+  ASSERT_FALSE(zone_map.MayDiffer(0, ValueFactory::GetIntegerValue(0)));
+
+  for (int i = 10; i <= 20; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue("x"),
+                 ValueFactory::GetDecimalValue(i / 2.0), ValueFactory::GetNullValueByType(TypeId::BIGINT)},
+                &schema);
+    zone_map.Add(layout, TupleView(tuple));
+  }
+
+  ASSERT_TRUE(zone_map.MayBeEqual(0, ValueFactory::GetIntegerValue(10)));
+  ASSERT_TRUE(zone_map.MayBeEqual(0, ValueFactory::GetIntegerValue(20)));
+  ASSERT_FALSE(zone_map.MayBeEqual(0, ValueFactory::GetIntegerValue(21)));
+  ASSERT_FALSE(zone_map.MayBeLess(0, ValueFactory::GetIntegerValue(10), false));
+  ASSERT_TRUE(zone_map.MayBeLess(0, ValueFactory::GetIntegerValue(10), true));
+  ASSERT_FALSE(zone_map.MayBeGreater(0, ValueFactory::GetIntegerValue(20), false));
+  ASSERT_TRUE(zone_map.MayBeGreater(0, ValueFactory::GetIntegerValue(20), true));
+  ASSERT_TRUE(zone_map.MayDiffer(0, ValueFactory::GetIntegerValue(15)));
+
+  ASSERT_TRUE(zone_map.MayBeLess(2, ValueFactory::GetDecimalValue(5.5), false));
+  ASSERT_FALSE(zone_map.MayBeLess(2, ValueFactory::GetDecimalValue(5.0), false));
+  ASSERT_FALSE(zone_map.MayBeGreater(2, ValueFactory::GetDecimalValue(10.0), false));
+
+  // NULLs are left out, a column of NULLs only matches nothing
+  ASSERT_FALSE(zone_map.MayBeEqual(3, ValueFactory::GetBigIntValue(BUSTUB_INT64_NULL)));
+  ASSERT_FALSE(zone_map.MayDiffer(3, ValueFactory::GetBigIntValue(0)));
+
+  // a single value only differs from other values
+  ZoneMap single(layout);
+  Tuple tuple({ValueFactory::GetIntegerValue(7), ValueFactory::GetVarcharValue("x"), ValueFactory::GetDecimalValue(1),
+               ValueFactory::GetBigIntValue(1)},
+              &schema);
+  single.Add(layout, TupleView(tuple));
+  ASSERT_FALSE(single.MayDiffer(0, ValueFactory::GetIntegerValue(7)));
+  ASSERT_TRUE(single.MayDiffer(0, ValueFactory::GetIntegerValue(8)));
+}
+
+// NOLINTNEXTLINE
+TEST(ZoneMapTest, FilterTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 16)});
+  ZoneMap::Layout layout(schema);
+  ZoneMap zone_map(layout);
+  for (int i = 100; i < 200; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue("x")}, &schema);
+    zone_map.Add(layout, TupleView(tuple));
+  }
+
+  auto a = ColumnRef(0, TypeId::INTEGER);
+  auto b = ColumnRef(1, TypeId::VARCHAR);
+  auto int_value = [](int v) { return Constant(ValueFactory::GetIntegerValue(v)); };
+
+  auto filter = CompileZoneMapFilter(Compare(a, ComparisonType::GreaterThan, int_value(150)), schema, layout);
+  ASSERT_TRUE(filter);
+  ASSERT_TRUE(filter(zone_map));
+  filter = CompileZoneMapFilter(Compare(a, ComparisonType::GreaterThanOrEqual, int_value(200)), schema, layout);
+  ASSERT_FALSE(filter(zone_map));
+  // constants on the left are flipped
+  filter = CompileZoneMapFilter(Compare(int_value(100), ComparisonType::GreaterThan, a), schema, layout);
+  ASSERT_FALSE(filter(zone_map));
+  filter = CompileZoneMapFilter(Compare(int_value(100), ComparisonType::GreaterThanOrEqual, a), schema, layout);
+  ASSERT_TRUE(filter(zone_map));
+
+  // AND rules a page out if either side does, OR only if both do
+  auto in_range = Compare(a, ComparisonType::LessThan, int_value(150));
+  auto out_of_range = Compare(a, ComparisonType::Equal, int_value(500));
+  filter = CompileZoneMapFilter(Logic(in_range, LogicType::And, out_of_range), schema, layout);
+  ASSERT_FALSE(filter(zone_map));
+  filter = CompileZoneMapFilter(Logic(in_range, LogicType::Or, out_of_range), schema, layout);
+  ASSERT_TRUE(filter(zone_map));
+  filter = CompileZoneMapFilter(Logic(out_of_range, LogicType::Or, out_of_range), schema, layout);
+  ASSERT_FALSE(filter(zone_map));
+
+  // untracked columns and column-column comparisons may match any page
+  auto on_varchar = Compare(b, ComparisonType::Equal, Constant(ValueFactory::GetVarcharValue("y")));
+  ASSERT_FALSE(CompileZoneMapFilter(on_varchar, schema, layout));
+  ASSERT_FALSE(CompileZoneMapFilter(Compare(a, ComparisonType::Equal, a), schema, layout));
+  ASSERT_FALSE(CompileZoneMapFilter(Logic(on_varchar, LogicType::Or, out_of_range), schema, layout));
+  filter = CompileZoneMapFilter(Logic(on_varchar, LogicType::And, out_of_range), schema, layout);
+  ASSERT_FALSE(filter(zone_map));
+
+  // comparisons with NULL never hold
+  filter = CompileZoneMapFilter(
+      Compare(a, ComparisonType::NotEqual, Constant(ValueFactory::GetNullValueByType(TypeId::INTEGER))), schema,
+      layout);
+  ASSERT_FALSE(filter(zone_map));
+}
+
+// NOLINTNEXTLINE
+TEST(ZoneMapTest, TableHeapTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(1024, disk_manager.get());
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 32)});
+  TableHeap table(bpm.get(), &schema);
+  ASSERT_NE(nullptr, table.GetZoneMapLayout());
+
+  // rows are inserted in key order, so every page covers a narrow range of keys
+  const int num_rows = 5000;
+  for (int i = 0; i < num_rows; i++) {
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue("row" + std::to_string(i))}, &schema);
+    ASSERT_TRUE(table.InsertTuple(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, tuple).has_value());
+  }
+
+  auto predicate = Compare(ColumnRef(0, TypeId::INTEGER), ComparisonType::Equal,
+                           Constant(ValueFactory::GetIntegerValue(num_rows / 2)));
+  auto filter = CompileZoneMapFilter(predicate, schema, *table.GetZoneMapLayout());
+  ASSERT_TRUE(filter);
+
+  // a scan visits only the page that holds the key
+  auto iter = table.MakeEagerIterator();
+  size_t num_pages = 0;
+  size_t num_visited_pages = 0;
+  std::vector<int> found;
+  while (!iter.IsEnd()) {
+    bool visited = false;
+    iter.ScanPage(
+        [&](const TupleMeta &, const TupleView &view) {
+          visited = true;
+          if (view.GetValue(&schema, 0).GetAs<int32_t>() == num_rows / 2) {
+            found.push_back(num_rows / 2);
+          }
+        },
+        &filter);
+    num_pages++;
+    num_visited_pages += visited ? 1 : 0;
+  }
+  ASSERT_GT(num_pages, 2);
+  ASSERT_EQ(1, num_visited_pages);
+  ASSERT_EQ(std::vector<int>{num_rows / 2}, found);
+
+  // updates in place widen the zone map of their page
+  auto first = table.MakeEagerIterator();
+  RID rid = first.GetRID();
+  ASSERT_FALSE(table.PageMayMatch(rid.GetPageId(), filter));
+  Tuple updated({ValueFactory::GetIntegerValue(num_rows / 2), ValueFactory::GetVarcharValue("row0")}, &schema);
+  table.UpdateTupleInPlaceUnsafe(TupleMeta{INVALID_TXN_ID, INVALID_TXN_ID, false}, updated, rid);
+  ASSERT_TRUE(table.PageMayMatch(rid.GetPageId(), filter));
+
+  // tables without a schema keep no zone maps
+  TableHeap plain(bpm.get());
+  ASSERT_EQ(nullptr, plain.GetZoneMapLayout());
+  ASSERT_TRUE(plain.PageMayMatch(plain.GetFirstPageId(), filter));
+}
+
+}  // namespace bustub
@@ -0,0 +1,194 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_vector_test.cpp
+//
+// Identification: test/type/column_vector_test.cpp
+//
+// Copyright (c) 2015-2023, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/arithmetic_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/expressions/vector_kernels.h"
+#include "gtest/gtest.h"
+#include "type/column_vector.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+// 1000 full AVX2 iterations plus a tail, so both the SIMD loops and the scalar remainder run
+constexpr size_t NUM_ROWS = 1013;
+
+auto MakeSchema() -> Schema {
+  return Schema({Column("a", TypeId::INTEGER), Column("b", TypeId::INTEGER), Column("c", TypeId::BIGINT),
+                 Column("d", TypeId::DECIMAL), Column("e", TypeId::BOOLEAN), Column("s", TypeId::VARCHAR, 16)});
+}
+
+auto MakeTuples(const Schema &schema) -> std::vector<Tuple> {
+  std::mt19937 gen(15445);
+  std::uniform_int_distribution<int> small(-20, 20);
+  std::uniform_int_distribution<int> percent(0, 99);
+  auto maybe_null = [&](Value val) {
+    return percent(gen) < 10 ? ValueFactory::GetNullValueByType(val.GetTypeId()) : val;
+  };
+  std::vector<Tuple> tuples;
+  for (size_t i = 0; i < NUM_ROWS; i++) {
+    std::vector<Value> values{
+        maybe_null(ValueFactory::GetIntegerValue(small(gen))),
+        maybe_null(ValueFactory::GetIntegerValue(small(gen))),
+        maybe_null(ValueFactory::GetBigIntValue(static_cast<int64_t>(small(gen)) << 33)),
+        maybe_null(ValueFactory::GetDecimalValue(small(gen) / 4.0)),
+        maybe_null(ValueFactory::GetBooleanValue(small(gen) > 0)),
+        maybe_null(ValueFactory::GetVarcharValue(std::string(static_cast<size_t>(small(gen) + 20) % 5, 'x'))),
+    };
+    tuples.emplace_back(values, &schema);
+  }
+  return tuples;
+}
+
+void ExpectSameValue(const Value &expected, const Value &actual, size_t row) {
+  ASSERT_EQ(expected.IsNull(), actual.IsNull()) << "row " << row;
+  if (!expected.IsNull()) {
+    ASSERT_EQ(CmpBool::CmpTrue, expected.CompareEquals(actual)) << "row " << row;
+  }
+}
+
+/** EvaluateBatch has to agree with Evaluate on every row, NULLs included */
+void CheckBatch(const AbstractExpressionRef &expr, const std::vector<Tuple> &tuples, const Schema &schema) {
+  ColumnVector result;
+  expr->EvaluateBatch(tuples, schema, &result);
+  ASSERT_EQ(expr->GetReturnType(), result.GetType()) << expr->ToString();
+  ASSERT_EQ(tuples.size(), result.Size()) << expr->ToString();
+  for (size_t i = 0; i < tuples.size(); i++) {
+    ExpectSameValue(expr->Evaluate(&tuples[i], schema), result.GetValue(i), i);
+  }
+}
+
+auto Col(uint32_t idx, TypeId type) -> AbstractExpressionRef {
+  return std::make_shared<ColumnValueExpression>(0, idx, type);
+}
+
+auto Const(const Value &val) -> AbstractExpressionRef { return std::make_shared<ConstantValueExpression>(val); }
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(ColumnVectorTest, LoadColumnTest) {
+  auto schema = MakeSchema();
+  auto tuples = MakeTuples(schema);
+  for (uint32_t col = 0; col < schema.GetColumnCount(); col++) {
+    ColumnVector vector;
+    vector.LoadColumn(tuples, schema, col);
+    ASSERT_EQ(schema.GetColumn(col).GetType(), vector.GetType());
+    ASSERT_EQ(NUM_ROWS, vector.Size());
+    for (size_t i = 0; i < NUM_ROWS; i++) {
+      ExpectSameValue(tuples[i].GetValue(&schema, col), vector.GetValue(i), i);
+    }
+  }
+
+  ColumnVector strings;
+  strings.Reset(TypeId::VARCHAR, 0);
+  strings.Append(ValueFactory::GetVarcharValue("hello"));
+  strings.Append(ValueFactory::GetNullValueByType(TypeId::VARCHAR));
+  strings.Append(ValueFactory::GetVarcharValue(""));
+  ASSERT_EQ(3, strings.Size());
+  EXPECT_EQ("hello", strings.GetString(0));
+  EXPECT_TRUE(strings.IsNull(1));
+  EXPECT_FALSE(strings.IsNull(2));
+  EXPECT_EQ("", strings.GetString(2));
+
+  ColumnVector constants;
+  constants.Broadcast(ValueFactory::GetNullValueByType(TypeId::INTEGER), 4);
+  ASSERT_EQ(4, constants.Size());
+  EXPECT_TRUE(constants.IsNull(3));
+}
+
+// NOLINTNEXTLINE
+TEST(ColumnVectorTest, ExpressionKernelTest) {
+  auto schema = MakeSchema();
+  auto tuples = MakeTuples(schema);
+  const std::vector<ComparisonType> comparisons = {ComparisonType::Equal,           ComparisonType::NotEqual,
+                                                   ComparisonType::LessThan,        ComparisonType::LessThanOrEqual,
+                                                   ComparisonType::GreaterThan,     ComparisonType::GreaterThanOrEqual};
+
+  for (bool simd : {true, false}) {
+    SetSimdKernelsEnabled(simd);
+    for (auto cmp : comparisons) {
+      // vector against constant, for every type with a kernel
+      CheckBatch(std::make_shared<ComparisonExpression>(Col(0, TypeId::INTEGER),
+                                                        Const(ValueFactory::GetIntegerValue(3)), cmp),
+                 tuples, schema);
+      CheckBatch(std::make_shared<ComparisonExpression>(Col(2, TypeId::BIGINT),
+                                                        Const(ValueFactory::GetBigIntValue(int64_t{3} << 33)), cmp),
+                 tuples, schema);
+      CheckBatch(std::make_shared<ComparisonExpression>(Col(3, TypeId::DECIMAL),
+                                                        Const(ValueFactory::GetDecimalValue(0.75)), cmp),
+                 tuples, schema);
+      CheckBatch(std::make_shared<ComparisonExpression>(
+                     Col(0, TypeId::INTEGER), Const(ValueFactory::GetNullValueByType(TypeId::INTEGER)), cmp),
+                 tuples, schema);
+      // vector against vector
+      CheckBatch(std::make_shared<ComparisonExpression>(Col(0, TypeId::INTEGER), Col(1, TypeId::INTEGER), cmp),
+                 tuples, schema);
+      CheckBatch(std::make_shared<ComparisonExpression>(Col(3, TypeId::DECIMAL), Col(3, TypeId::DECIMAL), cmp),
+                 tuples, schema);
+      CheckBatch(std::make_shared<ComparisonExpression>(Col(4, TypeId::BOOLEAN),
+                                                        Const(ValueFactory::GetBooleanValue(true)), cmp),
+                 tuples, schema);
+      // no kernel: mixed types and strings go through Value
+      CheckBatch(std::make_shared<ComparisonExpression>(Col(0, TypeId::INTEGER), Col(2, TypeId::BIGINT), cmp),
+                 tuples, schema);
+      CheckBatch(std::make_shared<ComparisonExpression>(Col(5, TypeId::VARCHAR),
+                                                        Const(ValueFactory::GetVarcharValue("xx")), cmp),
+                 tuples, schema);
+    }
+
+    for (auto op : {ArithmeticType::Plus, ArithmeticType::Minus}) {
+      CheckBatch(std::make_shared<ArithmeticExpression>(Col(0, TypeId::INTEGER), Col(1, TypeId::INTEGER), op),
+                 tuples, schema);
+      CheckBatch(std::make_shared<ArithmeticExpression>(Col(0, TypeId::INTEGER),
+                                                        Const(ValueFactory::GetIntegerValue(7)), op),
+                 tuples, schema);
+    }
+
+    auto lt = std::make_shared<ComparisonExpression>(Col(0, TypeId::INTEGER), Const(ValueFactory::GetIntegerValue(5)),
+                                                     ComparisonType::LessThan);
+    for (auto op : {LogicType::And, LogicType::Or}) {
+      CheckBatch(std::make_shared<LogicExpression>(lt, Col(4, TypeId::BOOLEAN), op), tuples, schema);
+      CheckBatch(std::make_shared<LogicExpression>(Col(4, TypeId::BOOLEAN), Col(4, TypeId::BOOLEAN), op), tuples,
+                 schema);
+    }
+
+    // the selection vector keeps exactly the rows that evaluate to true
+    auto pred = std::make_shared<LogicExpression>(lt, Col(4, TypeId::BOOLEAN), LogicType::Or);
+    ColumnVector result;
+    SelectionVector selection;
+    pred->EvaluateBatch(tuples, schema, &result);
+    SelectTrue(result, &selection);
+    SelectionVector expected;
+    for (size_t i = 0; i < tuples.size(); i++) {
+      auto val = pred->Evaluate(&tuples[i], schema);
+      if (!val.IsNull() && val.GetAs<bool>()) {
+        expected.push_back(i);
+      }
+    }
+    EXPECT_EQ(expected, selection);
+  }
+  SetSimdKernelsEnabled(true);
+}
+
+}  // namespace bustub
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "common/bustub_instance.h"
+#include "common/exception.h"
+#include "common/util/parallel_util.h"
+#include "common/util/string_util.h"
+#include "fmt/core.h"
+
+#include <sys/time.h>
+
+auto ClockMs() -> uint64_t {
+  struct timeval tm;
+  gettimeofday(&tm, nullptr);
+  return static_cast<uint64_t>(tm.tv_sec * 1000) + static_cast<uint64_t>(tm.tv_usec / 1000);
+}
+
+struct JoinQuery {
+  const char *name_;
+  const char *sql_;
+};
+
+// The p3.14 / p3.15 hash join workloads, on the 1M-row leaderboard tables. Every key appears twice in each table.
+const JoinQuery JOIN_QUERIES[] = {
+    {"inner-join-1m",
+     "SELECT count(*), max(a.y), min(b.y) FROM __mock_t4_1m a INNER JOIN __mock_t5_1m b ON a.x = b.x;"},
+    {"left-join-1m", "SELECT count(*), count(b.y) FROM __mock_t4_1m a LEFT JOIN __mock_t5_1m b ON a.x = b.x;"},
+    {"multi-way-join-1m",
+     "SELECT count(*), max(c.x) FROM __mock_t4_1m a INNER JOIN __mock_t5_1m b ON a.x = b.x "
+     "INNER JOIN __mock_t6_1m c ON b.y = c.y;"},
+};
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-join-bench");
+  program.add_argument("--threads").help("comma-separated thread counts to run every query with");
+  program.add_argument("--repeat").help("run every query n times and report the fastest run");
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  std::vector<size_t> thread_counts;
+  if (program.present("--threads")) {
+    for (const auto &threads : bustub::StringUtil::Split(program.get("--threads"), ',')) {
+      thread_counts.push_back(std::stoul(threads));
+    }
+  } else {
+    for (size_t threads = 1; threads < bustub::ParallelUtil::DefaultThreads(); threads *= 2) {
+      thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(bustub::ParallelUtil::DefaultThreads());
+  }
+  size_t repeat = 3;
+  if (program.present("--repeat")) {
+    repeat = std::stoul(program.get("--repeat"));
+  }
+
+  auto bustub = std::make_unique<bustub::BustubInstance>();
+  bustub->GenerateMockTable();
+  auto noop_writer = bustub::NoopWriter();
+
+  fmt::print("<<< BEGIN\n");
+  for (const auto &query : JOIN_QUERIES) {
+    std::string expected;
+    for (auto threads : thread_counts) {
+      bustub->ExecuteSql(fmt::format("set execution_threads={}", threads), noop_writer);
+      uint64_t best_ms = UINT64_MAX;
+      for (size_t i = 0; i < repeat; i++) {
+        std::stringstream ss;
+        auto writer = bustub::SimpleStreamWriter(ss, true);
+        auto start = ClockMs();
+        bustub->ExecuteSql(query.sql_, writer);
+        best_ms = std::min(best_ms, ClockMs() - start);
+        if (expected.empty()) {
+          expected = ss.str();
+        } else if (ss.str() != expected) {
+          fmt::print(stderr, "{}: result with {} threads differs: {} vs {}\n", query.name_, threads, ss.str(),
+                     expected);
+          return 1;
+        }
+      }
+      fmt::print("{}: threads={} time_ms={}\n", query.name_, threads, best_ms);
+    }
+  }
+  fmt::print(">>> END\n");
+
+  return 0;
+}
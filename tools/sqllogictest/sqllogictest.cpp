@@ -75,6 +75,12 @@ auto ProcessExtraOptions(const std::string &sql, bustub::BustubInstance &instanc
           fmt::print("IndexScan not found\n");
           return false;
         }
+      } else if (opt == "ensure:seq_scan") {
+        if (bustub::StringUtil::Contains(result.str(), "IndexScan") ||
+            !bustub::StringUtil::Contains(result.str(), "SeqScan")) {
+          fmt::print("SeqScan not found, or IndexScan found\n");
+          return false;
+        }
       } else if (opt == "ensure:hash_join") {
         if (bustub::StringUtil::Split(result.str(), "HashJoin").size() != 2 &&
             !bustub::StringUtil::Contains(result.str(), "Filter")) {
@@ -110,6 +116,27 @@ auto ProcessExtraOptions(const std::string &sql, bustub::BustubInstance &instanc
           fmt::print("NestedIndexJoin not found\n");
           return false;
         }
+      } else if (opt == "ensure:column_pruning") {
+        if (!bustub::StringUtil::Contains(result.str(), "column_ids=[")) {
+          fmt::print("no scan was narrowed to the columns it needs\n");
+          return false;
+        }
+      } else if (bustub::StringUtil::StartsWith(opt, "ensure:join_order:")) {
+        // the optimized plan reads the tables in this order, from its leftmost leaf to its rightmost one
+        auto order = opt.substr(std::string("ensure:join_order:").size());
+        auto plan = result.str().substr(result.str().find("=== OPTIMIZER ==="));
+        size_t pos = 0;
+        for (const auto &table : bustub::StringUtil::Split(order, ',')) {
+          auto needle = "table=" + table;
+          do {
+            pos = plan.find(needle, pos);
+            pos = pos == std::string::npos ? pos : pos + needle.size();
+          } while (pos != std::string::npos && pos < plan.size() && (isalnum(plan[pos]) != 0 || plan[pos] == '_'));
+          if (pos == std::string::npos) {
+            fmt::print("tables are not joined in the order {}\n", order);
+            return false;
+          }
+        }
       } else if (opt == "ensure:nlj_init_check") {
         if (!bustub::StringUtil::Contains(result.str(), "NestedLoopJoin")) {
           fmt::print("NestedLoopJoin not found\n");